@@ -0,0 +1,627 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Headless batch prediction.
+ *
+ * gpredict --predict loads a ground station and a set of satellites, either
+ * the .sat files of the user configuration or a TLE file, predicts the
+ * passes of every satellite in a time window and writes them as CSV or
+ * JSON. GTK is not initialised, so this works without a display.
+ *
+ * The satellites are predicted on a pool of worker threads, one task per
+ * satellite, and the results are written by the main thread in catalogue
+ * number order as soon as they are available.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch-predict.h"
+#include "compat.h"
+#include "gtk-sat-data.h"
+#include "predict-tools.h"
+#include "qth-data.h"
+#include "sat-cfg.h"
+#include "sat-log.h"
+#include "sgpsdp/sgp4sdp4.h"
+#include "time-tools.h"
+
+/* upper limit of the number of passes per day and satellite */
+#define BATCH_PASSES_PER_DAY 20
+
+/** \brief Prediction task for one satellite. */
+typedef struct {
+    sat_t          *sat;        /*!< The satellite, owned by the task */
+    GSList         *passes;     /*!< Resulting passes */
+    gboolean        done;       /*!< Set when passes is ready */
+} batch_task_t;
+
+/** \brief Data shared by all tasks. */
+typedef struct {
+    qth_t          *qth;        /*!< The ground station; read only */
+    gdouble         start;      /*!< Start of the prediction [jul_utc] */
+    gdouble         maxdt;      /*!< Length of the prediction [days] */
+    guint           num;        /*!< Maximum number of passes */
+    GMutex          lock;       /*!< Protects the done flag of the tasks */
+    GCond           cond;       /*!< Signalled when a task is done */
+} batch_ctx_t;
+
+/* command line options */
+static gboolean predict = FALSE;
+static gchar   *qthfile = NULL;
+static gchar   *satlist = NULL;
+static gchar   *tlefile = NULL;
+static gchar   *starttime = NULL;
+static gdouble  days = 0.0;
+static gchar   *format = NULL;
+static gchar   *outfile = NULL;
+static gint     threads = 0;
+
+static GOptionEntry entries[] = {
+    {"predict", 0, 0, G_OPTION_ARG_NONE, &predict,
+     "Predict passes without user interface and exit", NULL},
+    {"qth", 0, 0, G_OPTION_ARG_FILENAME, &qthfile,
+     "Ground station file (default: the default ground station)", "FILE"},
+    {"sats", 0, 0, G_OPTION_ARG_STRING, &satlist,
+     "Semicolon separated catalogue numbers (default: all satellites)",
+     "LIST"},
+    {"tle", 0, 0, G_OPTION_ARG_FILENAME, &tlefile,
+     "Read the satellites from a TLE file instead", "FILE"},
+    {"start", 0, 0, G_OPTION_ARG_STRING, &starttime,
+     "Start time in UTC (default: now)", "\"YYYY-MM-DD HH:MM:SS\""},
+    {"days", 0, 0, G_OPTION_ARG_DOUBLE, &days,
+     "Number of days to predict (default: the look-ahead setting)", "DAYS"},
+    {"format", 0, 0, G_OPTION_ARG_STRING, &format,
+     "Output format, csv or json (default: csv)", "FORMAT"},
+    {"output", 0, 0, G_OPTION_ARG_FILENAME, &outfile,
+     "Output file (default: standard output)", "FILE"},
+    {"threads", 0, 0, G_OPTION_ARG_INT, &threads,
+     "Number of threads (default: one per processor)", "N"},
+    {NULL}
+};
+
+
+/**
+ * \brief Check whether the batch mode has been requested.
+ *
+ * This is called before GTK is initialised, which would fail without a
+ * display, so the command line is checked without parsing it.
+ */
+gboolean batch_predict_requested(int argc, char *argv[])
+{
+    int             i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!g_strcmp0(argv[i], "--predict"))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * \brief Parse the start time.
+ * \param str Date and optional time in UTC, "YYYY-MM-DD HH:MM:SS".
+ * \param jd Location where the Julian Date is stored.
+ * \return TRUE if the time could be parsed.
+ */
+static gboolean parse_time(const gchar * str, gdouble * jd)
+{
+    struct tm       tim;
+    gint            n;
+
+    memset(&tim, 0, sizeof(tim));
+
+    /* Julian_Date expects the full year and month 1..12 */
+    n = sscanf(str, "%d%*[-/]%d%*[-/]%d%*[ T]%d:%d:%d", &tim.tm_year,
+               &tim.tm_mon, &tim.tm_mday, &tim.tm_hour, &tim.tm_min,
+               &tim.tm_sec);
+
+    if (n < 3 || tim.tm_mon < 1 || tim.tm_mon > 12 || tim.tm_mday < 1 ||
+        tim.tm_mday > 31)
+        return FALSE;
+
+    *jd = Julian_Date(&tim);
+
+    return TRUE;
+}
+
+/**
+ * \brief Format a time as ISO 8601 UTC.
+ * \param buff The output buffer.
+ * \param size The size of the buffer.
+ * \param jd The time (Julian Date).
+ */
+static void format_time(gchar * buff, gsize size, gdouble jd)
+{
+    GDateTime      *dt;
+    gchar          *str;
+
+    dt = g_date_time_new_from_unix_utc((gint64)
+                                       floor((jd - 2440587.5) * 86400.0 +
+                                             0.5));
+    str = g_date_time_format(dt, "%Y-%m-%dT%H:%M:%SZ");
+    g_strlcpy(buff, str, size);
+    g_free(str);
+    g_date_time_unref(dt);
+}
+
+/**
+ * \brief Load the ground station.
+ *
+ * A file name that does not exist is looked up in the user configuration
+ * directory, where the .qth files of gpredict are.
+ */
+static qth_t   *load_qth(const gchar * name)
+{
+    qth_t          *qth;
+    gchar          *confdir;
+    gchar          *path;
+
+    if (g_file_test(name, G_FILE_TEST_EXISTS) || g_path_is_absolute(name))
+    {
+        path = g_strdup(name);
+    }
+    else
+    {
+        confdir = get_user_conf_dir();
+        path = g_build_filename(confdir, name, NULL);
+        g_free(confdir);
+    }
+
+    qth = g_new0(qth_t, 1);
+    qth_init(qth);
+
+    if (!qth_data_read(path, qth))
+    {
+        g_printerr(_("Can not load ground station %s\n"), path);
+        qth_data_free(qth);
+        qth = NULL;
+    }
+
+    g_free(path);
+
+    return qth;
+}
+
+/** \brief Read a satellite from the user configuration. */
+static void add_catnum(GPtrArray * sats, gint catnum)
+{
+    sat_t          *sat = g_new0(sat_t, 1);
+
+    if (gtk_sat_data_read_sat(catnum, sat))
+    {
+        g_printerr(_("Can not load satellite %d\n"), catnum);
+        gtk_sat_data_free_sat(sat);
+        return;
+    }
+
+    g_ptr_array_add(sats, sat);
+}
+
+/**
+ * \brief Load the satellites from the user configuration.
+ * \param list Semicolon separated catalogue numbers or NULL for all.
+ */
+static void load_sats(GPtrArray * sats, const gchar * list)
+{
+    GDir           *dir;
+    const gchar    *name;
+    gchar          *path;
+    gchar         **catnums;
+    guint           i;
+
+    if (list != NULL)
+    {
+        catnums = g_strsplit_set(list, ";, ", 0);
+        for (i = 0; catnums[i] != NULL; i++)
+        {
+            if (catnums[i][0] != '\0')
+                add_catnum(sats, atoi(catnums[i]));
+        }
+        g_strfreev(catnums);
+
+        return;
+    }
+
+    path = get_satdata_dir();
+    dir = g_dir_open(path, 0, NULL);
+    g_free(path);
+
+    if (dir == NULL)
+        return;
+
+    while ((name = g_dir_read_name(dir)) != NULL)
+    {
+        if (g_str_has_suffix(name, ".sat"))
+            add_catnum(sats, atoi(name));
+    }
+
+    g_dir_close(dir);
+}
+
+/**
+ * \brief Load the satellites from a TLE file.
+ *
+ * The file has the usual three line format: name, line 1 and line 2.
+ */
+static void load_tle(GPtrArray * sats, const gchar * path)
+{
+    GError         *error = NULL;
+    gchar          *contents;
+    gchar         **lines;
+    gchar           tle[3][80];
+    sat_t          *sat;
+    guint           i, n;
+
+    if (!g_file_get_contents(path, &contents, NULL, &error))
+    {
+        g_printerr(_("Can not read %s (%s)\n"), path, error->message);
+        g_clear_error(&error);
+        return;
+    }
+
+    /* drop empty lines, including the ones between CR and LF */
+    lines = g_strsplit_set(contents, "\r\n", 0);
+    g_free(contents);
+    for (i = 0, n = 0; lines[i] != NULL; i++)
+    {
+        if (lines[i][0] != '\0')
+            lines[n++] = lines[i];
+        else
+            g_free(lines[i]);
+    }
+    lines[n] = NULL;
+
+    for (i = 0; lines[i] != NULL && lines[i + 1] != NULL &&
+         lines[i + 2] != NULL; i++)
+    {
+        if (lines[i + 1][0] != '1' || lines[i + 2][0] != '2')
+            continue;
+
+        g_strlcpy(tle[0], lines[i], sizeof(tle[0]));
+        g_strlcpy(tle[1], lines[i + 1], sizeof(tle[1]));
+        g_strlcpy(tle[2], lines[i + 2], sizeof(tle[2]));
+
+        sat = g_new0(sat_t, 1);
+        if (Get_Next_Tle_Set(tle, &sat->tle) != 1)
+        {
+            g_printerr(_("Invalid TLE for %s\n"), lines[i]);
+            g_free(sat);
+            continue;
+        }
+
+        sat->name = g_strdup(sat->tle.sat_name);
+        sat->nickname = g_strdup(sat->tle.sat_name);
+        sat->flags = 0;
+        select_ephemeris(sat);
+        gtk_sat_data_init_sat(sat, NULL);
+
+        g_ptr_array_add(sats, sat);
+        i += 2;
+    }
+
+    g_strfreev(lines);
+}
+
+static gint compare_catnum(gconstpointer a, gconstpointer b)
+{
+    const sat_t    *sa = *(sat_t * const *)a;
+    const sat_t    *sb = *(sat_t * const *)b;
+
+    return sa->tle.catnr - sb->tle.catnr;
+}
+
+/** \brief Worker thread function. */
+static void batch_predict_task(gpointer data, gpointer user_data)
+{
+    batch_task_t   *task = data;
+    batch_ctx_t    *ctx = user_data;
+    GSList         *passes;
+
+    passes = get_passes_summary(task->sat, ctx->qth, ctx->start, ctx->maxdt,
+                                ctx->num);
+
+    g_mutex_lock(&ctx->lock);
+    task->passes = passes;
+    task->done = TRUE;
+    g_cond_broadcast(&ctx->cond);
+    g_mutex_unlock(&ctx->lock);
+}
+
+/** \brief Write a string as a quoted CSV field. */
+static void write_csv_string(FILE * out, const gchar * str)
+{
+    fputc('"', out);
+    for (; *str != '\0'; str++)
+    {
+        if (*str == '"')
+            fputc('"', out);
+        fputc(*str, out);
+    }
+    fputc('"', out);
+}
+
+/** \brief Write a string as a JSON string. */
+static void write_json_string(FILE * out, const gchar * str)
+{
+    fputc('"', out);
+    for (; *str != '\0'; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            fprintf(out, "\\%c", *str);
+        else if ((guchar) * str < 0x20)
+            fprintf(out, "\\u%04x", (guchar) * str);
+        else
+            fputc(*str, out);
+    }
+    fputc('"', out);
+}
+
+/** \brief Write the passes of one satellite. */
+static void write_passes(FILE * out, gboolean json, sat_t * sat,
+                         GSList * passes, gboolean * first)
+{
+    pass_t         *pass;
+    gchar           aos[32], tca[32], los[32];
+
+    for (; passes != NULL; passes = passes->next)
+    {
+        pass = PASS(passes->data);
+        format_time(aos, sizeof(aos), pass->aos);
+        format_time(tca, sizeof(tca), pass->tca);
+        format_time(los, sizeof(los), pass->los);
+
+        if (json)
+        {
+            fprintf(out, "%s\n  {\"catnum\": %d, \"name\": ",
+                    *first ? "" : ",", sat->tle.catnr);
+            write_json_string(out, sat->nickname);
+            fprintf(out, ", \"aos\": \"%s\", \"tca\": \"%s\", "
+                    "\"los\": \"%s\", \"duration\": %.0f, "
+                    "\"max_el\": %.2f, \"aos_az\": %.2f, "
+                    "\"max_el_az\": %.2f, \"los_az\": %.2f, "
+                    "\"orbit\": %d, \"vis\": ",
+                    aos, tca, los, (pass->los - pass->aos) * 86400.0,
+                    pass->max_el, pass->aos_az, pass->maxel_az,
+                    pass->los_az, pass->orbit);
+            write_json_string(out, pass->vis);
+            fputc('}', out);
+        }
+        else
+        {
+            fprintf(out, "%d,", sat->tle.catnr);
+            write_csv_string(out, sat->nickname);
+            fprintf(out, ",%s,%s,%s,%.0f,%.2f,%.2f,%.2f,%.2f,%d,%s\n",
+                    aos, tca, los, (pass->los - pass->aos) * 86400.0,
+                    pass->max_el, pass->aos_az, pass->maxel_az,
+                    pass->los_az, pass->orbit, pass->vis);
+        }
+
+        *first = FALSE;
+    }
+}
+
+/**
+ * \brief Predict the passes of all satellites and write them.
+ * \return The exit code of the program.
+ */
+static int batch_predict(GPtrArray * sats, batch_ctx_t * ctx, FILE * out,
+                         gboolean json)
+{
+    GThreadPool    *pool;
+    GError         *error = NULL;
+    batch_task_t   *tasks;
+    gboolean        first = TRUE;
+    guint           i;
+
+    if (threads <= 0)
+    {
+#if GLIB_CHECK_VERSION(2, 36, 0)
+        threads = g_get_num_processors();
+#else
+        threads = 2;
+#endif
+    }
+
+    tasks = g_new0(batch_task_t, sats->len);
+    g_mutex_init(&ctx->lock);
+    g_cond_init(&ctx->cond);
+
+    pool = g_thread_pool_new(batch_predict_task, ctx, threads, TRUE, &error);
+    if (pool == NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Could not create threads (%s)"),
+                    __func__, error->message);
+        g_clear_error(&error);
+    }
+
+    for (i = 0; i < sats->len; i++)
+    {
+        tasks[i].sat = g_ptr_array_index(sats, i);
+
+        /* without threads the tasks are run while writing */
+        if (pool != NULL && !g_thread_pool_push(pool, &tasks[i], &error))
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Could not start prediction for %s (%s)"),
+                        __func__, tasks[i].sat->nickname, error->message);
+            g_clear_error(&error);
+            batch_predict_task(&tasks[i], ctx);
+        }
+    }
+
+    if (json)
+        fputs("[", out);
+    else
+        fputs("catnum,name,aos,tca,los,duration,max_el,aos_az,max_el_az,"
+              "los_az,orbit,vis\n", out);
+
+    for (i = 0; i < sats->len; i++)
+    {
+        if (pool == NULL)
+            batch_predict_task(&tasks[i], ctx);
+
+        g_mutex_lock(&ctx->lock);
+        while (!tasks[i].done)
+            g_cond_wait(&ctx->cond, &ctx->lock);
+        g_mutex_unlock(&ctx->lock);
+
+        write_passes(out, json, tasks[i].sat, tasks[i].passes, &first);
+        free_passes(tasks[i].passes);
+        tasks[i].passes = NULL;
+    }
+
+    if (json)
+        fputs("\n]\n", out);
+
+    if (pool != NULL)
+        g_thread_pool_free(pool, FALSE, TRUE);
+
+    g_mutex_clear(&ctx->lock);
+    g_cond_clear(&ctx->cond);
+    g_free(tasks);
+
+    return 0;
+}
+
+/**
+ * \brief Run the batch prediction.
+ * \return The exit code of the program.
+ *
+ * This is used instead of the user interface when batch_predict_requested
+ * returns TRUE.
+ */
+int batch_predict_run(int argc, char *argv[])
+{
+    GOptionContext *context;
+    GError         *error = NULL;
+    GPtrArray      *sats;
+    batch_ctx_t     ctx;
+    FILE           *out = stdout;
+    gboolean        json = FALSE;
+    gchar          *name;
+    int             ret = 1;
+
+    context = g_option_context_new("");
+    g_option_context_add_main_entries(context, entries, GETTEXT_PACKAGE);
+    g_option_context_set_summary(context,
+                                 _("Predict the passes of a set of satellites "
+                                   "over a ground station and write them as "
+                                   "CSV or JSON."));
+    if (!g_option_context_parse(context, &argc, &argv, &error))
+    {
+        g_printerr(_("Option parsing failed: %s\n"), error->message);
+        g_clear_error(&error);
+        g_option_context_free(context);
+
+        return 1;
+    }
+    g_option_context_free(context);
+
+    if (format != NULL && !g_ascii_strcasecmp(format, "json"))
+    {
+        json = TRUE;
+    }
+    else if (format != NULL && g_ascii_strcasecmp(format, "csv"))
+    {
+        g_printerr(_("Unknown output format %s\n"), format);
+
+        return 1;
+    }
+
+    sat_log_init();
+    sat_cfg_load();
+    sat_log_set_level(sat_cfg_get_int(SAT_CFG_INT_LOG_LEVEL));
+
+    memset(&ctx, 0, sizeof(ctx));
+    sats = g_ptr_array_new_with_free_func((GDestroyNotify)
+                                          gtk_sat_data_free_sat);
+
+    /* ground station */
+    name = (qthfile != NULL) ? g_strdup(qthfile) :
+        sat_cfg_get_str(SAT_CFG_STR_DEF_QTH);
+    ctx.qth = load_qth(name);
+    g_free(name);
+    if (ctx.qth == NULL)
+        goto done;
+
+    /* time window */
+    ctx.start = get_current_daynum();
+    if (starttime != NULL && !parse_time(starttime, &ctx.start))
+    {
+        g_printerr(_("Invalid start time %s\n"), starttime);
+        goto done;
+    }
+
+    ctx.maxdt = (days > 0.0) ? days :
+        sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD);
+    ctx.num = (guint) ceil(ctx.maxdt * BATCH_PASSES_PER_DAY) + 1;
+
+    /* satellites */
+    if (tlefile != NULL)
+        load_tle(sats, tlefile);
+    else
+        load_sats(sats, satlist);
+
+    g_ptr_array_sort(sats, compare_catnum);
+
+    if (outfile != NULL)
+    {
+        out = g_fopen(outfile, "w");
+        if (out == NULL)
+        {
+            g_printerr(_("Can not open %s for writing\n"), outfile);
+            goto done;
+        }
+    }
+
+    ret = batch_predict(sats, &ctx, out, json);
+
+    if (out != stdout)
+        fclose(out);
+
+  done:
+    g_ptr_array_free(sats, TRUE);
+    if (ctx.qth != NULL)
+        qth_data_free(ctx.qth);
+
+    sat_log_close();
+    sat_cfg_close();
+
+    return ret;
+}
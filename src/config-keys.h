@@ -66,6 +66,7 @@
 /* global */
 #define MOD_CFG_GLOBAL_SECTION  "GLOBAL"
 #define MOD_CFG_QTH_FILE_KEY    "QTHFILE"
+#define MOD_CFG_NETWORK_KEY     "NETWORK"     /* Extra ground stations */
 #define MOD_CFG_SATS_KEY        "SATELLITES"
 #define MOD_CFG_TIMEOUT_KEY     "TIMEOUT"
 #define MOD_CFG_WARP_KEY        "WARP"
@@ -0,0 +1,260 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "ephem-cache.h"
+#include "sat-log.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/**
+ * \brief Propagate a working copy of a satellite.
+ * \param work The working copy.
+ * \param t The time (Julian Date).
+ * \param val Array of EPHEM_CACHE_NUM elements receiving the result.
+ */
+static void propagate(sat_t * work, gdouble t, gdouble * val)
+{
+    gdouble         tsince = (t - work->jul_epoch) * xmnpda;
+
+    if (work->flags & DEEP_SPACE_EPHEM_FLAG)
+        SDP4(work, tsince);
+    else
+        SGP4(work, tsince);
+
+    Convert_Sat_State(&work->pos, &work->vel);
+
+    val[EPHEM_CACHE_POS_X] = work->pos.x;
+    val[EPHEM_CACHE_POS_Y] = work->pos.y;
+    val[EPHEM_CACHE_POS_Z] = work->pos.z;
+    val[EPHEM_CACHE_VEL_X] = work->vel.x;
+    val[EPHEM_CACHE_VEL_Y] = work->vel.y;
+    val[EPHEM_CACHE_VEL_Z] = work->vel.z;
+    val[EPHEM_CACHE_PHASE] = work->phase;
+}
+
+/**
+ * \brief Evaluate a Chebyshev series using Clenshaw's recurrence.
+ * \param c The coefficients.
+ * \param x The normalised time in [-1;1].
+ */
+static gdouble chebyshev(const gdouble * c, gdouble x)
+{
+    gdouble         b1 = 0.0, b2 = 0.0, tmp;
+    gint            j;
+
+    for (j = EPHEM_CACHE_ORDER - 1; j > 0; j--)
+    {
+        tmp = 2.0 * x * b1 - b2 + c[j];
+        b2 = b1;
+        b1 = tmp;
+    }
+
+    return x * b1 - b2 + 0.5 * c[0];
+}
+
+/**
+ * \brief Evaluate all fitted quantities at normalised time x.
+ */
+static void eval_segment(const ephem_cache_t * cache, gdouble x,
+                         gdouble * val)
+{
+    gint            i;
+
+    for (i = 0; i < EPHEM_CACHE_NUM; i++)
+        val[i] = chebyshev(cache->coef[i], x);
+}
+
+/**
+ * \brief Fit a new segment.
+ * \param cache The ephemeris cache.
+ * \param sat The satellite.
+ * \param t0 Start of the segment (Julian Date).
+ * \param t1 End of the segment (Julian Date).
+ *
+ * The quantities are sampled at the Chebyshev nodes and the coefficients
+ * are obtained by the discrete cosine transform. The fit is then checked
+ * against direct propagation at three points that are not fitting nodes.
+ *
+ * All samples are propagated on one working copy of sat. Only the deep
+ * space integrator state is copied back, so that the next fit can resume
+ * the resonance integration instead of restarting it at epoch.
+ */
+static void fit_segment(ephem_cache_t * cache, sat_t * sat,
+                        gdouble t0, gdouble t1)
+{
+    sat_t           work = *sat;
+    gdouble         samp[EPHEM_CACHE_ORDER][EPHEM_CACHE_NUM];
+    gdouble         fit[EPHEM_CACHE_NUM];
+    gdouble         ref[EPHEM_CACHE_NUM];
+    gdouble         mid = 0.5 * (t0 + t1);
+    gdouble         half = 0.5 * (t1 - t0);
+    gdouble         sum, dx, dy, dz;
+    gdouble         x;
+    gint            i, j, k;
+
+    for (k = 0; k < EPHEM_CACHE_ORDER; k++)
+    {
+        x = cos(pi * (k + 0.5) / EPHEM_CACHE_ORDER);
+        propagate(&work, mid + half * x, samp[k]);
+
+        /* unwrap the phase so that it can be fitted */
+        if (k > 0)
+        {
+            while (samp[k][EPHEM_CACHE_PHASE] - samp[k - 1][EPHEM_CACHE_PHASE] > pi)
+                samp[k][EPHEM_CACHE_PHASE] -= twopi;
+            while (samp[k][EPHEM_CACHE_PHASE] - samp[k - 1][EPHEM_CACHE_PHASE] < -pi)
+                samp[k][EPHEM_CACHE_PHASE] += twopi;
+        }
+    }
+
+    for (i = 0; i < EPHEM_CACHE_NUM; i++)
+    {
+        for (j = 0; j < EPHEM_CACHE_ORDER; j++)
+        {
+            sum = 0.0;
+            for (k = 0; k < EPHEM_CACHE_ORDER; k++)
+                sum += samp[k][i] * cos(pi * j * (k + 0.5) / EPHEM_CACHE_ORDER);
+
+            cache->coef[i][j] = 2.0 * sum / EPHEM_CACHE_ORDER;
+        }
+    }
+
+    cache->t0 = t0;
+    cache->t1 = t1;
+    cache->valid = TRUE;
+
+    /* verify */
+    for (x = -0.5; x <= 0.5; x += 0.5)
+    {
+        eval_segment(cache, x, fit);
+        propagate(&work, mid + half * x, ref);
+
+        dx = fit[EPHEM_CACHE_POS_X] - ref[EPHEM_CACHE_POS_X];
+        dy = fit[EPHEM_CACHE_POS_Y] - ref[EPHEM_CACHE_POS_Y];
+        dz = fit[EPHEM_CACHE_POS_Z] - ref[EPHEM_CACHE_POS_Z];
+
+        if (sqrt(dx * dx + dy * dy + dz * dz) > cache->tol)
+        {
+            sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                        _("%s: Fit for %d rejected (%.3f km off)"),
+                        __func__, sat->tle.catnr,
+                        sqrt(dx * dx + dy * dy + dz * dz));
+            cache->valid = FALSE;
+            break;
+        }
+    }
+
+    sat->deep_state = work.deep_state;
+}
+
+/**
+ * \brief Create a new ephemeris cache.
+ * \param span The segment length in days.
+ * \param tol The position tolerance in km.
+ * \return A newly allocated cache that must be freed with ephem_cache_free.
+ */
+ephem_cache_t  *ephem_cache_new(gdouble span, gdouble tol)
+{
+    ephem_cache_t  *cache = g_new0(ephem_cache_t, 1);
+
+    cache->span = span;
+    cache->tol = tol;
+    ephem_cache_reset(cache);
+
+    return cache;
+}
+
+/** \brief Free an ephemeris cache. */
+void ephem_cache_free(ephem_cache_t * cache)
+{
+    g_free(cache);
+}
+
+/**
+ * \brief Invalidate the fitted segment.
+ *
+ * Must be called if the orbital elements of the satellite change.
+ */
+void ephem_cache_reset(ephem_cache_t * cache)
+{
+    cache->t0 = 0.0;
+    cache->t1 = -1.0;
+    cache->valid = FALSE;
+}
+
+/**
+ * \brief Evaluate the position of a satellite from the cache.
+ * \param cache The ephemeris cache of the satellite.
+ * \param sat The satellite.
+ * \param t The time (Julian Date).
+ * \return TRUE if sat has been updated, FALSE if the fit for t did not
+ *         meet the tolerance and the caller must propagate directly.
+ *
+ * On success sat->jul_utc, sat->tsince, sat->pos, sat->vel (km and km/s)
+ * and sat->phase are updated like after SGP4/SDP4 and Convert_Sat_State.
+ * The segment is refitted lazily when t falls outside of it. The new
+ * segment ends at t when moving backwards in time and starts at t
+ * otherwise, so that it lasts as long as possible.
+ */
+gboolean ephem_cache_eval(ephem_cache_t * cache, sat_t * sat, gdouble t)
+{
+    gdouble         val[EPHEM_CACHE_NUM];
+
+    if (t < cache->t0 || t > cache->t1)
+    {
+        if (cache->t1 >= cache->t0 && t < cache->t0)
+            fit_segment(cache, sat, t - cache->span, t);
+        else
+            fit_segment(cache, sat, t, t + cache->span);
+    }
+
+    if (!cache->valid)
+        return FALSE;
+
+    eval_segment(cache, (2.0 * t - cache->t0 - cache->t1) /
+                 (cache->t1 - cache->t0), val);
+
+    sat->jul_utc = t;
+    sat->tsince = (t - sat->jul_epoch) * xmnpda;
+    sat->pos.x = val[EPHEM_CACHE_POS_X];
+    sat->pos.y = val[EPHEM_CACHE_POS_Y];
+    sat->pos.z = val[EPHEM_CACHE_POS_Z];
+    sat->vel.x = val[EPHEM_CACHE_VEL_X];
+    sat->vel.y = val[EPHEM_CACHE_VEL_Y];
+    sat->vel.z = val[EPHEM_CACHE_VEL_Z];
+    sat->phase = FMod2p(val[EPHEM_CACHE_PHASE]);
+    Magnitude(&sat->pos);
+    Magnitude(&sat->vel);
+
+    return TRUE;
+}
@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef EPHEM_CACHE_H
+#define EPHEM_CACHE_H 1
+
+#include <glib.h>
+#include "sgpsdp/sgp4sdp4.h"
+
+/** \brief Number of Chebyshev coefficients per fitted quantity. */
+#define EPHEM_CACHE_ORDER 12
+
+/** \brief Quantities fitted in each segment. */
+enum {
+    EPHEM_CACHE_POS_X = 0,
+    EPHEM_CACHE_POS_Y,
+    EPHEM_CACHE_POS_Z,
+    EPHEM_CACHE_VEL_X,
+    EPHEM_CACHE_VEL_Y,
+    EPHEM_CACHE_VEL_Z,
+    EPHEM_CACHE_PHASE,
+    EPHEM_CACHE_NUM
+};
+
+/**
+ * \brief Chebyshev ephemeris cache for one satellite.
+ *
+ * The cache holds a single segment of Chebyshev polynomials fitted to the
+ * SGP4/SDP4 output. A new segment is fitted when the requested time leaves
+ * the current one. Every fit is verified against direct propagation at
+ * points between the fitting nodes; if the deviation exceeds the tolerance
+ * the segment is rejected and the caller has to propagate directly.
+ */
+typedef struct {
+    gdouble         span;       /*!< Segment length [days] */
+    gdouble         tol;        /*!< Position tolerance [km] */
+    gdouble         t0;         /*!< Start of current segment [jul_utc] */
+    gdouble         t1;         /*!< End of current segment [jul_utc] */
+    gboolean        valid;      /*!< Whether the current segment passed verification */
+    gdouble         coef[EPHEM_CACHE_NUM][EPHEM_CACHE_ORDER];
+} ephem_cache_t;
+
+ephem_cache_t  *ephem_cache_new(gdouble span, gdouble tol);
+void            ephem_cache_free(ephem_cache_t * cache);
+void            ephem_cache_reset(ephem_cache_t * cache);
+gboolean        ephem_cache_eval(ephem_cache_t * cache, sat_t * sat, gdouble t);
+
+#endif
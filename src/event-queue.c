@@ -0,0 +1,235 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Binary min-heap of objects keyed by the time of their next event.
+ *
+ * A hash table maps each object to its position in the heap, so that the
+ * time of an object can be changed and the object removed without searching.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+
+#include "event-queue.h"
+
+
+/** \brief An entry in the heap. */
+typedef struct {
+    gdouble         t;          /*!< Time of the event */
+    gpointer        data;       /*!< The object */
+} event_t;
+
+struct _event_queue {
+    GArray         *heap;       /*!< The heap of event_t */
+    GHashTable     *index;      /*!< Position in the heap + 1 by object */
+};
+
+#define EVENT(queue, i) (&g_array_index((queue)->heap, event_t, (i)))
+
+
+/** \brief Store an entry at a given position and update the index. */
+static void put(event_queue_t * queue, guint i, const event_t * event)
+{
+    *EVENT(queue, i) = *event;
+    g_hash_table_insert(queue->index, event->data, GUINT_TO_POINTER(i + 1));
+}
+
+/** \brief Move the entry at position i up; returns its new position. */
+static guint sift_up(event_queue_t * queue, guint i)
+{
+    event_t         event = *EVENT(queue, i);
+    guint           parent;
+
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (EVENT(queue, parent)->t <= event.t)
+            break;
+
+        put(queue, i, EVENT(queue, parent));
+        i = parent;
+    }
+
+    put(queue, i, &event);
+
+    return i;
+}
+
+/** \brief Move the entry at position i down. */
+static void sift_down(event_queue_t * queue, guint i)
+{
+    event_t         event = *EVENT(queue, i);
+    guint           n = queue->heap->len;
+    guint           child;
+
+    for (;;)
+    {
+        child = 2 * i + 1;
+        if (child >= n)
+            break;
+
+        if (child + 1 < n &&
+            EVENT(queue, child + 1)->t < EVENT(queue, child)->t)
+            child++;
+
+        if (event.t <= EVENT(queue, child)->t)
+            break;
+
+        put(queue, i, EVENT(queue, child));
+        i = child;
+    }
+
+    put(queue, i, &event);
+}
+
+/** \brief Remove the entry at position i. */
+static void remove_at(event_queue_t * queue, guint i)
+{
+    guint           last = queue->heap->len - 1;
+
+    g_hash_table_remove(queue->index, EVENT(queue, i)->data);
+
+    if (i != last)
+    {
+        *EVENT(queue, i) = *EVENT(queue, last);
+        g_array_set_size(queue->heap, last);
+
+        /* the last entry may belong above or below position i */
+        sift_down(queue, sift_up(queue, i));
+    }
+    else
+    {
+        g_array_set_size(queue->heap, last);
+    }
+}
+
+/** \brief Create an empty event queue. */
+event_queue_t  *event_queue_new(void)
+{
+    event_queue_t  *queue = g_new0(event_queue_t, 1);
+
+    queue->heap = g_array_new(FALSE, FALSE, sizeof(event_t));
+    queue->index = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    return queue;
+}
+
+/** \brief Free an event queue; the objects are not freed. */
+void event_queue_free(event_queue_t * queue)
+{
+    if (queue == NULL)
+        return;
+
+    g_array_free(queue->heap, TRUE);
+    g_hash_table_destroy(queue->index);
+    g_free(queue);
+}
+
+/** \brief Remove all objects from the queue. */
+void event_queue_clear(event_queue_t * queue)
+{
+    g_array_set_size(queue->heap, 0);
+    g_hash_table_remove_all(queue->index);
+}
+
+/**
+ * \brief Queue an object or change the time of its next event.
+ * \param queue The queue.
+ * \param data The object.
+ * \param t The time of the next event.
+ */
+void event_queue_set(event_queue_t * queue, gpointer data, gdouble t)
+{
+    event_t         event;
+    guint           pos;
+
+    pos = GPOINTER_TO_UINT(g_hash_table_lookup(queue->index, data));
+    if (pos > 0)
+    {
+        EVENT(queue, pos - 1)->t = t;
+        sift_down(queue, sift_up(queue, pos - 1));
+    }
+    else
+    {
+        event.t = t;
+        event.data = data;
+        g_array_append_val(queue->heap, event);
+        sift_up(queue, queue->heap->len - 1);
+    }
+}
+
+/** \brief Remove an object from the queue if it is queued. */
+void event_queue_remove(event_queue_t * queue, gpointer data)
+{
+    guint           pos;
+
+    pos = GPOINTER_TO_UINT(g_hash_table_lookup(queue->index, data));
+    if (pos > 0)
+        remove_at(queue, pos - 1);
+}
+
+/**
+ * \brief Get the object with the earliest event.
+ * \param queue The queue.
+ * \param t Location for the time of the event, or NULL.
+ * \return The object or NULL if the queue is empty.
+ */
+gpointer event_queue_peek(event_queue_t * queue, gdouble * t)
+{
+    if (queue->heap->len == 0)
+        return NULL;
+
+    if (t != NULL)
+        *t = EVENT(queue, 0)->t;
+
+    return EVENT(queue, 0)->data;
+}
+
+/**
+ * \brief Remove and return the object with the earliest event.
+ * \param queue The queue.
+ * \param t Location for the time of the event, or NULL.
+ * \return The object or NULL if the queue is empty.
+ */
+gpointer event_queue_pop(event_queue_t * queue, gdouble * t)
+{
+    gpointer        data;
+
+    data = event_queue_peek(queue, t);
+    if (data != NULL)
+        remove_at(queue, 0);
+
+    return data;
+}
+
+/** \brief Get the number of queued objects. */
+guint event_queue_size(event_queue_t * queue)
+{
+    return queue->heap->len;
+}
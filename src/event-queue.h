@@ -0,0 +1,51 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H 1
+
+#include <glib.h>
+
+/**
+ * \brief Queue of objects ordered by the time of their next event; opaque.
+ *
+ * Each object is in the queue at most once. Setting the time of an object
+ * that is already queued moves it.
+ */
+typedef struct _event_queue event_queue_t;
+
+event_queue_t  *event_queue_new(void);
+void            event_queue_free(event_queue_t * queue);
+void            event_queue_clear(event_queue_t * queue);
+void            event_queue_set(event_queue_t * queue, gpointer data,
+                                gdouble t);
+void            event_queue_remove(event_queue_t * queue, gpointer data);
+gpointer        event_queue_peek(event_queue_t * queue, gdouble * t);
+gpointer        event_queue_pop(event_queue_t * queue, gdouble * t);
+guint           event_queue_size(event_queue_t * queue);
+
+#endif
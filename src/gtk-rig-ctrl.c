@@ -319,13 +319,14 @@ void gtk_rig_ctrl_update(GtkRigCtrl * ctrl, gdouble t)
             if (ctrl->target->aos > ctrl->pass->aos)
             {
                 free_pass(ctrl->pass);
-                ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+                ctrl->pass = get_next_pass_summary(ctrl->target, ctrl->qth,
+                                                   3.0);
             }
         }
         else
         {
             /* we don't have any current pass; store the current one */
-            ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+            ctrl->pass = get_next_pass_summary(ctrl->target, ctrl->qth, 3.0);
         }
     }
 
@@ -663,7 +664,7 @@ static void sat_selected_cb(GtkComboBox * satsel, gpointer data)
         /* update next pass */
         if (ctrl->pass != NULL)
             free_pass(ctrl->pass);
-        ctrl->pass = get_next_pass(ctrl->target, ctrl->qth, 3.0);
+        ctrl->pass = get_next_pass_summary(ctrl->target, ctrl->qth, 3.0);
 
         /* read transponders for new target */
         load_trsp_list(ctrl);
@@ -2936,8 +2937,8 @@ GtkWidget      *gtk_rig_ctrl_new(GtkSatModule * module)
     if (rigctrl->target != NULL)
     {
         /* get next pass for target satellite */
-        GTK_RIG_CTRL(widget)->pass = get_next_pass(rigctrl->target,
-                                                   rigctrl->qth, 3.0);
+        GTK_RIG_CTRL(widget)->pass = get_next_pass_summary(rigctrl->target,
+                                                           rigctrl->qth, 3.0);
     }
 
     /* create contents */
@@ -214,7 +214,7 @@ static gboolean is_flipped_pass(pass_t * pass, rot_az_type_t type,
     pass_detail_t  *detail;
     gboolean        retval = FALSE;
 
-    num = g_slist_length(pass->details);
+    num = pass->num_details;
     if (type == ROT_AZ_TYPE_360)
     {
         min_az = 0;
@@ -248,7 +248,7 @@ static gboolean is_flipped_pass(pass_t * pass, rot_az_type_t type,
     {
         for (i = 1; i < num - 1; i++)
         {
-            detail = PASS_DETAIL(g_slist_nth_data(pass->details, i));
+            detail = &pass->details[i];
             caz = detail->az;
 
             while (caz > max_az)
@@ -858,7 +858,8 @@ static gboolean rot_ctrl_timeout_cb(gpointer data)
                        within tolerance so and send the rotor there.
                      */
 
-                    /* use a working copy so data does not get corrupted */
+                    /* use a working copy so data does not get corrupted;
+                       it shares the propagation constants with the target */
                     sat = memcpy(&(sat_working), ctrl->target, sizeof(sat_t));
 
                     /* compute az/el in the future that is past end of pass 
@@ -60,6 +60,10 @@ gint gtk_sat_data_read_sat(gint catnum, sat_t * sat)
     /* ensure that sat != NULL */
     g_return_val_if_fail(sat != NULL, 1);
 
+    /* allocated by select_ephemeris */
+    sat->sgps = NULL;
+    sat->dps = NULL;
+
     /* .sat file names */
     filename = g_strdup_printf("%d.sat", catnum);
     path = sat_file_name_from_catnum(catnum);
@@ -362,5 +366,7 @@ void gtk_sat_data_free_sat(sat_t * sat)
         sat->website = NULL;
     }
 
+    free_ephemeris(sat);
+
     g_free(sat);
 }
@@ -41,6 +41,7 @@
 #include "sat-cfg.h"
 #include "sat-info.h"
 #include "sat-log.h"
+#include "sat-snapshot.h"
 #include "sat-vis.h"
 #include "sgpsdp/sgp4sdp4.h"
 #include "time-tools.h"
@@ -213,8 +214,6 @@ static void     row_activated_cb(GtkTreeView * tree_view, GtkTreePath * path,
 
 static void     view_popup_menu(GtkWidget * treeview, GdkEventButton * event,
                                 gpointer list);
-static void     Calculate_RADec(sat_t * sat, qth_t * qth,
-                                obs_astro_t * obs_set);
 
 static GtkVBoxClass *parent_class = NULL;
 
@@ -565,6 +564,8 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
     GtkSatList     *satlist = GTK_SAT_LIST(data);
     guint          *catnum;
     sat_t          *sat;
+    const sat_snap_t *snap;
+    sat_snap_t      local;
     gchar          *buff;
     gdouble         doppler;
     gdouble         delay;
@@ -595,30 +596,39 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
     }
     else
     {
+        /* the snapshot of this cycle; the satellite itself is only read for
+           data that does not change with time */
+        snap = sat_snap_lookup(satlist->snaps, *catnum);
+        if (snap == NULL)
+        {
+            sat_snap_take(&local, sat, satlist->qth);
+            snap = &local;
+        }
+
         /* store new data */
         gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                           SAT_LIST_COL_AZ, sat->az,
-                           SAT_LIST_COL_EL, sat->el,
-                           SAT_LIST_COL_RANGE, sat->range,
-                           SAT_LIST_COL_RANGE_RATE, sat->range_rate,
-                           SAT_LIST_COL_LAT, sat->ssplat,
-                           SAT_LIST_COL_LON, sat->ssplon,
-                           SAT_LIST_COL_FOOTPRINT, sat->footprint,
-                           SAT_LIST_COL_ALT, sat->alt,
-                           SAT_LIST_COL_VEL, sat->velo,
-                           SAT_LIST_COL_MA, sat->ma,
-                           SAT_LIST_COL_PHASE, sat->phase,
-                           SAT_LIST_COL_ORBIT, sat->orbit,
+                           SAT_LIST_COL_AZ, snap->az,
+                           SAT_LIST_COL_EL, snap->el,
+                           SAT_LIST_COL_RANGE, snap->range,
+                           SAT_LIST_COL_RANGE_RATE, snap->range_rate,
+                           SAT_LIST_COL_LAT, snap->ssplat,
+                           SAT_LIST_COL_LON, snap->ssplon,
+                           SAT_LIST_COL_FOOTPRINT, snap->footprint,
+                           SAT_LIST_COL_ALT, snap->alt,
+                           SAT_LIST_COL_VEL, snap->velo,
+                           SAT_LIST_COL_MA, snap->ma,
+                           SAT_LIST_COL_PHASE, snap->phase,
+                           SAT_LIST_COL_ORBIT, snap->orbit,
                            SAT_LIST_COL_DECAY, !decayed(sat),
                            SAT_LIST_COL_BOLD,
-                           (sat->el >
+                           (snap->el >
                             0.0) ? PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL,
                            -1);
 
         /* doppler shift @ 100 MHz */
         if (satlist->flags & SAT_LIST_FLAG_DOPPLER)
         {
-            doppler = -100.0e06 * (sat->range_rate / 299792.4580);      // Hz
+            doppler = -100.0e06 * (snap->range_rate / 299792.4580);     // Hz
             gtk_list_store_set(GTK_LIST_STORE(model), iter,
                                SAT_LIST_COL_DOPPLER, doppler, -1);
         }
@@ -626,7 +636,7 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
         /* delay */
         if (satlist->flags & SAT_LIST_FLAG_DELAY)
         {
-            delay = sat->range / 299.7924580;   // msec 
+            delay = snap->range / 299.7924580;  // msec 
             gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_DELAY,
                                delay, -1);
         }
@@ -634,7 +644,7 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
         /* path loss */
         if (satlist->flags & SAT_LIST_FLAG_LOSS)
         {
-            loss = 72.4 + 20.0 * log10(sat->range);     // dB
+            loss = 72.4 + 20.0 * log10(snap->range);    // dB
             gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_LOSS,
                                loss, -1);
         }
@@ -650,17 +660,17 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
             {
                 buff = g_strdup("D");
             }
-            else if (sat->range_rate > 0.001)
+            else if (snap->range_rate > 0.001)
             {
                 /* going down */
                 buff = g_strdup("\342\206\223");
             }
-            else if ((sat->range_rate <= 0.001) && (sat->range_rate >= -0.001))
+            else if ((snap->range_rate <= 0.001) && (snap->range_rate >= -0.001))
             {
                 gtk_tree_model_get(model, iter, SAT_LIST_COL_RANGE_RATE,
                                    &oldrate, -1);
                 /* turning around; don't know which way ? */
-                if (sat->range_rate < oldrate)
+                if (snap->range_rate < oldrate)
                 {
                     /* starting to approach */
                     buff = g_strdup("\342\206\272");
@@ -671,7 +681,7 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
                     buff = g_strdup("\342\206\267");
                 }
             }
-            else if (sat->range_rate < -0.001)
+            else if (snap->range_rate < -0.001)
             {
                 /* coming up */
                 buff = g_strdup("\342\206\221");
@@ -695,7 +705,7 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
 
             buff = g_try_malloc(7);
 
-            retcode = longlat2locator(sat->ssplon, sat->ssplat, buff, 3);
+            retcode = longlat2locator(snap->ssplon, snap->ssplat, buff, 3);
             if (retcode == RIG_OK)
             {
                 buff[6] = '\0';
@@ -708,16 +718,9 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
         /* Ra and Dec */
         if (satlist->flags & (SAT_LIST_FLAG_RA | SAT_LIST_FLAG_DEC))
         {
-            obs_astro_t     astro;
-
-            Calculate_RADec(sat, satlist->qth, &astro);
-
-            sat->ra = Degrees(astro.ra);
-            sat->dec = Degrees(astro.dec);
-
             gtk_list_store_set(GTK_LIST_STORE(model), iter,
-                               SAT_LIST_COL_RA, sat->ra, SAT_LIST_COL_DEC,
-                               sat->dec, -1);
+                               SAT_LIST_COL_RA, snap->ra, SAT_LIST_COL_DEC,
+                               snap->dec, -1);
         }
 
         /* upcoming events */
@@ -725,12 +728,12 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
         if (satlist->flags & SAT_LIST_FLAG_AOS)
         {
             gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_AOS,
-                               sat->aos, -1);
+                               snap->aos, -1);
         }
         if (satlist->flags & SAT_LIST_FLAG_LOS)
         {
             gtk_list_store_set(GTK_LIST_STORE(model), iter, SAT_LIST_COL_LOS,
-                               sat->los, -1);
+                               snap->los, -1);
 
         }
         if (satlist->flags & SAT_LIST_FLAG_NEXT_EVENT)
@@ -742,16 +745,16 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
             gchar          *alstr;
 
 
-            if (sat->aos > sat->los)
+            if (snap->aos > snap->los)
             {
                 /* next event is LOS */
-                number = sat->los;
+                number = snap->los;
                 alstr = g_strdup("LOS: ");
             }
             else
             {
                 /* next event is AOS */
-                number = sat->aos;
+                number = snap->aos;
                 alstr = g_strdup("AOS: ");
             }
 
@@ -782,10 +785,7 @@ static gboolean sat_list_update_sats(GtkTreeModel * model, GtkTreePath * path,
 
         if (satlist->flags & SAT_LIST_FLAG_VISIBILITY)
         {
-            sat_vis_t       vis;
-
-            vis = get_sat_vis(sat, satlist->qth, sat->jul_utc);
-            buff = g_strdup_printf("%c", vis_to_chr(vis));
+            buff = g_strdup_printf("%c", vis_to_chr(snap->vis));
             gtk_list_store_set(GTK_LIST_STORE(model), iter,
                                SAT_LIST_COL_VISIBILITY, buff, -1);
             g_free(buff);
@@ -1353,53 +1353,6 @@ static void view_popup_menu(GtkWidget * treeview, GdkEventButton * event,
     g_free(catnum);
 }
 
-/*** FIXME: formalise with other copies, only need az,el and jul_utc */
-static void Calculate_RADec(sat_t * sat, qth_t * qth, obs_astro_t * obs_set)
-{
-    /* Reference:  Methods of Orbit Determination by  */
-    /*                Pedro Ramon Escobal, pp. 401-402 */
-
-    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
-        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
-        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
-    geodetic_t      geodetic;
-
-    geodetic.lon = qth->lon * de2ra;
-    geodetic.lat = qth->lat * de2ra;
-    geodetic.alt = qth->alt / 1000.0;
-    geodetic.theta = 0;
-
-    az = sat->az * de2ra;
-    el = sat->el * de2ra;
-    phi = geodetic.lat;
-    theta = FMod2p(ThetaG_JD(sat->jul_utc) + geodetic.lon);
-    sin_theta = sin(theta);
-    cos_theta = cos(theta);
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-    Lxh = -cos(az) * cos(el);
-    Lyh = sin(az) * cos(el);
-    Lzh = sin(el);
-    Sx = sin_phi * cos_theta;
-    Ex = -sin_theta;
-    Zx = cos_theta * cos_phi;
-    Sy = sin_phi * sin_theta;
-    Ey = cos_theta;
-    Zy = sin_theta * cos_phi;
-    Sz = -cos_phi;
-    Ez = 0;
-    Zz = sin_phi;
-    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
-    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
-    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
-    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
-    cos_delta = sqrt(1 - Sqr(Lz));
-    sin_alpha = Ly / cos_delta;
-    cos_alpha = Lx / cos_delta;
-    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
-    obs_set->ra = FMod2p(obs_set->ra);
-}
-
 /** Reload reference to satellites (e.g. after TLE update). */
 void gtk_sat_list_reload_sats(GtkWidget * satlist, GHashTable * sats)
 {
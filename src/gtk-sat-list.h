@@ -63,6 +63,7 @@ struct _gtk_sat_list {
     guint           counter;    /*!< cycle counter */
 
     gdouble         tstamp;     /*!< time stamp of calculations; set by GtkSatModule */
+    GHashTable     *snaps;      /*!< snapshots of the satellites; set by GtkSatModule */
     GKeyFile       *cfgdata;
     gint            sort_column;
     GtkSortType     sort_order;
@@ -34,6 +34,7 @@
 #endif
 #include <gtk/gtk.h>
 #include <glib/gi18n.h>
+#include <string.h>
 
 #include "config-keys.h"
 #include "gtk-sat-map.h"
@@ -45,6 +46,8 @@
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
 
+/* number of ground track points computed per predict_ssp_series call */
+#define TRACK_CHUNK 64
 
 static void     create_polylines(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
                                  sat_map_obj_t * obj);
@@ -65,14 +68,27 @@ static void     free_ssp(gpointer ssp, gpointer data);
  * times, and using one single polyline for the whole ground track would look very
  * silly. To avoid this, the points will be split into several polylines.
  */
-void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
+void ground_track_create(GtkSatMap * satmap, sat_t * sat_in, qth_t * qth,
                          sat_map_obj_t * obj)
 {
+    sat_t           sat_working;
+    sat_t          *sat;
     long            this_orbit; /* current orbit number */
     long            max_orbit;  /* target orbit number, ie. this + num - 1 */
     double          t0;         /* time when this_orbit starts */
     double          t;
     ssp_t          *this_ssp;
+    gdouble         times[TRACK_CHUNK];
+    gdouble         lats[TRACK_CHUNK];
+    gdouble         lons[TRACK_CHUNK];
+    glong           orbits[TRACK_CHUNK];
+    glong           orbit;
+    guint           i, n;
+
+    /* the satellite is shared with the other views of the module and must
+       not be propagated here; use a working copy which shares the
+       propagation constants with it */
+    sat = memcpy(&sat_working, sat_in, sizeof(sat_t));
 
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
                 _("%s: Creating ground track for %s"),
@@ -114,15 +130,27 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
     sat_log_log(SAT_LOG_LEVEL_DEBUG,
                 _("%s: T0: %f (%d)"), __func__, t0, sat->orbit);
 
-    /* calculate (lat,lon) for the required orbits */
-    while ((sat->orbit <= max_orbit) &&
-           (sat->orbit >= this_orbit) && (!decayed(sat)))
+    /* calculate (lat,lon) for the required orbits; the SSPs are
+       computed in chunks of TRACK_CHUNK points using predict_ssp_series */
+    orbit = sat->orbit;
+    i = n = 0;
+    while ((orbit <= max_orbit) && (orbit >= this_orbit) && (!decayed(sat)))
     {
-        /* We use 30 sec time steps. If resolution is too fine, the
-           line drawing routine will filter out unnecessary points
-         */
-        t += 0.00035;
-        predict_calc(sat, qth, t);
+        if (i == n)
+        {
+            /* We use 30 sec time steps. If resolution is too fine, the
+               line drawing routine will filter out unnecessary points
+             */
+            for (n = 0; n < TRACK_CHUNK; n++)
+                times[n] = t + (n + 1) * 0.00035;
+
+            predict_ssp_series(sat, times, n, lats, lons, orbits);
+            i = 0;
+        }
+
+        t = times[i];
+        sat->jul_utc = t;
+        orbit = orbits[i];
 
         /* store this SSP */
 
@@ -140,14 +168,15 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
             return;
         }
 
-        this_ssp->lat = sat->ssplat;
-        this_ssp->lon = sat->ssplon;
+        this_ssp->lat = lats[i];
+        this_ssp->lon = lons[i];
         obj->track_data.latlon =
             g_slist_prepend(obj->track_data.latlon, this_ssp);
 
+        i++;
     }
     /* log if there is a problem with the orbit calculation */
-    if (sat->orbit != (max_orbit + 1))
+    if (orbit != (max_orbit + 1))
     {
         sat_log_log(SAT_LOG_LEVEL_ERROR,
                     _("%s: Problem computing ground track for %s"),
@@ -155,15 +184,11 @@ void ground_track_create(GtkSatMap * satmap, sat_t * sat, qth_t * qth,
         return;
     }
 
-    /* Reset satellite structure to eliminate glitches in single sat 
-       view and other places when new ground track is layed out */
-    predict_calc(sat, qth, satmap->tstamp);
-
     /* reverse GSList */
     obj->track_data.latlon = g_slist_reverse(obj->track_data.latlon);
 
     /* split points into polylines */
-    create_polylines(satmap, sat, qth, obj);
+    create_polylines(satmap, sat_in, qth, obj);
 
     /* misc book-keeping */
     obj->track_orbit = this_orbit;
@@ -191,10 +191,7 @@ static void coverage_toggled(GtkCheckMenuItem * item, gpointer data)
     /* set or clear coverage colour */
     if (obj->showcov)
     {
-        covcol = mod_cfg_get_int(satmap->cfgdata,
-                                 MOD_CFG_MAP_SECTION,
-                                 MOD_CFG_MAP_SAT_COV_COL,
-                                 SAT_CFG_INT_MAP_SAT_COV_COL);
+        covcol = satmap->covcol;
     }
     else
     {
@@ -233,6 +233,17 @@ GtkWidget      *gtk_sat_map_new(GKeyFile * cfgdata, GHashTable * sats,
 
     satmap->infobgd = rgba2html(col);
 
+    /* satellite colours are needed in every cycle */
+    satmap->satcol = mod_cfg_get_int(cfgdata, MOD_CFG_MAP_SECTION,
+                                     MOD_CFG_MAP_SAT_COL,
+                                     SAT_CFG_INT_MAP_SAT_COL);
+    satmap->selcol = mod_cfg_get_int(cfgdata, MOD_CFG_MAP_SECTION,
+                                     MOD_CFG_MAP_SAT_SEL_COL,
+                                     SAT_CFG_INT_MAP_SAT_SEL_COL);
+    satmap->covcol = mod_cfg_get_int(cfgdata, MOD_CFG_MAP_SECTION,
+                                     MOD_CFG_MAP_SAT_COV_COL,
+                                     SAT_CFG_INT_MAP_SAT_COV_COL);
+
     satmap->canvas = goo_canvas_new();
     g_object_set(G_OBJECT(satmap->canvas), "has-tooltip", TRUE, NULL);
 
@@ -847,17 +858,11 @@ static gboolean on_button_release(GooCanvasItem * item,
 
             if (obj->selected)
             {
-                col = mod_cfg_get_int(satmap->cfgdata,
-                                      MOD_CFG_MAP_SECTION,
-                                      MOD_CFG_MAP_SAT_SEL_COL,
-                                      SAT_CFG_INT_MAP_SAT_SEL_COL);
+                col = satmap->selcol;
             }
             else
             {
-                col = mod_cfg_get_int(satmap->cfgdata,
-                                      MOD_CFG_MAP_SECTION,
-                                      MOD_CFG_MAP_SAT_COL,
-                                      SAT_CFG_INT_MAP_SAT_COL);
+                col = satmap->satcol;
                 *catpoint = 0;
 
                 g_object_set(satmap->sel, "text", "", NULL);
@@ -933,10 +938,7 @@ void gtk_sat_map_select_sat(GtkWidget * satmap, gint catnum)
     {
         obj->selected = TRUE;
 
-        col = mod_cfg_get_int(smap->cfgdata,
-                              MOD_CFG_MAP_SECTION,
-                              MOD_CFG_MAP_SAT_SEL_COL,
-                              SAT_CFG_INT_MAP_SAT_SEL_COL);
+        col = smap->selcol;
 
         g_object_set(obj->marker,
                      "fill-color-rgba", col, "stroke-color-rgba", col, NULL);
@@ -1732,22 +1734,14 @@ static void plot_sat(gpointer key, gpointer value, gpointer data)
     root = goo_canvas_get_root_item_model(GOO_CANVAS(satmap->canvas));
 
     /* satellite color */
-    col = mod_cfg_get_int(satmap->cfgdata,
-                          MOD_CFG_MAP_SECTION,
-                          MOD_CFG_MAP_SAT_COL, SAT_CFG_INT_MAP_SAT_COL);
+    col = satmap->satcol;
 
     /* area coverage colour */
-    covcol = mod_cfg_get_int(satmap->cfgdata,
-                             MOD_CFG_MAP_SECTION,
-                             MOD_CFG_MAP_SAT_COV_COL,
-                             SAT_CFG_INT_MAP_SAT_COV_COL);
+    covcol = satmap->covcol;
     /* coverage color */
     if (obj->showcov)
     {
-        covcol = mod_cfg_get_int(satmap->cfgdata,
-                                 MOD_CFG_MAP_SECTION,
-                                 MOD_CFG_MAP_SAT_COV_COL,
-                                 SAT_CFG_INT_MAP_SAT_COV_COL);
+        covcol = satmap->covcol;
     }
     else
     {
@@ -2049,25 +2043,16 @@ static void update_sat(gpointer key, gpointer value, gpointer data)
                 /* we need to create the second part */
                 if (obj->selected)
                 {
-                    col = mod_cfg_get_int(satmap->cfgdata,
-                                          MOD_CFG_MAP_SECTION,
-                                          MOD_CFG_MAP_SAT_SEL_COL,
-                                          SAT_CFG_INT_MAP_SAT_SEL_COL);
+                    col = satmap->selcol;
                 }
                 else
                 {
-                    col = mod_cfg_get_int(satmap->cfgdata,
-                                          MOD_CFG_MAP_SECTION,
-                                          MOD_CFG_MAP_SAT_COL,
-                                          SAT_CFG_INT_MAP_SAT_COL);
+                    col = satmap->satcol;
                 }
                 /* coverage color */
                 if (obj->showcov)
                 {
-                    covcol = mod_cfg_get_int(satmap->cfgdata,
-                                             MOD_CFG_MAP_SECTION,
-                                             MOD_CFG_MAP_SAT_COV_COL,
-                                             SAT_CFG_INT_MAP_SAT_COV_COL);
+                    covcol = satmap->covcol;
                 }
                 else
                 {
@@ -130,6 +130,9 @@ typedef struct {
     gboolean        resize;     /*!< Flag indicating that the map has been resized. */
 
     gchar          *infobgd;    /*!< Background color of info text. */
+    guint32         satcol;     /*!< Colour of the satellites. */
+    guint32         selcol;     /*!< Colour of the selected satellites. */
+    guint32         covcol;     /*!< Colour of the coverage areas. */
 
     GdkPixbuf      *origmap;    /*!< Original map kept here for high quality scaling. */
 
@@ -35,9 +35,11 @@
 #include "gtk-sat-module-tmg.h"
 #include "gtk-sky-glance.h"
 #include "mod-mgr.h"
+#include "sat-pass-dialogs.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
+#include "time-tools.h"
 
 
 extern GtkWidget *app;          /* in main.c */
@@ -48,7 +50,9 @@ static void     docking_state_cb(GtkWidget * menuitem, gpointer data);
 static void     screen_state_cb(GtkWidget * menuitem, gpointer data);
 static void     sat_selected_cb(GtkWidget * menuitem, gpointer data);
 static void     sky_at_glance_cb(GtkWidget * menuitem, gpointer data);
+static void     network_passes_cb(GtkWidget * menuitem, gpointer data);
 static void     tmgr_cb(GtkWidget * menuitem, gpointer data);
+static void     performance_cb(GtkWidget * menuitem, gpointer data);
 static void     rigctrl_cb(GtkWidget * menuitem, gpointer data);
 static void     rotctrl_cb(GtkWidget * menuitem, gpointer data);
 static void     delete_cb(GtkWidget * menuitem, gpointer data);
@@ -167,11 +171,26 @@ void gtk_sat_module_popup(GtkSatModule * module)
     g_signal_connect(menuitem, "activate",
                      G_CALLBACK(sky_at_glance_cb), module);
 
+    /* mutual passes over the ground station network */
+    if (module->network != NULL)
+    {
+        menuitem = gtk_menu_item_new_with_label(_("Network passes"));
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+        g_signal_connect(menuitem, "activate",
+                         G_CALLBACK(network_passes_cb), module);
+    }
+
     /* time manager */
     menuitem = gtk_menu_item_new_with_label(_("Time Controller"));
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
     g_signal_connect(menuitem, "activate", G_CALLBACK(tmgr_cb), module);
 
+    /* cycle timing */
+    menuitem = gtk_menu_item_new_with_label(_("Performance"));
+    gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+    g_signal_connect(menuitem, "activate", G_CALLBACK(performance_cb),
+                     module);
+
     /* separator */
     menuitem = gtk_separator_menu_item_new();
     gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
@@ -852,6 +871,41 @@ static void sky_at_glance_cb(GtkWidget * menuitem, gpointer data)
     g_mutex_unlock(&module->busy);
 }
 
+/**
+ * Show the passes that are visible from several ground stations.
+ *
+ * The ground stations are the module QTH and the stations listed in the
+ * NETWORK key of the module configuration.
+ */
+static void network_passes_cb(GtkWidget * menuitem, gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+    qth_t          *qths[MULTI_QTH_MAX];
+    GSList         *node;
+    guint           nqth = 0;
+    gdouble         start;
+
+    (void)menuitem;
+
+    qths[nqth++] = module->qth;
+    for (node = module->network; node != NULL && nqth < MULTI_QTH_MAX;
+         node = node->next)
+    {
+        qths[nqth++] = (qth_t *) node->data;
+    }
+
+    if (sat_cfg_get_bool(SAT_CFG_BOOL_PRED_USE_REAL_T0))
+        start = get_current_daynum();
+    else
+        start = module->tmgCdnum;
+
+    g_mutex_lock(&module->busy);
+    show_network_passes(module->satellites, qths, nqth, start,
+                        sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD),
+                        gtk_widget_get_toplevel(GTK_WIDGET(module)));
+    g_mutex_unlock(&module->busy);
+}
+
 /** Open time manager. */
 static void tmgr_cb(GtkWidget * menuitem, gpointer data)
 {
@@ -862,6 +916,62 @@ static void tmgr_cb(GtkWidget * menuitem, gpointer data)
     tmg_create(module);
 }
 
+/**
+ * Show the timing of the module cycle.
+ *
+ * The statistics are shown as they were when the dialog was opened;
+ * "Refresh" updates them and "Reset" starts collecting them anew.
+ */
+static void performance_cb(GtkWidget * menuitem, gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+    GtkWidget      *dialog;
+    GtkWidget      *label;
+    gchar          *title;
+    gchar          *report;
+    gchar          *markup;
+    gint            response;
+
+    (void)menuitem;
+
+    title = g_strdup_printf(_("Performance of %s"), module->name);
+    dialog = gtk_dialog_new_with_buttons(title,
+                                         GTK_WINDOW(gtk_widget_get_toplevel
+                                                    (GTK_WIDGET(module))),
+                                         GTK_DIALOG_MODAL |
+                                         GTK_DIALOG_DESTROY_WITH_PARENT,
+                                         "_Reset", GTK_RESPONSE_REJECT,
+                                         "_Refresh", GTK_RESPONSE_APPLY,
+                                         "_Close", GTK_RESPONSE_CLOSE,
+                                         NULL);
+    gtk_container_set_border_width(GTK_CONTAINER(dialog), 5);
+    g_free(title);
+
+    label = gtk_label_new(NULL);
+    gtk_label_set_selectable(GTK_LABEL(label), TRUE);
+    gtk_widget_set_halign(label, GTK_ALIGN_START);
+    gtk_box_pack_start(GTK_BOX
+                       (gtk_dialog_get_content_area(GTK_DIALOG(dialog))),
+                       label, TRUE, TRUE, 5);
+    gtk_widget_show_all(dialog);
+
+    do
+    {
+        report = tick_prof_report(module->prof);
+        markup = g_markup_printf_escaped("<tt>%s</tt>", report);
+        gtk_label_set_markup(GTK_LABEL(label), markup);
+        g_free(markup);
+        g_free(report);
+
+        response = gtk_dialog_run(GTK_DIALOG(dialog));
+        if (response == GTK_RESPONSE_REJECT)
+            tick_prof_reset(module->prof);
+    }
+    while (response == GTK_RESPONSE_REJECT || response == GTK_RESPONSE_APPLY);
+
+    gtk_widget_destroy(dialog);
+}
+
 /**
  * Open Radio control window.
  *
@@ -1053,6 +1163,7 @@ static gint window_delete(GtkWidget * widget, GdkEvent * event, gpointer data)
 static void autotrack_cb(GtkCheckMenuItem * menuitem, gpointer data)
 {
     GTK_SAT_MODULE(data)->autotrack = gtk_check_menu_item_get_active(menuitem);
+    GTK_SAT_MODULE(data)->autotrack_next = 0.0;
 }
 
 /**
@@ -42,6 +42,7 @@
 
 #include "compat.h"
 #include "config-keys.h"
+#include "ephem-cache.h"
 #include "gpredict-utils.h"
 #include "gtk-event-list.h"
 #include "gtk-polar-view.h"
@@ -58,12 +59,38 @@
 #include "mod-cfg-get-param.h"
 #include "mod-mgr.h"
 #include "orbit-tools.h"
+#include "pass-service.h"
 #include "predict-tools.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
 #include "sgpsdp/sgp4sdp4.h"
 #include "time-tools.h"
 
+/* largest difference between the time of the cycle and the time propagated
+   in the background that is accepted at throttle 1 [days] */
+#define PROP_MAX_SKEW (0.1 / 86400.0)
+
+/* largest number of satellites whose AOS/LOS are recalculated in one cycle;
+   if more are due, e.g. after the time has jumped forward, the rest is
+   handed to the pass service */
+#define EVENT_BUDGET 8
+
+/* time until a satellite that has no AOS/LOS within the look-ahead time
+   is checked again [days] */
+#define EVENT_RETRY (1.0 / 24.0)
+
+/* phases of the cycle timed by the profiler; the views are numbered
+   from PROF_VIEWS */
+enum {
+    PROF_QTH = 0,
+    PROF_HEADER,
+    PROF_SATS,
+    PROF_SNAPS,
+    PROF_CTRL,
+    PROF_SKG,
+    PROF_VIEWS
+};
+
 
 static GtkVBoxClass *parent_class = NULL;
 
@@ -89,6 +116,11 @@ static void update_autotrack(GtkSatModule * module)
     if (sat != NULL && sat->el > 0.0)
         return;
 
+    /* the choice can only change when a satellite rises or sets, i.e. at
+       the next event in the event queue */
+    if (sat != NULL && module->tmgCdnum < module->autotrack_next)
+        return;
+
     /* set target to satellite with next AOS */
     satlist = g_hash_table_get_values(module->satellites);
     iter = satlist;
@@ -130,6 +162,9 @@ static void update_autotrack(GtkSatModule * module)
     }
 
     g_list_free(satlist);
+
+    if (event_queue_peek(module->events, &module->autotrack_next) == NULL)
+        module->autotrack_next = 0.0;
 }
 
 static void gtk_sat_module_destroy(GtkWidget * widget)
@@ -166,6 +201,22 @@ static void gtk_sat_module_destroy(GtkWidget * widget)
         gtk_widget_destroy(module->skgwin);
     }
 
+    /* drop pending AOS/LOS calculations */
+    pass_service_cancel(module);
+
+    if (module->cfg_notify)
+    {
+        sat_cfg_remove_notify(module->cfg_notify);
+        module->cfg_notify = 0;
+    }
+
+    /* stop background propagation before the satellites are freed */
+    if (module->propagator)
+    {
+        prop_worker_free(module->propagator);
+        module->propagator = NULL;
+    }
+
     /* clean up QTH */
     if (module->qth)
     {
@@ -173,6 +224,13 @@ static void gtk_sat_module_destroy(GtkWidget * widget)
         module->qth = NULL;
     }
 
+    /* clean up ground station network */
+    if (module->network)
+    {
+        g_slist_free_full(module->network, (GDestroyNotify) qth_data_free);
+        module->network = NULL;
+    }
+
     /* clean up satellites */
     if (module->satellites)
     {
@@ -180,6 +238,36 @@ static void gtk_sat_module_destroy(GtkWidget * widget)
         module->satellites = NULL;
     }
 
+    if (module->sgp4blocks)
+    {
+        g_array_free(module->sgp4blocks, TRUE);
+        module->sgp4blocks = NULL;
+    }
+
+    if (module->ephem)
+    {
+        g_hash_table_destroy(module->ephem);
+        module->ephem = NULL;
+    }
+
+    if (module->snaps)
+    {
+        g_hash_table_destroy(module->snaps);
+        module->snaps = NULL;
+    }
+
+    if (module->events)
+    {
+        event_queue_free(module->events);
+        module->events = NULL;
+    }
+
+    if (module->prof)
+    {
+        tick_prof_free(module->prof);
+        module->prof = NULL;
+    }
+
     if (module->grid)
     {
         g_free(module->grid);
@@ -200,6 +288,57 @@ static void gtk_sat_module_class_init(GtkSatModuleClass * class)
     parent_class = g_type_class_peek_parent(class);
 }
 
+/** Create the profiler and name the fixed phases of the cycle. */
+static tick_prof_t *gtk_sat_module_prof_new(void)
+{
+    tick_prof_t    *prof = tick_prof_new();
+
+    tick_prof_set_name(prof, PROF_QTH, _("QTH update"));
+    tick_prof_set_name(prof, PROF_HEADER, _("Header and events"));
+    tick_prof_set_name(prof, PROF_SATS, _("Satellites"));
+    tick_prof_set_name(prof, PROF_SNAPS, _("Snapshots"));
+    tick_prof_set_name(prof, PROF_CTRL, _("Autotrack, radio, rotator"));
+    tick_prof_set_name(prof, PROF_SKG, _("Sky at a glance"));
+
+    return prof;
+}
+
+/**
+ * React to changes of the global configuration.
+ *
+ * The events are recalculated in the next cycle when the prediction
+ * parameters change, and the ephemeris caches are dropped when their
+ * parameters change.
+ */
+static void gtk_sat_module_cfg_changed(sat_cfg_type_e type, guint param,
+                                       gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+
+    if (type != SAT_CFG_TYPE_INT)
+        return;
+
+    switch (param)
+    {
+    case SAT_CFG_INT_PRED_MIN_EL:
+    case SAT_CFG_INT_PRED_LOOK_AHEAD:
+        module->event_count = 0;
+        break;
+
+    case SAT_CFG_INT_EPHEM_CACHE_SPAN:
+    case SAT_CFG_INT_EPHEM_CACHE_TOL:
+        g_hash_table_remove_all(module->ephem);
+        break;
+
+    case SAT_CFG_INT_MODULE_PROF_LOG:
+        module->prof_logged = g_get_monotonic_time();
+        break;
+
+    default:
+        break;
+    }
+}
+
 /** Initialise GtkSatModule widget */
 static void gtk_sat_module_init(GtkSatModule * module)
 {
@@ -208,9 +347,21 @@ static void gtk_sat_module_init(GtkSatModule * module)
 
     module->qth = g_try_new0(qth_t, 1);
     qth_init(module->qth);
+    module->network = NULL;
 
     module->satellites = g_hash_table_new_full(g_int_hash, g_int_equal,
                                                g_free, gtk_sat_module_free_sat);
+    module->sgp4blocks = g_array_new(FALSE, FALSE, sizeof(sgp4_multi_t));
+    module->ephem = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                          (GDestroyNotify) ephem_cache_free);
+    module->propagator = prop_worker_new();
+    module->snaps = sat_snap_table_new();
+    module->events = event_queue_new();
+    module->event_time = 0.0;
+    module->cfg_notify = sat_cfg_add_notify(gtk_sat_module_cfg_changed,
+                                            module);
+    module->prof = gtk_sat_module_prof_new();
+    module->prof_logged = g_get_monotonic_time();
 
     module->rotctrlwin = NULL;
     module->rotctrl = NULL;
@@ -243,6 +394,7 @@ static void gtk_sat_module_init(GtkSatModule * module)
 
     module->target = -1;
     module->autotrack = FALSE;
+    module->autotrack_next = 0.0;
 }
 
 GType gtk_sat_module_get_type()
@@ -349,6 +501,31 @@ static void get_grid_size(GtkSatModule * module, guint * rows, guint * cols)
     *rows = ymax;
 }
 
+/**
+ * Name the profiler phase of a view.
+ *
+ * @param module Pointer to the GtkSatModule widget.
+ * @param i The index of the view in the layout.
+ * @param type The type of the view, see gtk_sat_mod_view_t
+ */
+static void name_view_phase(GtkSatModule * module, guint i, guint type)
+{
+    const gchar    *names[GTK_SAT_MOD_VIEW_NUM] = {
+        N_("List"),
+        N_("Map"),
+        N_("Polar"),
+        N_("Single"),
+        N_("Events")
+    };
+    gchar          *name;
+
+    name = g_strdup_printf(_("View %u: %s"), i + 1,
+                           type < GTK_SAT_MOD_VIEW_NUM ?
+                           _(names[type]) : _(names[GTK_SAT_MOD_VIEW_LIST]));
+    tick_prof_set_name(module->prof, PROF_VIEWS + i, name);
+    g_free(name);
+}
+
 /**
  * Create module layout and add views.
  *
@@ -379,6 +556,7 @@ static void create_module_layout(GtkSatModule * module)
 
         /* store a pointer to the view */
         module->views = g_slist_append(module->views, view);
+        name_view_phase(module, i, module->grid[5 * i]);
 
         /* add view to the grid */
         gtk_grid_attach(GTK_GRID(table), view,
@@ -392,6 +570,41 @@ static void create_module_layout(GtkSatModule * module)
 }
 
 
+/**
+ * Pack the near-earth satellites into blocks for predict_calc_multi.
+ *
+ * @param module Pointer to the GtkSatModule widget.
+ *
+ * The blocks refer to the sat_t structures in module->satellites, so they
+ * must be rebuilt every time the satellites are (re)loaded.
+ */
+static void gtk_sat_module_load_sgp4blocks(GtkSatModule * module)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    sgp4_multi_t    block;
+
+    g_array_set_size(module->sgp4blocks, 0);
+    SGP4_Multi_Init(&block);
+
+    g_hash_table_iter_init(&iter, module->satellites);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        if (SAT(value)->flags & DEEP_SPACE_EPHEM_FLAG)
+            continue;
+
+        SGP4_Multi_Add(&block, SAT(value));
+        if (block.num == SGP4_MULTI_LANES)
+        {
+            g_array_append_val(module->sgp4blocks, block);
+            SGP4_Multi_Init(&block);
+        }
+    }
+
+    if (block.num > 0)
+        g_array_append_val(module->sgp4blocks, block);
+}
+
 /**
  * Read satellites into memory.
  *
@@ -433,7 +646,7 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
     /* read each satellite into hash table */
     for (i = 0; i < length; i++)
     {
-        sat = g_new(sat_t, 1);
+        sat = g_new0(sat_t, 1);
 
         if (gtk_sat_data_read_sat(sats[i], sat))
         {
@@ -442,7 +655,7 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
                         _("%s: Error reading data for #%d"),
                         __func__, sats[i]);
 
-            g_free(sat);
+            gtk_sat_data_free_sat(sat);
         }
         else
         {
@@ -467,7 +680,7 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
                             __func__, sats[i]);
 
                 /* it is not needed in this case */
-                g_free(sat);
+                gtk_sat_data_free_sat(sat);
             }
 
         }
@@ -477,6 +690,34 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
                 _("%s: Read %d out of %d satellites"), __func__, succ, length);
 
     g_free(sats);
+
+    gtk_sat_module_load_sgp4blocks(module);
+    prop_worker_set_sats(module->propagator, module->satellites);
+}
+
+/**
+ * Replace the GtkSkyGlance widget with a new one.
+ *
+ * @param module Pointer to the GtkSatModule widget
+ *
+ * Used when all passes have to be predicted again, i.e. when the satellites
+ * have been reloaded or the qth has moved.
+ */
+static void recreate_skg(GtkSatModule * module)
+{
+    sat_log_log(SAT_LOG_LEVEL_INFO,
+                _("%s: Updating GtkSkyGlance for %s"),
+                __func__, module->name);
+
+    gtk_container_remove(GTK_CONTAINER(module->skgwin), module->skg);
+    module->skg =
+        gtk_sky_glance_new(module->satellites, module->qth,
+                           module->tmgCdnum);
+    gtk_container_add(GTK_CONTAINER(module->skgwin), module->skg);
+    gtk_widget_show_all(module->skg);
+
+    module->lastSkgUpd = module->tmgCdnum;
+    qth_small_save(module->qth, &(module->lastSkgUpdqth));
 }
 
 /**
@@ -491,10 +732,9 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
  * GtkSkyGlance widget was last updated and triggers an update if necessary.
  * The current distance is set to 1km.
  *
- * This is a cheap/lazy implementation of automatic update. Instead of
- * performing a real update by "moving" the objects on the GtkSkyGlance canvas,
- * we simply replace the current GtkSkyGlance object with a new one.
- * Ugly but safe.
+ * When only the time has changed, the time axis of the GtkSkyGlance widget
+ * is moved and only the passes entering the view are predicted. When the qth
+ * has moved, all passes change and the widget is replaced with a new one.
  *
  * To ensure smooth performance while running in simulated real time with high
  * throttle value or manual time mode, the caller is responsible for only calling
@@ -502,24 +742,19 @@ static void gtk_sat_module_load_sats(GtkSatModule * module)
  */
 static void update_skg(GtkSatModule * module)
 {
-    /* update SKG if ~60 seconds have passed or we have moved 1 km */
-    if (G_UNLIKELY(fabs(module->tmgCdnum - module->lastSkgUpd) > 7.0e-4) ||
-        G_UNLIKELY(qth_small_dist(module->qth, module->lastSkgUpdqth) > 1.0))
+    /* replace SKG if we have moved 1 km */
+    if (G_UNLIKELY(qth_small_dist(module->qth, module->lastSkgUpdqth) > 1.0))
     {
-
-        sat_log_log(SAT_LOG_LEVEL_INFO,
-                    _("%s: Updating GtkSkyGlance for %s"),
-                    __func__, module->name);
-
-        gtk_container_remove(GTK_CONTAINER(module->skgwin), module->skg);
-        module->skg =
-            gtk_sky_glance_new(module->satellites, module->qth,
-                               module->tmgCdnum);
-        gtk_container_add(GTK_CONTAINER(module->skgwin), module->skg);
-        gtk_widget_show_all(module->skg);
+        recreate_skg(module);
+    }
+    /* move the time axis if ~60 seconds have passed */
+    else if (G_UNLIKELY(fabs(module->tmgCdnum - module->lastSkgUpd) > 7.0e-4))
+    {
+        /* the module may have no satellites, then there is only a label */
+        if (IS_GTK_SKY_GLANCE(module->skg))
+            gtk_sky_glance_set_time(module->skg, module->tmgCdnum);
 
         module->lastSkgUpd = module->tmgCdnum;
-        qth_small_save(module->qth, &(module->lastSkgUpdqth));
     }
 }
 
@@ -555,15 +790,18 @@ static void update_header(GtkSatModule * module)
  *
  * @param child Pointer to the child widget (views)
  * @param tstamp The current timestamp
+ * @param snaps The satellite snapshots of this cycle
  *
  * This function is called by the main loop of the GtkSatModule widget for
  * each view in the layout grid.
  */
-static void update_child(GtkWidget * child, gdouble tstamp)
+static void update_child(GtkWidget * child, gdouble tstamp,
+                         GHashTable * snaps)
 {
     if (IS_GTK_SAT_LIST(child))
     {
         GTK_SAT_LIST(child)->tstamp = tstamp;
+        GTK_SAT_LIST(child)->snaps = snaps;
         gtk_sat_list_update(child);
     }
 
@@ -582,6 +820,7 @@ static void update_child(GtkWidget * child, gdouble tstamp)
     else if (IS_GTK_SINGLE_SAT(child))
     {
         GTK_SINGLE_SAT(child)->tstamp = tstamp;
+        GTK_SINGLE_SAT(child)->snaps = snaps;
         gtk_single_sat_update(child);
     }
 
@@ -599,52 +838,118 @@ static void update_child(GtkWidget * child, gdouble tstamp)
 }
 
 /**
- * Update a given satellite.
+ * Get the ephemeris cache of a satellite.
  *
- * @param key The hash table key (catnum)
- * @param val The hash table value (sat_t structure)
- * @param data User data (the GtkSatModule widget).
+ * The cache is created on first use with the segment length and tolerance
+ * from the configuration.
+ */
+static ephem_cache_t *gtk_sat_module_get_ephem(GtkSatModule * module,
+                                               sat_t * sat)
+{
+    ephem_cache_t  *cache;
+
+    cache = g_hash_table_lookup(module->ephem, sat);
+    if (cache == NULL)
+    {
+        cache = ephem_cache_new(sat_cfg_get_int(SAT_CFG_INT_EPHEM_CACHE_SPAN) /
+                                86400.0,
+                                sat_cfg_get_int(SAT_CFG_INT_EPHEM_CACHE_TOL) /
+                                1000.0);
+        g_hash_table_insert(module->ephem, sat, cache);
+    }
+
+    return cache;
+}
+
+/**
+ * Queue a satellite for the time of its next AOS or LOS.
  *
- * This function updates the tracking data for a given satelite. It is called by
- * the timeout handler for each element in the hash table.
+ * Satellites that have neither within the look-ahead time are queued to be
+ * checked again after EVENT_RETRY.
  */
-static void gtk_sat_module_update_sat(gpointer key, gpointer val,
-                                      gpointer data)
+static void gtk_sat_module_queue_events(GtkSatModule * module, sat_t * sat)
 {
-    sat_t          *sat;
-    GtkSatModule   *module;
-    gdouble         daynum;
-    gdouble         maxdt;
+    gdouble         next = 0.0;
+
+    if (sat->aos > 0.0)
+        next = sat->aos;
+
+    if (sat->los > 0.0 && (next == 0.0 || sat->los < next))
+        next = sat->los;
+
+    if (next == 0.0)
+        next = module->tmgCdnum + EVENT_RETRY;
+
+    event_queue_set(module->events, sat, next);
+}
+
+/** Store the AOS and LOS found by the pass service. */
+static void gtk_sat_module_events_ready(sat_t * sat, gdouble aos, gdouble los,
+                                        gpointer data)
+{
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+
+    sat->aos = aos;
+    sat->los = los;
+
+    gtk_sat_module_queue_events(module, sat);
+
+    /* a new AOS may change the autotrack target */
+    module->autotrack_next = 0.0;
+}
+
+/** Request the AOS and LOS of a satellite from the pass service. */
+static void gtk_sat_module_request_event(gpointer key, gpointer val,
+                                         gpointer data)
+{
+    sat_t          *sat = SAT(val);
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
 
     (void)key;
 
-    g_return_if_fail((val != NULL) && (data != NULL));
+    /* Note that has_aos may return TRUE for geostationary sats
+       whose orbit deviate from a true-geostat orbit, however,
+       find_aos and find_los will not go beyond the time limit
+       we specify (in those cases they return 0.0 for AOS/LOS times.
+       We use SAT_CFG_INT_PRED_LOOK_AHEAD for upper time limit */
+    if (has_aos(sat, module->qth))
+        pass_service_get_events(sat, module->qth, module->tmgCdnum,
+                                sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD),
+                                gtk_sat_module_events_ready, module);
+}
+
+/**
+ * Update the AOS and LOS of the satellites whose next event has passed.
+ *
+ * @param module The GtkSatModule widget.
+ *
+ * The satellites are taken from the event queue in the order of their next
+ * event. At most EVENT_BUDGET of them are recalculated here; if more are
+ * due, the rest is recalculated in the background by the pass service so
+ * that the main loop is not blocked.
+ */
+static void gtk_sat_module_update_events(GtkSatModule * module)
+{
+    sat_t          *sat;
+    sat_t           sat_working;
+    gdouble         daynum;
+    gdouble         next;
+    gdouble         maxdt;
+    guint           i;
 
-    sat = SAT(val);
-    module = GTK_SAT_MODULE(data);
     maxdt = (gdouble) sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD);
 
     /* get current time (real or simulated */
     daynum = module->tmgCdnum;
 
-    /* update events if the event counter has been reset
-       and the other requirements are fulfilled */
-    if ((GTK_SAT_MODULE(module)->event_count == 0) &&
-        has_aos(sat, module->qth))
-    {
-        /* Note that has_aos may return TRUE for geostationary sats
-           whose orbit deviate from a true-geostat orbit, however,
-           find_aos and find_los will not go beyond the time limit
-           we specify (in those cases they return 0.0 for AOS/LOS times.
-           We use SAT_CFG_INT_PRED_LOOK_AHEAD for upper time limit */
-        sat->aos = find_aos(sat, module->qth, daynum, maxdt);
-        sat->los = find_los(sat, module->qth, daynum, maxdt);
-    }
     /*
-       Update AOS and LOS for this satellite if it was known and is before
-       the current time.
+       The events of all satellites are recalculated in the background by
+       gtk_sat_module_request_events when the event counter has been reset.
+       The results are put into the event queue, keyed by the earliest of
+       AOS and LOS.
 
-       daynum is the current time in the module.
+       Update AOS and LOS for a satellite when the earliest of them is
+       before the current time.
 
        The conditional aos < daynum is merely saying that aos occured
        in the past. Therefore it cannot be the next event or aos/los
@@ -652,37 +957,178 @@ static void gtk_sat_module_update_sat(gpointer key, gpointer val,
 
        The conditional aos > 0.0 is a short hand for saying that the
        aos was successfully computed before. find_aos returns 0.0 when it
-       cannot find an AOS.
-
-       This code should not execute find_aos(los) if the conditional before
-       is triggered as the newly computed aos(los) should either be in
-       the future (aos > daynum) or (aos == 0 ).
+       cannot find an AOS. Satellites without AOS and LOS, e.g. in parking
+       orbits where the AOS may be further than maxdt out, are queued for
+       EVENT_RETRY later.
 
        Single sat/list/event/map views all use these values and they
-       should be up to date.
+       should be up to date; satellites that do not fit into the budget
+       of this cycle are sent to the pass service and queued again when
+       their results arrive.
 
-       The above code is still required for dealing with circumstances
-       where the qth moves from someplace where the qth can have an AOS and
-       where qth does not and for satellites in parking orbits where the
-       AOS may be further than maxdt out results in aos==0.0 until the
-       next aos is closer than maxdt. It also prevents the aos from
-       being computed every pass through the module for the parking orbits.
+       find_aos and find_los propagate the satellite, so they work on a
+       copy; the position of this cycle must not be changed.
 
        To be completely correct, when time can move forward and backwards
        as it can with the time controller, the time the aos/los was
-       computed should be stored and associated with aos/los. That way
-       if daynum <time_computed, the aos can be recomputed as there is
-       no assurance that the current stored aos is the next aos. As a
-       practical matter the above code handles time reversing acceptably
-       for most circumstances.
+       computed should be stored and associated with aos/los. The timeout
+       handler recalculates all events when the time has been set back,
+       which handles time reversing acceptably for most circumstances.
      */
-    if (sat->aos > 0 && sat->aos < daynum)
-        sat->aos = find_aos(sat, module->qth, daynum, maxdt);
+    for (i = 0; ; i++)
+    {
+        sat = event_queue_peek(module->events, &next);
+        if (sat == NULL || next >= daynum)
+            break;
+
+        event_queue_pop(module->events, NULL);
+
+        if (i >= EVENT_BUDGET)
+        {
+            if (has_aos(sat, module->qth))
+            {
+                gtk_sat_module_request_event(NULL, sat, module);
+            }
+            else
+            {
+                /* no request, e.g. decayed; keep it queued like below */
+                sat->aos = 0.0;
+                sat->los = 0.0;
+                gtk_sat_module_queue_events(module, sat);
+            }
+            continue;
+        }
+
+        sat_working = *sat;
+
+        if (sat->aos == 0.0 && sat->los == 0.0)
+        {
+            sat->aos = find_aos(&sat_working, module->qth, daynum, maxdt);
+            sat->los = find_los(&sat_working, module->qth, daynum, maxdt);
+        }
+        else
+        {
+            if (sat->aos > 0 && sat->aos < daynum)
+                sat->aos = find_aos(&sat_working, module->qth, daynum,
+                                    maxdt);
+
+            if (sat->los > 0 && sat->los < daynum)
+                sat->los = find_los(&sat_working, module->qth, daynum,
+                                    maxdt);
+        }
+
+        gtk_sat_module_queue_events(module, sat);
+    }
+}
+
+/**
+ * Update the position of a given satellite.
+ *
+ * Unless the ephemeris cache is enabled, only deep-space satellites are
+ * calculated here; the caller does the near-earth satellites all at once
+ * using predict_calc_multi.
+ */
+static void gtk_sat_module_update_sat(gpointer key, gpointer val,
+                                      gpointer data)
+{
+    sat_t          *sat = SAT(val);
+    GtkSatModule   *module = GTK_SAT_MODULE(data);
+
+    (void)key;
+
+    if (sat_cfg_get_bool(SAT_CFG_BOOL_EPHEM_CACHE))
+        predict_calc_ephem(sat, gtk_sat_module_get_ephem(module, sat),
+                           &module->obs_frame);
+    else if (sat->flags & DEEP_SPACE_EPHEM_FLAG)
+        predict_calc_frame(sat, &module->obs_frame);
+}
+
+/**
+ * Recalculate the AOS and LOS of all satellites.
+ *
+ * The calculations run in the background, one task per satellite; results
+ * of a previous request that have not arrived yet are dropped.
+ */
+static void gtk_sat_module_request_events(GtkSatModule * module)
+{
+    pass_service_cancel(module);
+
+    /* the satellites are queued again as the results arrive */
+    event_queue_clear(module->events);
+    module->event_time = module->tmgCdnum;
+
+    if (module->satellites != NULL)
+        g_hash_table_foreach(module->satellites,
+                             gtk_sat_module_request_event, module);
+}
+
+/**
+ * Update all satellites in the module.
+ *
+ * module->obs_frame must be up to date with module->tmgCdnum.
+ */
+static void gtk_sat_module_update_sats(GtkSatModule * module)
+{
+    gdouble         tol;
+
+    if (module->satellites == NULL)
+        return;
+
+    /* find_aos and find_los propagate the satellites, so the events must
+       be updated before the positions of this cycle are stored */
+    gtk_sat_module_update_events(module);
+
+    /* use the positions propagated in the background if they are for this
+       cycle; the tolerance grows with the throttle like the timer jitter */
+    tol = PROP_MAX_SKEW * MAX(1, ABS(module->throttle));
+    if (!prop_worker_fetch(module->propagator, module->qth,
+                           module->tmgCdnum, tol))
+    {
+        g_hash_table_foreach(module->satellites, gtk_sat_module_update_sat,
+                             module);
+
+        if (!sat_cfg_get_bool(SAT_CFG_BOOL_EPHEM_CACHE))
+            predict_calc_multi((sgp4_multi_t *) module->sgp4blocks->data,
+                               module->sgp4blocks->len, &module->obs_frame);
+    }
+}
+
+/**
+ * Start propagating the satellites for the next cycle in the background.
+ *
+ * The time of the next cycle is estimated from the timeout and the throttle.
+ */
+static void gtk_sat_module_request_next(GtkSatModule * module)
+{
+    gdouble         tnext;
+
+    tnext = module->tmgCdnum +
+        module->throttle * (module->timeout / 1000.0) / 86400.0;
+
+    prop_worker_request(module->propagator, module->qth, tnext);
+}
+
+/**
+ * Write the cycle timing to the log.
+ *
+ * The statistics are logged every SAT_CFG_INT_MODULE_PROF_LOG seconds;
+ * nothing is logged if the interval is 0.
+ */
+static void gtk_sat_module_log_prof(GtkSatModule * module)
+{
+    gint            interval;
+    gint64          now;
 
-    if (sat->los > 0 && sat->los < daynum)
-        sat->los = find_los(sat, module->qth, daynum, maxdt);
+    interval = sat_cfg_get_int(SAT_CFG_INT_MODULE_PROF_LOG);
+    if (interval <= 0)
+        return;
+
+    now = g_get_monotonic_time();
+    if (now - module->prof_logged < (gint64) interval * G_USEC_PER_SEC)
+        return;
 
-    predict_calc(sat, module->qth, daynum);
+    tick_prof_log(module->prof, module->name);
+    module->prof_logged = now;
 }
 
 /** Module timeout callback. */
@@ -695,6 +1141,8 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
     gdouble         delta;
     guint           i;
 
+    tick_prof_begin(mod->prof);
+
     /*update the qth position */
     qth_data_update(mod->qth, mod->tmgCdnum);
 
@@ -724,12 +1172,15 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
         if (g_mutex_trylock(&mod->busy) == FALSE)
         {
             sat_log_log(SAT_LOG_LEVEL_WARN,
-                        _("%s: Previous cycle missed it's deadline."),
-                        __func__);
+                        _("%s: Previous cycle missed it's deadline "
+                          "(last cycle took %.1f msec)."),
+                        __func__, tick_prof_last(mod->prof));
 
             return TRUE;
         }
 
+        tick_prof_lap(mod->prof, PROF_QTH);
+
         mod->rtNow = get_current_daynum();
 
         /* Update time if throttle != 0 */
@@ -750,10 +1201,13 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
             update_header(mod);
         }
 
-        /* reset event update counter if is has expired or if we have moved
-           significantly */
-        if (mod->event_count == mod->event_timeout ||
-            qth_small_dist(mod->qth, mod->qth_event) > 1.0)
+        /* reset event update counter if we have moved significantly or if
+           the time has been set back before the last update; the latter at
+           most once per event_timeout. Otherwise the event queue updates
+           each satellite when its AOS or LOS has passed. */
+        if (qth_small_dist(mod->qth, mod->qth_event) > 1.0 ||
+            (mod->tmgCdnum < mod->event_time &&
+             mod->event_count >= mod->event_timeout))
         {
             mod->event_count = 0;       // will trigger find_aos() and find_los()
         }
@@ -762,25 +1216,29 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
         if (mod->event_count == 0)
         {
             qth_small_save(mod->qth, &(mod->qth_event));
+            gtk_sat_module_request_events(mod);
         }
 
+        /* observer frame shared by all satellites in this cycle */
+        predict_obs_frame(mod->qth, mod->tmgCdnum, &mod->obs_frame);
+        tick_prof_lap(mod->prof, PROF_HEADER);
+
         /* update satellite data */
-        if (mod->satellites != NULL)
-            g_hash_table_foreach(mod->satellites,
-                                 gtk_sat_module_update_sat, module);
+        gtk_sat_module_update_sats(mod);
+        tick_prof_lap(mod->prof, PROF_SATS);
+
+        /* the views read the snapshots, never the satellites themselves */
+        sat_snap_table_update(mod->snaps, mod->satellites, mod->qth);
+        tick_prof_lap(mod->prof, PROF_SNAPS);
 
         /* update children */
         for (i = 0; i < mod->nviews; i++)
         {
             child = GTK_WIDGET(g_slist_nth_data(mod->views, i));
-            update_child(child, mod->tmgCdnum);
+            update_child(child, mod->tmgCdnum, mod->snaps);
+            tick_prof_lap(mod->prof, PROF_VIEWS + i);
         }
 
-        /* update satellite data (it may have got out of sync during child updates) */
-        if (mod->satellites != NULL)
-            g_hash_table_foreach(mod->satellites,
-                                 gtk_sat_module_update_sat, module);
-
         /* update target if autotracking is enabled */
         if (mod->autotrack)
             update_autotrack(mod);
@@ -790,6 +1248,7 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
             gtk_rig_ctrl_update(GTK_RIG_CTRL(mod->rigctrl), mod->tmgCdnum);
         if (mod->rotctrl)
             gtk_rot_ctrl_update(GTK_ROT_CTRL(mod->rotctrl), mod->tmgCdnum);
+        tick_prof_lap(mod->prof, PROF_CTRL);
 
         /* check and update Sky at glance */
         /* FIXME: We should have some timeout counter to ensure that we don't
@@ -797,7 +1256,10 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
            however, the update does not seem to add any significant load even
            when running at max throttle */
         if (mod->skg)
+        {
             update_skg(mod);
+            tick_prof_lap(mod->prof, PROF_SKG);
+        }
 
         mod->event_count++;
 
@@ -813,6 +1275,12 @@ static gboolean gtk_sat_module_timeout_cb(gpointer module)
                 tmg_update_widgets(mod);
         }
 
+        /* propagate the next cycle while the views are redrawn */
+        gtk_sat_module_request_next(mod);
+
+        tick_prof_end(mod->prof);
+        gtk_sat_module_log_prof(mod);
+
         g_mutex_unlock(&mod->busy);
     }
 
@@ -830,6 +1298,52 @@ static void gtk_sat_module_popup_cb(GtkWidget * button, gpointer data)
     gtk_sat_module_popup(GTK_SAT_MODULE(data));
 }
 
+/**
+ * Load the extra ground stations of the module.
+ *
+ * The NETWORK key holds a list of .qth files which, together with the
+ * module QTH, are used for multi-station pass predictions. Files that
+ * can not be read are skipped.
+ */
+static void gtk_sat_module_load_network(GtkSatModule * module,
+                                        const gchar * confdir)
+{
+    gchar         **files;
+    gchar          *qthfile;
+    qth_t          *qth;
+    gsize           length;
+    gsize           i;
+
+    files = g_key_file_get_string_list(module->cfgdata,
+                                       MOD_CFG_GLOBAL_SECTION,
+                                       MOD_CFG_NETWORK_KEY, &length, NULL);
+    if (files == NULL)
+        return;
+
+    for (i = 0; i < length; i++)
+    {
+        qthfile = g_strconcat(confdir, G_DIR_SEPARATOR_S, files[i], NULL);
+        qth = g_new0(qth_t, 1);
+        qth_init(qth);
+
+        if (qth_data_read(qthfile, qth))
+        {
+            module->network = g_slist_append(module->network, qth);
+        }
+        else
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s: Can not load ground station %s"),
+                        __func__, files[i]);
+            qth_data_free(qth);
+        }
+
+        g_free(qthfile);
+    }
+
+    g_strfreev(files);
+}
+
 /**
  * Read moule configuration data.
  *
@@ -915,9 +1429,11 @@ static void gtk_sat_module_read_cfg_data(GtkSatModule * module,
     }
 
     g_free(buffer);
-    g_free(confdir);
     g_free(qthfile);
 
+    gtk_sat_module_load_network(module, confdir);
+    g_free(confdir);
+
     /* get timeout value */
     module->timeout = mod_cfg_get_int(module->cfgdata,
                                       MOD_CFG_GLOBAL_SECTION,
@@ -1062,12 +1578,13 @@ GtkWidget *gtk_sat_module_new(const gchar * cfgfile)
         (guint) floor(1000 / module->timeout);
 
     /* Event timeout
-       Update every minute FIXME: user configurable
+       Shortest interval between updates of all events when the time is
+       going backwards: one minute
      */
     module->event_timeout = module->timeout > 60000 ? 1 :
          (guint) floor(60000 / module->timeout);
     /* force update the first time */
-    module->event_count = module->event_timeout;
+    module->event_count = 0;
 
     butbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_box_pack_start(GTK_BOX(butbox),
@@ -1445,8 +1962,16 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
                 _("%s: Reloading satellites for module %s"),
                 __func__, module->name);
 
+    /* drop pending AOS/LOS calculations for the old satellites */
+    pass_service_cancel(module);
+    event_queue_clear(module->events);
+
     /* remove each element from the hash table, but keep the hash table */
     g_hash_table_foreach_remove(module->satellites, empty, NULL);
+    g_array_set_size(module->sgp4blocks, 0);
+    prop_worker_set_sats(module->propagator, NULL);
+    g_hash_table_remove_all(module->ephem);
+    g_hash_table_remove_all(module->snaps);
 
     /* reset event counter so that next AOS/LOS gets re-calculated */
     module->event_count = 0;
@@ -1461,6 +1986,10 @@ void gtk_sat_module_reload_sats(GtkSatModule * module)
         reload_sats_in_child(child, module);
     }
 
+    /* the passes in sky at a glance are for the old satellite data */
+    if (module->skg)
+        recreate_skg(module);
+
     /* FIXME: radio and rotator controller */
 
     /* unlock module */
@@ -1474,6 +2003,7 @@ void gtk_sat_module_select_sat(GtkSatModule * module, gint catnum)
     guint           i;
 
     module->target = catnum;
+    module->autotrack_next = 0.0;
 
     /* select satellite in each view */
     for (i = 0; i < module->nviews; i++)
@@ -7,6 +7,10 @@
 
 #include "qth-data.h"
 #include "gtk-sat-data.h"
+#include "event-queue.h"
+#include "prop-worker.h"
+#include "sat-snapshot.h"
+#include "tick-profiler.h"
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -68,6 +72,7 @@ struct _gtk_sat_module {
     guint           head_timeout;
     guint           event_count;
     guint           event_timeout;
+    gdouble         event_time; /*!< Daynum of last AOS/LOS update of all satellites */
 
     /* layout and children */
     guint          *grid;       /*!< The grid layout array [(type,left,right,top,bottom),...] */
@@ -76,8 +81,18 @@ struct _gtk_sat_module {
 
     GKeyFile       *cfgdata;    /*!< Configuration data. */
     qth_t          *qth;        /*!< QTH information. */
+    GSList         *network;    /*!< Extra ground stations (qth_t) */
     qth_small_t     qth_event;  /*!< QTH information for last AOS/LOS update. */
     GHashTable     *satellites; /*!< Satellites. */
+    GArray         *sgp4blocks; /*!< Near-earth satellites as sgp4_multi_t blocks */
+    obs_frame_t     obs_frame;  /*!< Observer frame for the current cycle */
+    GHashTable     *ephem;      /*!< Ephemeris caches keyed by sat_t pointer */
+    prop_worker_t  *propagator; /*!< Propagates the next cycle in the background */
+    GHashTable     *snaps;      /*!< Snapshots of the satellites (sat_snap_t) */
+    event_queue_t  *events;     /*!< Satellites by time of next AOS/LOS */
+    guint           cfg_notify; /*!< ID of the sat_cfg change notification */
+    tick_prof_t    *prof;       /*!< Timing of the phases of the cycle */
+    gint64          prof_logged;        /*!< Monotonic time of the last timing log */
 
     guint32         timeout;    /*!< Timeout value [msec] */
 
@@ -115,6 +130,7 @@ struct _gtk_sat_module {
     /* auto-tracking */
     gint            target;     /*!< Target satellite */
     gboolean        autotrack;  /*!< Whether automatic tracking is enabled */
+    gdouble         autotrack_next;     /*!< Daynum when the autotrack target has to be checked again */
 
     /* location structure */
     struct gps_data_t *gps_data;        /*!< GPSD data structure */
@@ -22,9 +22,11 @@
 
 #include "gtk-sat-popup-common.h"
 #include "orbit-tools.h"
+#include "pass-service.h"
 #include "predict-tools.h"
 #include "sat-cfg.h"
 #include "sat-pass-dialogs.h"
+#include "time-tools.h"
 
 
 void add_pass_menu_items(GtkWidget * menu, sat_t * sat, qth_t * qth,
@@ -178,55 +180,119 @@ void show_next_pass_dialog(sat_t * sat, qth_t * qth, gdouble tstamp,
 }
 
 
-void show_future_passes_dialog(sat_t * sat, qth_t * qth, gdouble tstamp,
-                               GtkWindow * toplevel)
+/** Pending future passes dialog. */
+typedef struct {
+    gchar          *satname;    /*!< Name of the satellite */
+    qth_t           qth;        /*!< Copy of the ground station */
+    GtkWindow      *toplevel;   /*!< Parent window, NULL if destroyed */
+} future_passes_t;
+
+/**
+ * Free a future passes request.
+ *
+ * Also used as weak reference notification of the window that shows the
+ * passes, since the dialogs refer to the name and QTH of the request.
+ */
+static void future_passes_free(gpointer data, GObject * window)
+{
+    future_passes_t *req = data;
+
+    (void)window;
+
+    g_free(req->satname);
+    g_free(req->qth.name);
+    g_free(req->qth.loc);
+    g_free(req->qth.desc);
+    g_free(req->qth.qra);
+    g_free(req->qth.wx);
+    g_free(req);
+}
+
+/**
+ * Show the future passes once they have been predicted.
+ *
+ * Called by the pass service in the main loop.
+ */
+static void future_passes_ready(sat_t * sat, GSList * passes, gpointer data)
 {
-    GSList         *passes = NULL;
+    future_passes_t *req = data;
     GtkWidget      *dialog;
 
-    /* check wheather sat actially has AOS */
-    if (has_aos(sat, qth))
-    {
+    (void)sat;
 
-        if (sat_cfg_get_bool(SAT_CFG_BOOL_PRED_USE_REAL_T0))
-        {
-            passes = get_next_passes(sat, qth,
-                                     sat_cfg_get_int
-                                     (SAT_CFG_INT_PRED_LOOK_AHEAD),
-                                     sat_cfg_get_int
-                                     (SAT_CFG_INT_PRED_NUM_PASS));
-        }
-        else
-        {
-            passes = get_passes(sat, qth, tstamp,
-                                sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD),
-                                sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_PASS));
+    if (req->toplevel != NULL)
+        g_object_remove_weak_pointer(G_OBJECT(req->toplevel),
+                                     (gpointer *) & req->toplevel);
 
-        }
+    if (passes != NULL)
+    {
+        dialog = show_passes(req->satname, &req->qth, passes,
+                             GTK_WIDGET(req->toplevel));
+
+        /* the pass details are opened on the parent window, so the
+           request is kept until that window is destroyed */
+        g_object_weak_ref(req->toplevel != NULL ?
+                          G_OBJECT(req->toplevel) : G_OBJECT(dialog),
+                          future_passes_free, req);
+    }
+    else
+    {
+        /* show dialog that there are no passes within time frame */
+        dialog = gtk_message_dialog_new(req->toplevel,
+                                        GTK_DIALOG_MODAL |
+                                        GTK_DIALOG_DESTROY_WITH_PARENT,
+                                        GTK_MESSAGE_INFO,
+                                        GTK_BUTTONS_OK,
+                                        _("Satellite %s has no passes\n"
+                                          "within the next %d days"),
+                                        req->satname,
+                                        sat_cfg_get_int
+                                        (SAT_CFG_INT_PRED_LOOK_AHEAD));
 
+        gtk_dialog_run(GTK_DIALOG(dialog));
+        gtk_widget_destroy(dialog);
 
-        if (passes != NULL)
-        {
-            show_passes(sat->nickname, qth, passes, GTK_WIDGET(toplevel));
-        }
-        else
-        {
-            /* show dialog that there are no passes within time frame */
-            dialog = gtk_message_dialog_new(toplevel,
-                                            GTK_DIALOG_MODAL |
-                                            GTK_DIALOG_DESTROY_WITH_PARENT,
-                                            GTK_MESSAGE_INFO,
-                                            GTK_BUTTONS_OK,
-                                            _("Satellite %s has no passes\n"
-                                              "within the next %d days"),
-                                            sat->nickname,
-                                            sat_cfg_get_int
-                                            (SAT_CFG_INT_PRED_LOOK_AHEAD));
+        future_passes_free(req, NULL);
+    }
+}
 
-            gtk_dialog_run(GTK_DIALOG(dialog));
-            gtk_widget_destroy(dialog);
-        }
+/**
+ * Show the future passes of a satellite.
+ *
+ * The passes are predicted by the pass service in the background and the
+ * dialog appears once they are ready. The request keeps a copy of the
+ * QTH, since the module may be closed before that.
+ */
+void show_future_passes_dialog(sat_t * sat, qth_t * qth, gdouble tstamp,
+                               GtkWindow * toplevel)
+{
+    future_passes_t *req;
 
+    /* check wheather sat actially has AOS */
+    if (has_aos(sat, qth))
+    {
+        if (sat_cfg_get_bool(SAT_CFG_BOOL_PRED_USE_REAL_T0))
+            tstamp = get_current_daynum();
+
+        req = g_new0(future_passes_t, 1);
+        req->satname = g_strdup(sat->nickname);
+        req->qth.name = g_strdup(qth->name);
+        req->qth.loc = g_strdup(qth->loc);
+        req->qth.desc = g_strdup(qth->desc);
+        req->qth.qra = g_strdup(qth->qra);
+        req->qth.wx = g_strdup(qth->wx);
+        req->qth.lat = qth->lat;
+        req->qth.lon = qth->lon;
+        req->qth.alt = qth->alt;
+        req->toplevel = toplevel;
+        if (toplevel != NULL)
+            g_object_add_weak_pointer(G_OBJECT(toplevel),
+                                      (gpointer *) & req->toplevel);
+
+        pass_service_get_passes(sat, qth, tstamp,
+                                sat_cfg_get_int(SAT_CFG_INT_PRED_LOOK_AHEAD),
+                                sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_PASS),
+                                future_passes_ready, req);
     }
     else
     {
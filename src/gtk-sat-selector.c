@@ -601,6 +601,7 @@ static void load_cat_file(GtkSatSelector * selector, const gchar * fname)
                                        -1);
                     g_free(sat.name);
                     g_free(sat.nickname);
+                    free_ephemeris(&sat);
                     num++;
                 }
 
@@ -771,6 +772,7 @@ static void create_and_fill_models(GtkSatSelector * selector)
 
                 g_free(sat.name);
                 g_free(sat.nickname);
+                free_ephemeris(&sat);
                 num++;
             }
 
@@ -35,6 +35,7 @@
 #include "sat-cfg.h"
 #include "sat-info.h"
 #include "sat-log.h"
+#include "sat-snapshot.h"
 #include "sat-vis.h"
 #include "sgpsdp/sgp4sdp4.h"
 #include "sat-pass-dialogs.h"
@@ -123,8 +124,9 @@ static void gtk_single_sat_init(GtkSingleSat * list)
     (void)list;
 }
 
-/* Update a field in the GtkSingleSat view. */
-static void update_field(GtkSingleSat * ssat, guint i)
+/* Update a field in the GtkSingleSat view from the snapshot of the cycle. */
+static void update_field(GtkSingleSat * ssat, guint i,
+                         const sat_snap_t * snap)
 {
     sat_t          *sat;
     gchar          *buff = NULL;
@@ -134,7 +136,6 @@ static void update_field(GtkSingleSat * ssat, guint i)
     gint            retcode;
     gchar          *fmtstr;
     gchar          *alstr;
-    sat_vis_t       vis;
 
     /* make some sanity checks */
     if (ssat->labels[i] == NULL)
@@ -159,10 +160,10 @@ static void update_field(GtkSingleSat * ssat, guint i)
     switch (i)
     {
     case SINGLE_SAT_FIELD_AZ:
-        buff = g_strdup_printf("%6.2f\302\260", sat->az);
+        buff = g_strdup_printf("%6.2f\302\260", snap->az);
         break;
     case SINGLE_SAT_FIELD_EL:
-        buff = g_strdup_printf("%6.2f\302\260", sat->el);
+        buff = g_strdup_printf("%6.2f\302\260", snap->el);
         break;
     case SINGLE_SAT_FIELD_DIR:
         if (sat->otype == ORBIT_TYPE_GEO)
@@ -173,12 +174,12 @@ static void update_field(GtkSingleSat * ssat, guint i)
         {
             buff = g_strdup("Decayed");
         }
-        else if (sat->range_rate > 0.0)
+        else if (snap->range_rate > 0.0)
         {
             /* Receeding */
             buff = g_strdup("Receeding");
         }
-        else if (sat->range_rate < 0.0)
+        else if (snap->range_rate < 0.0)
         {
             /* Approaching */
             buff = g_strdup("Approaching");
@@ -189,34 +190,34 @@ static void update_field(GtkSingleSat * ssat, guint i)
         }
         break;
     case SINGLE_SAT_FIELD_RA:
-        buff = g_strdup_printf("%6.2f\302\260", sat->ra);
+        buff = g_strdup_printf("%6.2f\302\260", snap->ra);
         break;
     case SINGLE_SAT_FIELD_DEC:
-        buff = g_strdup_printf("%6.2f\302\260", sat->dec);
+        buff = g_strdup_printf("%6.2f\302\260", snap->dec);
         break;
     case SINGLE_SAT_FIELD_RANGE:
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_IMPERIAL))
-            buff = g_strdup_printf("%.0f mi", KM_TO_MI(sat->range));
+            buff = g_strdup_printf("%.0f mi", KM_TO_MI(snap->range));
         else
-            buff = g_strdup_printf("%.0f km", sat->range);
+            buff = g_strdup_printf("%.0f km", snap->range);
         break;
     case SINGLE_SAT_FIELD_RANGE_RATE:
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_IMPERIAL))
-            buff = g_strdup_printf("%.3f mi/sec", KM_TO_MI(sat->range_rate));
+            buff = g_strdup_printf("%.3f mi/sec", KM_TO_MI(snap->range_rate));
         else
-            buff = g_strdup_printf("%.3f km/sec", sat->range_rate);
+            buff = g_strdup_printf("%.3f km/sec", snap->range_rate);
         break;
     case SINGLE_SAT_FIELD_NEXT_EVENT:
-        if (sat->aos > sat->los)
+        if (snap->aos > snap->los)
         {
             /* next event is LOS */
-            number = sat->los;
+            number = snap->los;
             alstr = g_strdup("LOS: ");
         }
         else
         {
             /* next event is AOS */
-            number = sat->aos;
+            number = snap->aos;
             alstr = g_strdup("AOS: ");
         }
         if (number > 0.0)
@@ -238,11 +239,11 @@ static void update_field(GtkSingleSat * ssat, guint i)
         g_free(alstr);
         break;
     case SINGLE_SAT_FIELD_AOS:
-        if (sat->aos > 0.0)
+        if (snap->aos > 0.0)
         {
             /* format the number */
             fmtstr = sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT);
-            daynum_to_str(tbuf, TIME_FORMAT_MAX_LENGTH, fmtstr, sat->aos);
+            daynum_to_str(tbuf, TIME_FORMAT_MAX_LENGTH, fmtstr, snap->aos);
             g_free(fmtstr);
             buff = g_strdup(tbuf);
         }
@@ -252,10 +253,10 @@ static void update_field(GtkSingleSat * ssat, guint i)
         }
         break;
     case SINGLE_SAT_FIELD_LOS:
-        if (sat->los > 0.0)
+        if (snap->los > 0.0)
         {
             fmtstr = sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT);
-            daynum_to_str(tbuf, TIME_FORMAT_MAX_LENGTH, fmtstr, sat->los);
+            daynum_to_str(tbuf, TIME_FORMAT_MAX_LENGTH, fmtstr, snap->los);
             g_free(fmtstr);
             buff = g_strdup(tbuf);
         }
@@ -265,7 +266,7 @@ static void update_field(GtkSingleSat * ssat, guint i)
         }
         break;
     case SINGLE_SAT_FIELD_LAT:
-        number = sat->ssplat;
+        number = snap->ssplat;
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_NSEW))
         {
             if (number < 0.00)
@@ -281,7 +282,7 @@ static void update_field(GtkSingleSat * ssat, guint i)
         buff = g_strdup_printf("%.2f\302\260%c", number, hmf);
         break;
     case SINGLE_SAT_FIELD_LON:
-        number = sat->ssplon;
+        number = snap->ssplon;
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_NSEW))
         {
             if (number < 0.00)
@@ -299,7 +300,7 @@ static void update_field(GtkSingleSat * ssat, guint i)
     case SINGLE_SAT_FIELD_SSP:
         /* SSP locator */
         buff = g_try_malloc(7);
-        retcode = longlat2locator(sat->ssplon, sat->ssplat, buff, 3);
+        retcode = longlat2locator(snap->ssplon, snap->ssplat, buff, 3);
         if (retcode == RIG_OK)
         {
             buff[6] = '\0';
@@ -314,49 +315,48 @@ static void update_field(GtkSingleSat * ssat, guint i)
     case SINGLE_SAT_FIELD_FOOTPRINT:
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_IMPERIAL))
         {
-            buff = g_strdup_printf("%.0f mi", KM_TO_MI(sat->footprint));
+            buff = g_strdup_printf("%.0f mi", KM_TO_MI(snap->footprint));
         }
         else
         {
-            buff = g_strdup_printf("%.0f km", sat->footprint);
+            buff = g_strdup_printf("%.0f km", snap->footprint);
         }
         break;
     case SINGLE_SAT_FIELD_ALT:
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_IMPERIAL))
-            buff = g_strdup_printf("%.0f mi", KM_TO_MI(sat->alt));
+            buff = g_strdup_printf("%.0f mi", KM_TO_MI(snap->alt));
         else
-            buff = g_strdup_printf("%.0f km", sat->alt);
+            buff = g_strdup_printf("%.0f km", snap->alt);
         break;
     case SINGLE_SAT_FIELD_VEL:
         if (sat_cfg_get_bool(SAT_CFG_BOOL_USE_IMPERIAL))
-            buff = g_strdup_printf("%.3f mi/sec", KM_TO_MI(sat->velo));
+            buff = g_strdup_printf("%.3f mi/sec", KM_TO_MI(snap->velo));
         else
-            buff = g_strdup_printf("%.3f km/sec", sat->velo);
+            buff = g_strdup_printf("%.3f km/sec", snap->velo);
         break;
     case SINGLE_SAT_FIELD_DOPPLER:
-        number = -100.0e06 * (sat->range_rate / 299792.4580);   // Hz
+        number = -100.0e06 * (snap->range_rate / 299792.4580);   // Hz
         buff = g_strdup_printf("%.0f Hz", number);
         break;
     case SINGLE_SAT_FIELD_LOSS:
-        number = 72.4 + 20.0 * log10(sat->range);       // dB
+        number = 72.4 + 20.0 * log10(snap->range);       // dB
         buff = g_strdup_printf("%.2f dB", number);
         break;
     case SINGLE_SAT_FIELD_DELAY:
-        number = sat->range / 299.7924580;      // msec 
+        number = snap->range / 299.7924580;      // msec 
         buff = g_strdup_printf("%.2f msec", number);
         break;
     case SINGLE_SAT_FIELD_MA:
-        buff = g_strdup_printf("%.2f\302\260", sat->ma);
+        buff = g_strdup_printf("%.2f\302\260", snap->ma);
         break;
     case SINGLE_SAT_FIELD_PHASE:
-        buff = g_strdup_printf("%.2f\302\260", sat->phase);
+        buff = g_strdup_printf("%.2f\302\260", snap->phase);
         break;
     case SINGLE_SAT_FIELD_ORBIT:
-        buff = g_strdup_printf("%ld", sat->orbit);
+        buff = g_strdup_printf("%ld", snap->orbit);
         break;
     case SINGLE_SAT_FIELD_VISIBILITY:
-        vis = get_sat_vis(sat, ssat->qth, sat->jul_utc);
-        buff = vis_to_str(vis);
+        buff = vis_to_str(snap->vis);
         break;
     default:
         sat_log_log(SAT_LOG_LEVEL_ERROR,
@@ -389,52 +389,6 @@ static void store_sats(gpointer key, gpointer value, gpointer user_data)
                                              (GCompareFunc) sat_name_compare);
 }
 
-static void Calculate_RADec(sat_t * sat, qth_t * qth, obs_astro_t * obs_set)
-{
-    /* Reference:  Methods of Orbit Determination by  */
-    /*                Pedro Ramon Escobal, pp. 401-402 */
-
-    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
-        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
-        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
-    geodetic_t      geodetic;
-
-    geodetic.lon = qth->lon * de2ra;
-    geodetic.lat = qth->lat * de2ra;
-    geodetic.alt = qth->alt / 1000.0;
-    geodetic.theta = 0;
-
-    az = sat->az * de2ra;
-    el = sat->el * de2ra;
-    phi = geodetic.lat;
-    theta = FMod2p(ThetaG_JD(sat->jul_utc) + geodetic.lon);
-    sin_theta = sin(theta);
-    cos_theta = cos(theta);
-    sin_phi = sin(phi);
-    cos_phi = cos(phi);
-    Lxh = -cos(az) * cos(el);
-    Lyh = sin(az) * cos(el);
-    Lzh = sin(el);
-    Sx = sin_phi * cos_theta;
-    Ex = -sin_theta;
-    Zx = cos_theta * cos_phi;
-    Sy = sin_phi * sin_theta;
-    Ey = cos_theta;
-    Zy = sin_theta * cos_phi;
-    Sz = -cos_phi;
-    Ez = 0;
-    Zz = sin_phi;
-    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
-    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
-    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
-    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
-    cos_delta = sqrt(1 - Sqr(Lz));
-    sin_alpha = Ly / cos_delta;
-    cos_alpha = Lx / cos_delta;
-    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
-    obs_set->ra = FMod2p(obs_set->ra);
-}
-
 static void select_satellite(GtkWidget * menuitem, gpointer data)
 {
     GtkSingleSat   *ssat = GTK_SINGLE_SAT(data);
@@ -629,6 +583,9 @@ void gtk_single_sat_select_sat(GtkWidget * single_sat, gint catnum)
 void gtk_single_sat_update(GtkWidget * widget)
 {
     GtkSingleSat   *ssat = GTK_SINGLE_SAT(widget);
+    sat_t          *sat;
+    const sat_snap_t *snap;
+    sat_snap_t      local;
     guint           i;
 
     /* first, do some sanity checks */
@@ -648,24 +605,23 @@ void gtk_single_sat_update(GtkWidget * widget)
     }
     else
     {
-        /* we calculate here to avoid double calc */
-        if ((ssat->flags & SINGLE_SAT_FLAG_RA) ||
-            (ssat->flags & SINGLE_SAT_FLAG_DEC))
-        {
-            obs_astro_t     astro;
-            sat_t          *sat =
-                SAT(g_slist_nth_data(ssat->sats, ssat->selected));
+        /* the fields are filled from the snapshot of this cycle */
+        sat = SAT(g_slist_nth_data(ssat->sats, ssat->selected));
+        if (sat == NULL)
+            return;
 
-            Calculate_RADec(sat, ssat->qth, &astro);
-            sat->ra = Degrees(astro.ra);
-            sat->dec = Degrees(astro.dec);
+        snap = sat_snap_lookup(ssat->snaps, sat->tle.catnr);
+        if (snap == NULL)
+        {
+            sat_snap_take(&local, sat, ssat->qth);
+            snap = &local;
         }
 
         /* update visible fields one by one */
         for (i = 0; i < SINGLE_SAT_FIELD_NUMBER; i++)
         {
             if (ssat->flags & (1 << i))
-                update_field(ssat, i);
+                update_field(ssat, i, snap);
 
         }
         ssat->counter = 1;
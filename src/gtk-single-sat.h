@@ -105,6 +105,7 @@ struct _gtk_single_sat {
     guint           selected;   /*!< index of selected sat. */
 
     gdouble         tstamp;     /*!< time stamp of calculations; update by GtkSatModule */
+    GHashTable     *snaps;      /*!< snapshots of the satellites; update by GtkSatModule */
 
     void            (*update) (GtkWidget * widget);     /*!< update function */
 };
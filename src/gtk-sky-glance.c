@@ -52,6 +52,7 @@
 #include "gtk-sat-data.h"
 #include "gtk-sky-glance.h"
 #include "mod-cfg-get-param.h"
+#include "pass-service.h"
 #include "predict-tools.h"
 #include "sat-pass-dialogs.h"
 #include "sat-cfg.h"
@@ -66,6 +67,7 @@
 #define SKG_MARGIN              15
 #define SKG_FOOTER              50
 #define SKG_CURSOR_WIDTH        0.5
+#define SKG_MAX_PASSES          10
 
 static GtkVBoxClass *parent_class = NULL;
 
@@ -101,6 +103,9 @@ static void gtk_sky_glance_destroy(GtkWidget * widget)
     sky_pass_t     *skypass;
     guint           i, n;
 
+    /* drop the passes that are still being predicted */
+    pass_service_cancel(widget);
+
     /* free passes */
     /* FIXME: TBC whether this is enough */
     if (GTK_SKY_GLANCE(widget)->passes != NULL)
@@ -239,6 +244,7 @@ static void size_allocate_cb(GtkWidget * widget, GtkAllocation * allocation,
     gdouble         xh, xm;
     sky_pass_t     *skp;
     gdouble         x, y, w, h;
+    gchar           buff[3];
 
     if (gtk_widget_get_realized(widget))
     {
@@ -305,8 +311,11 @@ static void size_allocate_cb(GtkWidget * widget, GtkAllocation * allocation,
             g_object_set(obj, "points", pts, NULL);
             goo_canvas_points_unref(pts);
 
+            /* the label changes when the time axis has been moved */
+            daynum_to_str(buff, 3, "%H", th);
             obj = g_slist_nth_data(skg->labels, i);
             g_object_set(obj,
+                         "text", buff,
                          "x", (gdouble) xh,
                          "y", (gdouble) (skg->h + 12), NULL);
 
@@ -424,6 +433,8 @@ static gboolean on_button_release(GooCanvasItem * item, GooCanvasItem * target,
     GtkSkyGlance   *skg = GTK_SKY_GLANCE(data);
     pass_t         *pass;
     pass_t         *new_pass;
+    sat_t          *sat;
+    gint            catnum;
 
     (void)target;
 
@@ -442,7 +453,14 @@ static gboolean on_button_release(GooCanvasItem * item, GooCanvasItem * target,
     {
         /* LEFT button released */
     case 1:
-        new_pass = copy_pass(pass);
+        /* the passes are summaries; sample the details now */
+        catnum = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(item), "catnum"));
+        sat = SAT(g_hash_table_lookup(skg->sats, &catnum));
+        if (sat != NULL)
+            new_pass = get_pass_details(sat, skg->qth, pass);
+        else
+            new_pass = copy_pass(pass);
+
         sat_log_log(SAT_LOG_LEVEL_ERROR,
                     _
                     ("%s::%s: Showing pass details for %s - we may have a memory leak here"),
@@ -644,32 +662,140 @@ static void get_colors(guint i, guint * bcol, guint * fcol)
     *fcol = (tmp * 0x100) | 0xA0;
 }
 
+/** Get the label of a satellite or NULL if the satellite has no row. */
+static GooCanvasItem *get_sat_label(GtkSkyGlance * skg, guint catnum)
+{
+    GSList         *node;
+
+    for (node = skg->satlab; node != NULL; node = node->next)
+    {
+        if (GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(node->data),
+                                               "catnum")) == catnum)
+            return GOO_CANVAS_ITEM(node->data);
+    }
+
+    return NULL;
+}
+
+/** Check whether a pass overlaps one of the passes already shown. */
+static gboolean has_pass(GtkSkyGlance * skg, guint catnum, pass_t * pass)
+{
+    GSList         *node;
+    sky_pass_t     *skypass;
+
+    for (node = skg->passes; node != NULL; node = node->next)
+    {
+        skypass = SKY_PASS_T(node->data);
+        if (skypass->catnum == catnum &&
+            pass->aos < skypass->pass->los && pass->los > skypass->pass->aos)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/** Check whether a satellite has any passes shown. */
+static gboolean has_sat_passes(GtkSkyGlance * skg, guint catnum)
+{
+    GSList         *node;
+
+    for (node = skg->passes; node != NULL; node = node->next)
+        if (SKY_PASS_T(node->data)->catnum == catnum)
+            return TRUE;
+
+    return FALSE;
+}
+
+/** Remove a pass from the canvas and free it. */
+static void remove_sky_pass(sky_pass_t * skypass)
+{
+    goo_canvas_item_remove(skypass->box);
+    free_pass(skypass->pass);
+    g_free(skypass);
+}
+
+/**
+ * Remove the passes that have ended before the start of the time axis.
+ *
+ * The label of a satellite is removed together with its last pass.
+ */
+static void remove_old_passes(GtkSkyGlance * skg)
+{
+    GSList         *node;
+    GSList         *next;
+    sky_pass_t     *skypass;
+    guint           catnum;
+
+    for (node = skg->passes; node != NULL; node = next)
+    {
+        next = node->next;
+        skypass = SKY_PASS_T(node->data);
+        if (skypass->pass->los < skg->ts)
+        {
+            skg->passes = g_slist_delete_link(skg->passes, node);
+            remove_sky_pass(skypass);
+        }
+    }
+
+    for (node = skg->satlab; node != NULL; node = next)
+    {
+        next = node->next;
+        catnum = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(node->data),
+                                                    "catnum"));
+        if (!has_sat_passes(skg, catnum))
+        {
+            goo_canvas_item_remove(GOO_CANVAS_ITEM(node->data));
+            skg->satlab = g_slist_delete_link(skg->satlab, node);
+        }
+    }
+}
+
+/** Remove all passes and labels from the canvas. */
+static void remove_all_passes(GtkSkyGlance * skg)
+{
+    GSList         *node;
+
+    for (node = skg->passes; node != NULL; node = node->next)
+        remove_sky_pass(SKY_PASS_T(node->data));
+    g_slist_free(skg->passes);
+    skg->passes = NULL;
+
+    for (node = skg->satlab; node != NULL; node = node->next)
+        goo_canvas_item_remove(GOO_CANVAS_ITEM(node->data));
+    g_slist_free(skg->satlab);
+    skg->satlab = NULL;
+
+    skg->satcnt = 0;
+}
+
 /**
  * Create canvas items for a satellite
  *
- * @param key Pointer to the hash key (catnum of sat)
- * @param value Pointer to the current satellite.
+ * @param sat Pointer to the satellite.
+ * @param passes The passes of the satellite.
  * @param data Pointer to the GtkSkyGlance object.
  *
- * This function is called by g_hash_table_foreach with each satellite in
- * the satellite hash table. It gets the passes for the current satellite
- * and creates the corresponding canvas items.
+ * This function is called by the pass service in the main loop when the
+ * passes of a satellite have been predicted. It creates the corresponding
+ * canvas items and updates the layout.
+ *
+ * The passes are added to the row of the satellite, which is created if
+ * the satellite does not have one yet. Passes that are outside the time
+ * axis or already shown are dropped.
  */
-static void create_sat(gpointer key, gpointer value, gpointer data)
+static void create_sat_passes(sat_t * sat, GSList * passes, gpointer data)
 {
-    sat_t          *sat = SAT(value);
     GtkSkyGlance   *skg = GTK_SKY_GLANCE(data);
-    GSList         *passes = NULL;
     gdouble         maxdt;
-    guint           i, n;
-    pass_t         *tmppass = NULL;
+    guint           n = 0;
+    GSList         *node;
+    GSList         *last = NULL;        /* last pass of sat in skg->passes */
+    pass_t         *pass;
     sky_pass_t     *skypass;
     guint           bcol, fcol; /* colors */
     GooCanvasItem  *root;
     GooCanvasItem  *label;
 
-    (void)key;
-
     /* tooltips vars */
     gchar          *tooltip;    /* the complete tooltips string */
     gchar           aosstr[100];        /* AOS time string */
@@ -678,88 +804,239 @@ static void create_sat(gpointer key, gpointer value, gpointer data)
 
     /* get canvas root */
     root = goo_canvas_get_root_item(GOO_CANVAS(skg->canvas));
-    get_colors(skg->satcnt++, &bcol, &fcol);
     maxdt = skg->te - skg->ts;
 
-    /* get passes for satellite */
-    passes = get_passes(sat, skg->qth, skg->ts, maxdt, 10);
-    n = g_slist_length(passes);
-    sat_log_log(SAT_LOG_LEVEL_DEBUG,
-                _("%s:%d: %s has %d passes within %.4f days\n"),
-                __FILE__, __LINE__, sat->nickname, n, maxdt);
+    /* use the colours of the existing row or those of a new one */
+    label = get_sat_label(skg, sat->tle.catnr);
+    if (label != NULL)
+    {
+        bcol = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(label), "bcol"));
+        fcol = GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(label), "fcol"));
+
+        for (node = skg->passes; node != NULL; node = node->next)
+            if (SKY_PASS_T(node->data)->catnum == (guint) sat->tle.catnr)
+                last = node;
+    }
+    else
+    {
+        get_colors(skg->satcnt, &bcol, &fcol);
+    }
 
     /* add sky_pass_t items to skg->passes */
-    if (passes != NULL)
+    for (node = passes; node != NULL; node = node->next)
     {
-        /* add pass items */
-        for (i = 0; i < n; i++)
+        pass = PASS(node->data);
+
+        if (pass->los < skg->ts || pass->aos > skg->te ||
+            has_pass(skg, sat->tle.catnr, pass))
         {
-            skypass = g_try_new(sky_pass_t, 1);
-            if (skypass == NULL)
-            {
-                sat_log_log(SAT_LOG_LEVEL_ERROR,
-                            _("%s:%s: Could not allocate memory."),
-                            __FILE__, __func__);
-                continue;
-            }
+            free_pass(pass);
+            continue;
+        }
 
-            /* create pass structure items */
-            skypass->catnum = sat->tle.catnr;
-            tmppass = (pass_t *) g_slist_nth_data(passes, i);
-            skypass->pass = copy_pass(tmppass);
-
-            daynum_to_str(aosstr, TIME_FORMAT_MAX_LENGTH,
-                          sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
-                          skypass->pass->aos);
-            daynum_to_str(losstr, TIME_FORMAT_MAX_LENGTH,
-                          sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
-                          skypass->pass->los);
-            daynum_to_str(tcastr, TIME_FORMAT_MAX_LENGTH,
-                          sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
-                          skypass->pass->tca);
-
-            /* box tooltip will contain pass summary */
-            tooltip = g_strdup_printf(_("<b>%s</b>\n"
-                                      "AOS: %s  Az:%.0f\302\260\n"
-                                      "TCA: %s  Az:%.0f\302\260  El:%.1f\302\260\n"
-                                      "LOS: %s  Az:%.0f\302\260\n"
-                                      "<i>Click for details</i>"),
-                                      skypass->pass->satname,
-                                      aosstr, skypass->pass->aos_az,
-                                      tcastr, skypass->pass->maxel_az,
-                                      skypass->pass->max_el, losstr,
-                                      skypass->pass->los_az);
-
-            skypass->box = goo_canvas_rect_new(root, 10, 10, 20, 20,
-                                               "stroke-color-rgba", bcol,
-                                               "fill-color-rgba", fcol,
-                                               "line-width", 1.0,
-                                               "antialias",
-                                               CAIRO_ANTIALIAS_NONE, "tooltip",
-                                               tooltip, "can-focus", TRUE,
-                                               NULL);
-            g_free(tooltip);
+        skypass = g_try_new(sky_pass_t, 1);
+        if (skypass == NULL)
+        {
+            sat_log_log(SAT_LOG_LEVEL_ERROR,
+                        _("%s:%s: Could not allocate memory."),
+                        __FILE__, __func__);
+            free_pass(pass);
+            continue;
+        }
 
-            /* store this pass in list */
+        /* create pass structure items */
+        skypass->catnum = sat->tle.catnr;
+        skypass->pass = pass;
+
+        daynum_to_str(aosstr, TIME_FORMAT_MAX_LENGTH,
+                      sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
+                      skypass->pass->aos);
+        daynum_to_str(losstr, TIME_FORMAT_MAX_LENGTH,
+                      sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
+                      skypass->pass->los);
+        daynum_to_str(tcastr, TIME_FORMAT_MAX_LENGTH,
+                      sat_cfg_get_str(SAT_CFG_STR_TIME_FORMAT),
+                      skypass->pass->tca);
+
+        /* box tooltip will contain pass summary */
+        tooltip = g_strdup_printf(_("<b>%s</b>\n"
+                                  "AOS: %s  Az:%.0f\302\260\n"
+                                  "TCA: %s  Az:%.0f\302\260  El:%.1f\302\260\n"
+                                  "LOS: %s  Az:%.0f\302\260\n"
+                                  "<i>Click for details</i>"),
+                                  skypass->pass->satname,
+                                  aosstr, skypass->pass->aos_az,
+                                  tcastr, skypass->pass->maxel_az,
+                                  skypass->pass->max_el, losstr,
+                                  skypass->pass->los_az);
+
+        skypass->box = goo_canvas_rect_new(root, 10, 10, 20, 20,
+                                           "stroke-color-rgba", bcol,
+                                           "fill-color-rgba", fcol,
+                                           "line-width", 1.0,
+                                           "antialias",
+                                           CAIRO_ANTIALIAS_NONE, "tooltip",
+                                           tooltip, "can-focus", TRUE, NULL);
+        g_free(tooltip);
+
+        /* store this pass in list; the passes of a satellite must be
+           kept together since each satellite has its own row */
+        if (last == NULL)
+        {
             skg->passes = g_slist_append(skg->passes, skypass);
+            last = g_slist_last(skg->passes);
+        }
+        else
+        {
+            skg->passes = g_slist_insert_before(skg->passes, last->next,
+                                                skypass);
+            last = last->next;
+        }
 
-            /* store a pointer to the pass data in the GooCanvasItem so that we
-               can access it later during various events, e.g mouse click */
-            g_object_set_data(G_OBJECT(skypass->box), "pass", skypass->pass);
+        /* store a pointer to the pass data in the GooCanvasItem so that we
+           can access it later during various events, e.g mouse click */
+        g_object_set_data(G_OBJECT(skypass->box), "pass", skypass->pass);
+        g_object_set_data(G_OBJECT(skypass->box), "catnum",
+                          GINT_TO_POINTER(sat->tle.catnr));
 
-            g_signal_connect(skypass->box, "button_release_event",
-                             (GCallback) on_button_release, skg);
-        }
+        g_signal_connect(skypass->box, "button_release_event",
+                         (GCallback) on_button_release, skg);
+        n++;
+    }
 
-        free_passes(passes);
+    g_slist_free(passes);
 
-        /* add satellite label */
+    sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                _("%s:%d: %s has %d new passes within %.4f days\n"),
+                __FILE__, __LINE__, sat->nickname, n, maxdt);
+
+    /* add satellite label */
+    if (n > 0 && label == NULL)
+    {
+        skg->satcnt++;
         label = goo_canvas_text_new(root, sat->nickname,
                                     5, 0, -1, GOO_CANVAS_ANCHOR_W,
                                     "font", "Sans 8",
                                     "fill-color-rgba", bcol, NULL);
+        g_object_set_data(G_OBJECT(label), "catnum",
+                          GUINT_TO_POINTER(sat->tle.catnr));
+        g_object_set_data(G_OBJECT(label), "bcol", GUINT_TO_POINTER(bcol));
+        g_object_set_data(G_OBJECT(label), "fcol", GUINT_TO_POINTER(fcol));
         skg->satlab = g_slist_append(skg->satlab, label);
     }
+
+    /* the layout is also done when the canvas is realized */
+    if (gtk_widget_get_realized(skg->canvas))
+        on_canvas_realized(skg->canvas, skg);
+}
+
+/**
+ * Request the passes of a satellite.
+ *
+ * @param key Pointer to the hash key (catnum of sat)
+ * @param value Pointer to the current satellite.
+ * @param data Pointer to the GtkSkyGlance object.
+ *
+ * This function is called by g_hash_table_foreach with each satellite in
+ * the satellite hash table. The passes are predicted in the background
+ * and handed to create_sat_passes.
+ */
+static void create_sat(gpointer key, gpointer value, gpointer data)
+{
+    GtkSkyGlance   *skg = GTK_SKY_GLANCE(data);
+
+    (void)key;
+
+    pass_service_get_summaries(SAT(value), skg->qth, skg->ts,
+                               skg->te - skg->ts, SKG_MAX_PASSES,
+                               create_sat_passes, skg);
+}
+
+/**
+ * Request the passes entering the time axis of a satellite.
+ *
+ * @param skg The GtkSkyGlance widget, with the new time axis.
+ * @param sat The satellite.
+ * @param te The end of the old time axis.
+ *
+ * Only the passes after te are predicted, unless the satellite already had
+ * SKG_MAX_PASSES passes, in which case the prediction continues after its
+ * last pass.
+ */
+static void extend_sat(GtkSkyGlance * skg, sat_t * sat, gdouble te)
+{
+    GSList         *node;
+    sky_pass_t     *skypass;
+    guint           num = 0;    /* passes of sat */
+    guint           keep = 0;   /* passes of sat on the new time axis */
+    gdouble         los = 0.0;  /* LOS of the last pass of sat */
+    gdouble         from = te;
+
+    for (node = skg->passes; node != NULL; node = node->next)
+    {
+        skypass = SKY_PASS_T(node->data);
+        if (skypass->catnum != (guint) sat->tle.catnr)
+            continue;
+
+        num++;
+        if (skypass->pass->los >= skg->ts)
+            keep++;
+        if (skypass->pass->los > los)
+            los = skypass->pass->los;
+    }
+
+    if (num >= SKG_MAX_PASSES)
+        from = los + 0.014;     // +20 min as in get_passes
+
+    if (from < skg->te && keep < SKG_MAX_PASSES)
+        pass_service_get_summaries(sat, skg->qth, from, skg->te - from,
+                                   SKG_MAX_PASSES - keep, create_sat_passes,
+                                   skg);
+}
+
+/**
+ * Move the time axis of the GtkSkyGlance widget.
+ *
+ * @param widget The GtkSkyGlance widget.
+ * @param ts The new start time of the time axis.
+ *
+ * If the new time axis overlaps the current one, the passes that have ended
+ * before ts are removed and only the passes entering at the right edge are
+ * predicted. Otherwise all passes are predicted again.
+ */
+void gtk_sky_glance_set_time(GtkWidget * widget, gdouble ts)
+{
+    GtkSkyGlance   *skg = GTK_SKY_GLANCE(widget);
+    GHashTableIter  iter;
+    gpointer        value;
+    gdouble         te = skg->te;
+    gboolean        slide = (ts >= skg->ts && ts < skg->te);
+
+    if (!slide)
+    {
+        pass_service_cancel(skg);
+        remove_all_passes(skg);
+    }
+
+    skg->te = ts + (skg->te - skg->ts);
+    skg->ts = ts;
+
+    if (slide)
+    {
+        g_hash_table_iter_init(&iter, skg->sats);
+        while (g_hash_table_iter_next(&iter, NULL, &value))
+            extend_sat(skg, SAT(value), te);
+
+        remove_old_passes(skg);
+    }
+    else
+    {
+        g_hash_table_foreach(skg->sats, create_sat, skg);
+    }
+
+    /* move the remaining items and the time ticks */
+    if (gtk_widget_get_realized(skg->canvas))
+        on_canvas_realized(skg->canvas, skg);
 }
 
 /**
@@ -113,6 +113,7 @@ struct _GtkSkyGlanceClass {
 
 GType           gtk_sky_glance_get_type(void);
 GtkWidget      *gtk_sky_glance_new(GHashTable * sats, qth_t * qth, gdouble ts);
+void            gtk_sky_glance_set_time(GtkWidget * widget, gdouble ts);
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
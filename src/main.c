@@ -29,12 +29,14 @@
 #include <winsock2.h>
 #endif
 
+#include "batch-predict.h"
 #include "compat.h"
 #include "gtk-sat-selector.h"
 #include "gui.h"
 #include "first-time.h"
 #include "tle-update.h"
 #include "mod-mgr.h"
+#include "pass-service.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
 
@@ -100,6 +102,11 @@ int main(int argc, char *argv[])
     bind_textdomain_codeset(PACKAGE, "UTF-8");
     textdomain(PACKAGE);
 #endif
+
+    /* headless prediction; must be checked before GTK needs a display */
+    if (batch_predict_requested(argc, argv))
+        return batch_predict_run(argc, argv);
+
     gtk_init(&argc, &argv);
 
     context = g_option_context_new("");
@@ -152,6 +159,7 @@ int main(int argc, char *argv[])
 
     gtk_main();
 
+    pass_service_shutdown();
     g_option_context_free(context);
 
     sat_cfg_save();
@@ -145,6 +145,7 @@ static void add_selected_sat(GtkListStore * store, gint catnum)
                            GTK_SAT_SELECTOR_COL_EPOCH, sat.jul_epoch, -1);
         g_free(sat.name);
         g_free(sat.nickname);
+        free_ephemeris(&sat);
     }
 }
 
@@ -61,6 +61,7 @@
 #include "gtk-sat-module-popup.h"
 #include "mod-cfg.h"
 #include "mod-mgr.h"
+#include "pass-cache.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
 
@@ -581,6 +582,9 @@ void mod_mgr_reload_sats()
         return;
     }
 
+    /* cached passes are of no use with new TLE data */
+    pass_cache_flush();
+
     num = g_slist_length(modules);
     if (num == 0)
     {
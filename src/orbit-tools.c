@@ -169,3 +169,112 @@ has_aos        (sat_t *sat, qth_t *qth)
      }
      return retcode;
 }
+
+
+/* pass window prefilter: step of the observer under the orbital plane and
+   margin for the perturbations neglected by the prefilter [rad] */
+#define PLANE_STEP   (0.25 * de2ra)
+#define PLANE_MARGIN (2.0 * de2ra)
+
+
+/** \brief Earth central angle covered by a satellite.
+ *  \param alt The altitude of the satellite [km].
+ *  \param el The minimum elevation [rad].
+ *  \return The maximum angle between the observer and the sub-satellite
+ *          point at which the satellite is at or above el [rad].
+ */
+static gdouble
+coverage_angle (gdouble alt, gdouble el)
+{
+     return acos (xkmper * cos (el) / (xkmper + alt)) - el;
+}
+
+
+/** \brief Skip the time in which a satellite cannot make a pass.
+ *  \param sat Pointer to satellite data.
+ *  \param qth Pointer to the observer.
+ *  \param t The start time.
+ *  \param tmax The end time, 0 for no limit.
+ *  \param min_el The minimum elevation of a pass [deg].
+ *  \return The earliest time from t at which a pass that reaches min_el
+ *          may be in progress, or 0.0 if there is none before tmax.
+ *
+ * A satellite can only be seen above min_el while the observer is within
+ * the coverage angle of the orbital plane. The Earth turns under the plane
+ * about once a day, so the observer is close to it in two windows per day
+ * and a near-earth satellite cannot make a pass in between. The orbital
+ * plane is taken from the mean elements with the secular J2 regression of
+ * the node and the coverage angle from the altitude at apogee, with a
+ * margin for everything else. The returned time is the start of the window
+ * for a pass at zero elevation, so that the AOS of a pass is not skipped.
+ *
+ * Deep space satellites cover too much of the Earth for this to pay off;
+ * for them t is returned.
+ */
+gdouble
+next_pass_window (sat_t *sat, qth_t *qth, gdouble t, gdouble tmax,
+                  gdouble min_el)
+{
+     gdouble a, p, apogee, incl, lat;
+     gdouble lam0, lam;      /* coverage angles at 0 and min_el */
+     gdouble cl, sl;         /* the distance of the observer from the plane
+                                is asin (cl * sin (psi) + sl) */
+     gdouble nodot, rate;    /* node regression and rate of psi [rad/day] */
+     gdouble psi, step;
+     gdouble t1 = t;
+     gint    n, nmax;
+
+     if ((sat->flags & DEEP_SPACE_EPHEM_FLAG) || sat->tle.xno <= 0.0)
+          return t;
+
+     /* semi-major axis [earth radii], semi-latus rectum and apogee [km] */
+     a = pow (xke / sat->tle.xno, tothrd);
+     p = a * (1.0 - sat->tle.eo * sat->tle.eo);
+     apogee = xkmper * (a * (1.0 + sat->tle.eo) - 1.0);
+
+     lam0 = coverage_angle (apogee, 0.0) + PLANE_MARGIN;
+     lam = coverage_angle (apogee, MAX (min_el, 0.0) * de2ra) + PLANE_MARGIN;
+     if (lam0 >= pio2)
+          return t;
+     lam0 = sin (lam0);
+     lam = sin (lam);
+
+     incl = sat->tle.xincl;
+     lat = qth->lat * de2ra;
+     cl = cos (lat) * sin (incl);
+     sl = sin (lat) * cos (incl);
+
+     /* the observer never gets close enough to the plane */
+     if (sl - cl > lam || sl + cl < -lam)
+          return 0.0;
+
+     nodot = -3.0 * ck2 * sat->tle.xno * cos (incl) / (p * p) * xmnpda;
+     rate = twopi * omega_E - nodot;
+     step = PLANE_STEP / rate;
+
+     /* psi is the node measured from the meridian of the observer */
+     psi = sat->tle.xnodeo + nodot * (t - sat->jul_epoch) -
+          ThetaG_JD (t) - qth->lon * de2ra;
+
+     /* first time at which a pass may reach min_el; the observer gets
+        close to the plane within a day. The steps repeat after a full
+        turn, and a band narrower than a step may fall between them; in
+        that case the window is not known and t is returned */
+     nmax = (gint) (twopi / PLANE_STEP) + 1;
+     for (n = 0; fabs (cl * sin (psi) + sl) > lam; n++) {
+          if (n >= nmax)
+               return t1;
+          t += step;
+          psi -= PLANE_STEP;
+          if (tmax > 0.0 && t > tmax)
+               return 0.0;
+     }
+
+     /* back to the start of the window at zero elevation */
+     while (t > t1 && fabs (cl * sin (psi + PLANE_STEP) + sl) <= lam0) {
+          t -= step;
+          psi += PLANE_STEP;
+     }
+
+     return MAX (t1, t - step);
+}
@@ -36,6 +36,8 @@ orbit_type_t get_orbit_type (sat_t *sat);
 gboolean     geostationary  (sat_t *sat);
 gboolean     decayed        (sat_t *sat);
 gboolean     has_aos        (sat_t *sat, qth_t *qth);
+gdouble      next_pass_window (sat_t *sat, qth_t *qth, gdouble t,
+                               gdouble tmax, gdouble min_el);
 
 
 #endif
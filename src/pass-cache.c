@@ -0,0 +1,322 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Process-wide pass cache.
+ *
+ * The rig and rotator controllers, the polar view, sky at a glance and the
+ * popup menus all ask for the same passes over and over again. The cache
+ * remembers the result of each pass prediction together with everything
+ * the result depends on:
+ *
+ *   - the satellite catalogue number and the epoch of its TLE,
+ *   - the ground station (within PASS_CACHE_MAX_DIST and same altitude),
+ *   - the minimum elevation, time resolution and number of pass entries,
+ *   - the twilight threshold used for the visibility of the pass,
+ *   - whether the pass has details; a pass with details also answers a
+ *     request for a summary,
+ *   - the start time and look-ahead of the prediction.
+ *
+ * A prediction starting at s returns the first pass P with sufficient
+ * elevation that is in progress at s or starts after s. The same pass is
+ * therefore the answer for any later start time up to the LOS of P, which
+ * is what makes the cache useful for the controllers that ask for the
+ * current pass every few seconds. A prediction that returned no pass
+ * covers any prediction whose window lies within the original window.
+ *
+ * Entries of a satellite with an old TLE epoch are dropped when a new
+ * entry is stored, and pass_cache_flush is called when the TLE data is
+ * reloaded. The cache is used from the pass service worker threads and
+ * is protected by a lock.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pass-cache.h"
+#include "qth-data.h"
+#include "sat-cfg.h"
+#include "sat-log.h"
+
+/* maximum number of entries per satellite */
+#define PASS_CACHE_MAX_ENTRIES 16
+
+/* maximum distance between ground stations sharing an entry [km] */
+#define PASS_CACHE_MAX_DIST    1.0
+
+
+/** \brief Pass cache entry. */
+typedef struct {
+    gdouble         epoch;      /*!< TLE epoch of the satellite */
+    qth_small_t     qth;        /*!< Ground station */
+    gdouble         min_el;     /*!< Minimum elevation of the pass */
+    gint            tres;       /*!< Time resolution [sec] */
+    gint            num_entries;        /*!< Number of pass entries */
+    gint            thld;       /*!< Twilight threshold [deg] */
+    gboolean        details;    /*!< Whether the pass has details */
+    gdouble         start;      /*!< Start of the prediction */
+    gdouble         maxdt;      /*!< Look-ahead of the prediction */
+    pass_t         *pass;       /*!< The result, NULL for no pass */
+} pass_cache_entry_t;
+
+
+G_LOCK_DEFINE_STATIC(cache);
+
+/* catnr -> GSList of entries, most recently used first */
+static GHashTable *cache = NULL;
+
+
+static void free_entry(gpointer data)
+{
+    pass_cache_entry_t *entry = data;
+
+    free_pass(entry->pass);
+    g_free(entry);
+}
+
+static void free_entries(gpointer data)
+{
+    g_slist_free_full(data, free_entry);
+}
+
+/**
+ * \brief Check whether an entry is valid for a prediction.
+ *
+ * Compares everything except the time window.
+ */
+static gboolean entry_matches(pass_cache_entry_t * entry, sat_t * sat,
+                              qth_t * qth, gdouble min_el, gboolean details,
+                              gint tres, gint num_entries, gint thld)
+{
+    return (entry->epoch == sat->jul_epoch &&
+            (entry->details || !details) &&
+            entry->min_el == min_el &&
+            entry->tres == tres &&
+            entry->num_entries == num_entries &&
+            entry->thld == thld &&
+            entry->qth.alt == qth->alt &&
+            qth_small_dist(qth, entry->qth) <= PASS_CACHE_MAX_DIST);
+}
+
+/**
+ * \brief Check whether an entry answers a prediction.
+ * \param entry The cache entry.
+ * \param start The start time of the prediction.
+ * \param maxdt The look-ahead of the prediction, 0 for no limit.
+ * \param pass Location where the answer is stored.
+ * \return TRUE if the answer is known from the entry.
+ */
+static gboolean entry_covers(pass_cache_entry_t * entry, gdouble start,
+                             gdouble maxdt, pass_t ** pass)
+{
+    if (start < entry->start)
+        return FALSE;
+
+    if (entry->pass != NULL)
+    {
+        /* the pass is the first one as long as it has not ended */
+        if (start > entry->pass->los)
+            return FALSE;
+
+        if (maxdt > 0.0 && entry->pass->aos > start + maxdt)
+            *pass = NULL;
+        else
+            *pass = entry->pass;
+
+        return TRUE;
+    }
+
+    /* there was no pass in the whole window of the entry */
+    *pass = NULL;
+
+    if (entry->maxdt <= 0.0)
+        return TRUE;
+
+    return (maxdt > 0.0 && start + maxdt <= entry->start + entry->maxdt);
+}
+
+/**
+ * \brief Look up a pass prediction in the cache.
+ * \param sat The satellite.
+ * \param qth The ground station.
+ * \param start The start time of the prediction.
+ * \param maxdt The look-ahead of the prediction, 0 for no limit.
+ * \param min_el The minimum elevation of the pass.
+ * \param details Whether the pass must have details.
+ * \param pass Location where the pass is stored on a hit. It is a newly
+ *             allocated copy, or NULL if the prediction has no pass.
+ * \return TRUE on a hit, FALSE if the pass has to be predicted.
+ */
+gboolean pass_cache_lookup(sat_t * sat, qth_t * qth, gdouble start,
+                           gdouble maxdt, gdouble min_el, gboolean details,
+                           pass_t ** pass)
+{
+    GSList         *entries;
+    GSList         *node;
+    pass_cache_entry_t *entry;
+    pass_t         *found = NULL;
+    gboolean        hit = FALSE;
+    gint            tres = sat_cfg_get_int(SAT_CFG_INT_PRED_RESOLUTION);
+    gint            num_entries = sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_ENTRIES);
+    gint            thld = sat_cfg_get_int(SAT_CFG_INT_PRED_TWILIGHT_THLD);
+
+    G_LOCK(cache);
+
+    if (cache != NULL)
+    {
+        entries = g_hash_table_lookup(cache, GINT_TO_POINTER(sat->tle.catnr));
+
+        for (node = entries; node != NULL; node = node->next)
+        {
+            entry = node->data;
+            if (entry_matches(entry, sat, qth, min_el, details, tres,
+                              num_entries, thld) &&
+                entry_covers(entry, start, maxdt, &found))
+            {
+                hit = TRUE;
+                break;
+            }
+        }
+
+        if (hit)
+        {
+            /* keep the most recently used entries at the front */
+            entries = g_slist_remove_link(entries, node);
+            entries = g_slist_concat(node, entries);
+            g_hash_table_steal(cache, GINT_TO_POINTER(sat->tle.catnr));
+            g_hash_table_insert(cache, GINT_TO_POINTER(sat->tle.catnr),
+                                entries);
+
+            if (found != NULL)
+            {
+                found = copy_pass(found);
+                if (found == NULL)
+                    hit = FALSE;
+            }
+        }
+    }
+
+    G_UNLOCK(cache);
+
+    *pass = found;
+
+    return hit;
+}
+
+/**
+ * \brief Store a pass prediction in the cache.
+ * \param sat The satellite.
+ * \param qth The ground station.
+ * \param start The start time of the prediction.
+ * \param maxdt The look-ahead of the prediction, 0 for no limit.
+ * \param min_el The minimum elevation of the pass.
+ * \param details Whether the pass has details.
+ * \param pass The predicted pass or NULL if there was none. The cache
+ *             keeps a copy.
+ */
+void pass_cache_store(sat_t * sat, qth_t * qth, gdouble start, gdouble maxdt,
+                      gdouble min_el, gboolean details, pass_t * pass)
+{
+    GSList         *entries;
+    GSList         *node;
+    GSList         *next;
+    pass_cache_entry_t *entry;
+    guint           num = 0;
+
+    entry = g_new(pass_cache_entry_t, 1);
+    entry->epoch = sat->jul_epoch;
+    qth_small_save(qth, &entry->qth);
+    entry->min_el = min_el;
+    entry->details = details;
+    entry->tres = sat_cfg_get_int(SAT_CFG_INT_PRED_RESOLUTION);
+    entry->num_entries = sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_ENTRIES);
+    entry->thld = sat_cfg_get_int(SAT_CFG_INT_PRED_TWILIGHT_THLD);
+    entry->start = start;
+    entry->maxdt = maxdt;
+    entry->pass = NULL;
+
+    if (pass != NULL)
+    {
+        entry->pass = copy_pass(pass);
+        if (entry->pass == NULL)
+        {
+            g_free(entry);
+            return;
+        }
+    }
+
+    G_LOCK(cache);
+
+    if (cache == NULL)
+        cache = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                      free_entries);
+
+    entries = g_hash_table_lookup(cache, GINT_TO_POINTER(sat->tle.catnr));
+    g_hash_table_steal(cache, GINT_TO_POINTER(sat->tle.catnr));
+
+    entries = g_slist_prepend(entries, entry);
+
+    /* drop entries of older TLE data and the least recently used ones */
+    for (node = entries; node != NULL; node = next)
+    {
+        next = node->next;
+        entry = node->data;
+
+        if (entry->epoch != sat->jul_epoch ||
+            ++num > PASS_CACHE_MAX_ENTRIES)
+        {
+            entries = g_slist_delete_link(entries, node);
+            free_entry(entry);
+        }
+    }
+
+    g_hash_table_insert(cache, GINT_TO_POINTER(sat->tle.catnr), entries);
+
+    G_UNLOCK(cache);
+}
+
+/**
+ * \brief Remove all entries from the cache.
+ *
+ * Called when the TLE data has been updated.
+ */
+void pass_cache_flush(void)
+{
+    G_LOCK(cache);
+
+    if (cache != NULL)
+    {
+        g_hash_table_destroy(cache);
+        cache = NULL;
+    }
+
+    G_UNLOCK(cache);
+
+    sat_log_log(SAT_LOG_LEVEL_DEBUG, _("%s: Pass cache flushed"), __func__);
+}
@@ -0,0 +1,318 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Pass prediction service.
+ *
+ * Runs get_passes, get_passes_summary and find_aos/find_los on a pool of
+ * worker threads, one task per satellite, and hands the results to a callback in the main loop.
+ *
+ * Each task works on its own copy of the satellite, including the
+ * propagation constants, and of the observer position, so the caller may
+ * modify or free its data while the task is running. The only thing the
+ * caller must ensure is that the user data of its callbacks stays valid;
+ * pass_service_cancel must be called before freeing it.
+ *
+ * All functions must be called from the main loop thread.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+
+#include "pass-service.h"
+#include "predict-tools.h"
+#include "sat-log.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/** \brief Pass service task. */
+typedef struct {
+    sat_t          *orig;       /*!< The caller's satellite, not used by the worker */
+    sat_t           sat;        /*!< Independent copy of the satellite */
+    qth_t           qth;        /*!< Copy of the observer position */
+    gdouble         start;      /*!< Start of the prediction [jul_utc] */
+    gdouble         maxdt;      /*!< Look-ahead [days] */
+    guint           num;        /*!< Number of passes, 0 for events */
+    gboolean        summaries;  /*!< Predict pass summaries only */
+    pass_service_passes_cb passes_cb;   /*!< Callback for passes */
+    pass_service_events_cb events_cb;   /*!< Callback for events */
+    gpointer        data;       /*!< User data of the callback */
+    gint            cancelled;  /*!< Set when the result is not wanted */
+    GSList         *passes;     /*!< Resulting passes */
+    gdouble         aos;        /*!< Resulting AOS */
+    gdouble         los;        /*!< Resulting LOS */
+} pass_task_t;
+
+
+static GThreadPool *pool = NULL;
+
+/* tasks that have not been delivered yet; main loop only */
+static GList   *tasks = NULL;
+
+
+/** \brief Free a task and its results. */
+static void free_task(pass_task_t * task)
+{
+    free_passes(task->passes);
+    g_free(task->sat.name);
+    g_free(task->sat.nickname);
+    free_ephemeris(&task->sat);
+    g_free(task);
+}
+
+/**
+ * \brief Deliver the result of a task in the main loop.
+ *
+ * Called as idle function once the worker is done with the task.
+ */
+static gboolean deliver_task(gpointer data)
+{
+    pass_task_t    *task = data;
+
+    tasks = g_list_remove(tasks, task);
+
+    if (!task->cancelled)
+    {
+        if (task->passes_cb != NULL)
+        {
+            task->passes_cb(task->orig, task->passes, task->data);
+            task->passes = NULL;
+        }
+        else
+        {
+            task->events_cb(task->orig, task->aos, task->los, task->data);
+        }
+    }
+
+    free_task(task);
+
+    return FALSE;
+}
+
+/** \brief Worker thread function. */
+static void pass_service_run(gpointer data, gpointer unused)
+{
+    pass_task_t    *task = data;
+
+    (void)unused;
+
+    if (!g_atomic_int_get(&task->cancelled))
+    {
+        if (task->passes_cb != NULL)
+        {
+            if (task->summaries)
+                task->passes = get_passes_summary(&task->sat, &task->qth,
+                                                  task->start, task->maxdt,
+                                                  task->num);
+            else
+                task->passes = get_passes(&task->sat, &task->qth,
+                                          task->start, task->maxdt,
+                                          task->num);
+        }
+        else
+        {
+            task->aos = find_aos(&task->sat, &task->qth, task->start,
+                                 task->maxdt);
+            task->los = find_los(&task->sat, &task->qth, task->start,
+                                 task->maxdt);
+        }
+    }
+
+    g_idle_add(deliver_task, task);
+}
+
+/**
+ * \brief Create a task and hand it to the pool.
+ *
+ * The pool is created on first use with one thread per processor.
+ */
+static void push_task(pass_task_t * task, sat_t * sat, qth_t * qth)
+{
+    GError         *error = NULL;
+    gint            nthreads;
+
+    if (pool == NULL)
+    {
+#if GLIB_CHECK_VERSION(2, 36, 0)
+        nthreads = g_get_num_processors();
+#else
+        nthreads = 2;
+#endif
+        pool = g_thread_pool_new(pass_service_run, NULL, nthreads, FALSE,
+                                 NULL);
+    }
+
+    task->orig = sat;
+    clone_ephemeris(&task->sat, sat);
+    task->sat.name = g_strdup(sat->name);
+    task->sat.nickname = g_strdup(sat->nickname);
+    task->sat.website = NULL;
+
+    /* only the position is used by the prediction code */
+    task->qth.lat = qth->lat;
+    task->qth.lon = qth->lon;
+    task->qth.alt = qth->alt;
+
+    tasks = g_list_prepend(tasks, task);
+
+    if (!g_thread_pool_push(pool, task, &error))
+    {
+        /* run it here rather than losing it */
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Could not start prediction for %s (%s)"),
+                    __func__, sat->nickname, error->message);
+        g_clear_error(&error);
+        pass_service_run(task, NULL);
+    }
+}
+
+/**
+ * \brief Predict passes in the background.
+ * \param sat The satellite.
+ * \param qth The observer.
+ * \param start The start time.
+ * \param maxdt The look-ahead in days; see get_passes.
+ * \param num The maximum number of passes; see get_passes.
+ * \param func The function receiving the passes in the main loop.
+ * \param data User data for func.
+ *
+ * Equivalent to calling func(sat, get_passes(sat, qth, start, maxdt, num),
+ * data), except that get_passes runs in a worker thread and func is called
+ * from the main loop later on.
+ */
+void pass_service_get_passes(sat_t * sat, qth_t * qth, gdouble start,
+                             gdouble maxdt, guint num,
+                             pass_service_passes_cb func, gpointer data)
+{
+    pass_task_t    *task = g_new0(pass_task_t, 1);
+
+    task->start = start;
+    task->maxdt = maxdt;
+    task->num = num;
+    task->passes_cb = func;
+    task->data = data;
+
+    push_task(task, sat, qth);
+}
+
+/**
+ * \brief Predict pass summaries in the background.
+ *
+ * Same as pass_service_get_passes but using get_passes_summary. The
+ * details of a pass can be computed later with get_pass_details.
+ */
+void pass_service_get_summaries(sat_t * sat, qth_t * qth, gdouble start,
+                                gdouble maxdt, guint num,
+                                pass_service_passes_cb func, gpointer data)
+{
+    pass_task_t    *task = g_new0(pass_task_t, 1);
+
+    task->start = start;
+    task->maxdt = maxdt;
+    task->num = num;
+    task->summaries = TRUE;
+    task->passes_cb = func;
+    task->data = data;
+
+    push_task(task, sat, qth);
+}
+
+/**
+ * \brief Find the next AOS and LOS in the background.
+ * \param sat The satellite.
+ * \param qth The observer.
+ * \param start The start time.
+ * \param maxdt The look-ahead in days; see find_aos.
+ * \param func The function receiving the AOS and LOS in the main loop.
+ * \param data User data for func.
+ */
+void pass_service_get_events(sat_t * sat, qth_t * qth, gdouble start,
+                             gdouble maxdt, pass_service_events_cb func,
+                             gpointer data)
+{
+    pass_task_t    *task = g_new0(pass_task_t, 1);
+
+    task->start = start;
+    task->maxdt = maxdt;
+    task->events_cb = func;
+    task->data = data;
+
+    push_task(task, sat, qth);
+}
+
+/**
+ * \brief Cancel the pending tasks of a user.
+ * \param data The user data given when the tasks were started.
+ *
+ * The callbacks of the tasks will not be called. Tasks that have not
+ * started yet are skipped by the workers.
+ */
+void pass_service_cancel(gpointer data)
+{
+    GList          *node;
+    pass_task_t    *task;
+
+    for (node = tasks; node != NULL; node = node->next)
+    {
+        task = node->data;
+        if (task->data == data)
+            g_atomic_int_set(&task->cancelled, TRUE);
+    }
+}
+
+/**
+ * \brief Stop the worker threads.
+ *
+ * Waits for the running tasks and drops the rest. Must be called after
+ * the main loop has finished.
+ */
+void pass_service_shutdown(void)
+{
+    GSource        *source;
+    pass_task_t    *task;
+
+    if (pool == NULL)
+        return;
+
+    g_thread_pool_free(pool, TRUE, TRUE);
+    pool = NULL;
+
+    /* free the tasks, also those whose results are waiting for delivery */
+    while (tasks != NULL)
+    {
+        task = tasks->data;
+        tasks = g_list_delete_link(tasks, tasks);
+
+        source = g_main_context_find_source_by_user_data(NULL, task);
+        if (source != NULL)
+            g_source_destroy(source);
+
+        free_task(task);
+    }
+}
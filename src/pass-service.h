@@ -0,0 +1,72 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef PASS_SERVICE_H
+#define PASS_SERVICE_H 1
+
+#include <glib.h>
+#include "gtk-sat-data.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+/**
+ * \brief Callback receiving the passes of a satellite.
+ * \param sat The satellite given to pass_service_get_passes.
+ * \param passes The passes as returned by get_passes; the callback takes
+ *               ownership and must free them with free_passes.
+ * \param data The user data given to pass_service_get_passes.
+ */
+typedef void    (*pass_service_passes_cb) (sat_t * sat, GSList * passes,
+                                           gpointer data);
+
+/**
+ * \brief Callback receiving the next AOS and LOS of a satellite.
+ * \param sat The satellite given to pass_service_get_events.
+ * \param aos The next AOS as returned by find_aos.
+ * \param los The next LOS as returned by find_los.
+ * \param data The user data given to pass_service_get_events.
+ */
+typedef void    (*pass_service_events_cb) (sat_t * sat, gdouble aos,
+                                           gdouble los, gpointer data);
+
+void            pass_service_get_passes(sat_t * sat, qth_t * qth,
+                                        gdouble start, gdouble maxdt,
+                                        guint num,
+                                        pass_service_passes_cb func,
+                                        gpointer data);
+void            pass_service_get_summaries(sat_t * sat, qth_t * qth,
+                                           gdouble start, gdouble maxdt,
+                                           guint num,
+                                           pass_service_passes_cb func,
+                                           gpointer data);
+void            pass_service_get_events(sat_t * sat, qth_t * qth,
+                                        gdouble start, gdouble maxdt,
+                                        pass_service_events_cb func,
+                                        gpointer data);
+void            pass_service_cancel(gpointer data);
+void            pass_service_shutdown(void);
+
+#endif
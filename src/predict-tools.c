@@ -38,6 +38,7 @@
 
 #include "gtk-sat-data.h"
 #include "orbit-tools.h"
+#include "pass-cache.h"
 #include "predict-tools.h"
 #include "sat-cfg.h"
 #include "sat-log.h"
@@ -45,42 +46,105 @@
 #include "time-tools.h"
 
 static pass_t  *get_pass_engine(sat_t * sat_in, qth_t * qth, gdouble start,
-                                gdouble maxdt, gdouble min_el);
+                                gdouble maxdt, gdouble min_el,
+                                gboolean details);
+static GSList  *get_passes_engine(sat_t * sat, qth_t * qth, gdouble start,
+                                  gdouble maxdt, guint num, gboolean details);
+
+/* number of time steps propagated per Propagate_Series call */
+#define SERIES_CHUNK 64
+
+/* AOS/LOS search: maximum number of propagations per search, elevation
+   tolerance [deg], time tolerance [days] and the amount by which a step
+   towards the horizon overshoots the linear estimate [days] */
+#define FIND_MAX_EVALS  1000
+#define FIND_EL_TOL     0.005
+#define FIND_TIME_TOL   (0.5 / 86400.0)
+#define FIND_OVERSHOOT  (2.0 / 86400.0)
+
+/* largest number of passes below the minimum elevation that the pass
+   search skips before it gives up; about a month for a LEO satellite */
+#define PASS_MAX_ITER   500
+
+/* number of intervals scanned for the TCA of a pass summary */
+#define SUMMARY_STEPS   8
+
+/* visibility windows: maximum scan step [days] and maximum number of
+   segments with different visibility per pass */
+#define VIS_MAX_STEP     (300.0 / 86400.0)
+#define VIS_MAX_SEGMENTS 16
+
+/* visibility conditions, see vis_eval */
+#define VIS_ECLIPSED    1       /* satellite in the shadow of the Earth */
+#define VIS_DARK        2       /* sun below the twilight threshold */
+
+/** \brief Pass split into segments of constant visibility. */
+typedef struct {
+    guint           num;        /*!< Number of segments */
+    gdouble         start[VIS_MAX_SEGMENTS];    /*!< Start of each segment */
+    sat_vis_t       vis[VIS_MAX_SEGMENTS];      /*!< Visibility of each segment */
+} vis_segments_t;
+
+/* number of propagations done by the AOS/LOS search, see get_find_evals */
+static gint     find_evals = 0;
 
 /**
- * \brief SGP4SDP4 driver for doing AOS/LOS calculations.
+ * \brief Calculate the orbit number at a given time.
  * \param sat Pointer to the satellite data.
+ * \param t The time (Julian Date)
+ */
+static long calc_orbit_num(sat_t * sat, gdouble t)
+{
+    double          age;
+
+    age = t - sat->jul_epoch;
+
+    return (long)floor((sat->tle.xno * xmnpda / twopi +
+                        age * sat->tle.bstar * ae) * age +
+                       (sat->tle.xmo + sat->tle.omegao) / twopi) +
+        sat->tle.revnum;
+}
+
+/**
+ * \brief Prepare the observer frame for a given time.
  * \param qth Pointer to the QTH data.
  * \param t The time for calculation (Julian Date)
+ * \param frame Pointer to the frame to fill in.
+ *
+ * The frame can be passed to predict_calc_frame and predict_calc_multi for
+ * any number of satellites as long as the time and QTH remain the same.
  */
-void predict_calc(sat_t * sat, qth_t * qth, gdouble t)
+void predict_obs_frame(qth_t * qth, gdouble t, obs_frame_t * frame)
 {
-    obs_set_t       obs_set;
-    geodetic_t      sat_geodetic;
     geodetic_t      obs_geodetic;
-    double          age;
 
     obs_geodetic.lon = qth->lon * de2ra;
     obs_geodetic.lat = qth->lat * de2ra;
     obs_geodetic.alt = qth->alt / 1000.0;
     obs_geodetic.theta = 0;
 
-    sat->jul_utc = t;
-    sat->tsince = (sat->jul_utc - sat->jul_epoch) * xmnpda;
-
-    /* call the norad routines according to the deep-space flag */
-    if (sat->flags & DEEP_SPACE_EPHEM_FLAG)
-        SDP4(sat, sat->tsince);
-    else
-        SGP4(sat, sat->tsince);
+    Calculate_Obs_Frame(t, &obs_geodetic, frame);
+}
 
-    Convert_Sat_State(&sat->pos, &sat->vel);
+/**
+ * \brief Calculate the derived data from the raw position and velocity.
+ * \param sat Pointer to the satellite data.
+ * \param frame The observer frame at sat->jul_utc.
+ *
+ * This is the common tail of the predict_calc functions. It expects
+ * sat->pos, sat->vel and sat->phase to be up to date, with the position
+ * and velocity already converted to km and km/s.
+ */
+static void calc_derived(sat_t * sat, const obs_frame_t * frame)
+{
+    obs_set_t       obs_set;
+    geodetic_t      sat_geodetic;
 
     /* get the velocity of the satellite */
     Magnitude(&sat->vel);
     sat->velo = sat->vel.w;
-    Calculate_Obs(sat->jul_utc, &sat->pos, &sat->vel, &obs_geodetic, &obs_set);
-    Calculate_LatLonAlt(sat->jul_utc, &sat->pos, &sat_geodetic);
+    Calculate_Frame_Topo(frame, &sat->pos, &sat->vel, &obs_set,
+                         &sat_geodetic);
 
     while (sat_geodetic.lon < -pi)
         sat_geodetic.lon += twopi;
@@ -102,111 +166,393 @@ void predict_calc(sat_t * sat, qth_t * qth, gdouble t)
     /* same formulas, but the one from predict is nicer */
     //sat->footprint = 2.0 * xkmper * acos (xkmper/sat->pos.w);
     sat->footprint = 12756.33 * acos(xkmper / (xkmper + sat->alt));
-    age = sat->jul_utc - sat->jul_epoch;
-    sat->orbit = (long)floor((sat->tle.xno * xmnpda / twopi +
-                              age * sat->tle.bstar * ae) * age +
-                             (sat->tle.xmo + sat->tle.omegao) / twopi) + sat->tle.revnum ;
+    sat->orbit = calc_orbit_num(sat, sat->jul_utc);
 }
 
 /**
- * \brief Find the AOS time of the next pass.
- * \author Alexandru Csete, OZ9AEC
- * \author John A. Magliacane, KD2BD
+ * \brief SGP4SDP4 driver for doing AOS/LOS calculations.
  * \param sat Pointer to the satellite data.
  * \param qth Pointer to the QTH data.
- * \param start The time where calculation should start.
- * \param maxdt The upper time limit in days (0.0 = no limit)
- * \return The time of the next AOS or 0.0 if the satellite has no AOS.
- *
- * This function finds the time of AOS for the first coming pass taking place
- * no earlier that start.
- * If the satellite is currently within range, the function first calls
- * find_los to get the next LOS time. Then the calculations are done using
- * the new start time.
+ * \param t The time for calculation (Julian Date)
  */
-gdouble find_aos(sat_t * sat, qth_t * qth, gdouble start, gdouble maxdt)
+void predict_calc(sat_t * sat, qth_t * qth, gdouble t)
 {
-    gdouble         t = start;
-    gdouble         aostime = 0.0;
+    obs_frame_t     frame;
 
-    /* make sure current sat values are in sync with the time */
-    predict_calc(sat, qth, start);
+    predict_obs_frame(qth, t, &frame);
+    predict_calc_frame(sat, &frame);
+}
 
-    /* check whether satellite has aos */
-    if (!has_aos(sat, qth))
-        return 0.0;
+/**
+ * \brief SGP4SDP4 driver using a precalculated observer frame.
+ * \param sat Pointer to the satellite data.
+ * \param frame The observer frame, see predict_obs_frame.
+ *
+ * Same as predict_calc for the time and QTH of the frame.
+ */
+void predict_calc_frame(sat_t * sat, const obs_frame_t * frame)
+{
+    sat->jul_utc = frame->jul_utc;
+    sat->tsince = (sat->jul_utc - sat->jul_epoch) * xmnpda;
+
+    /* call the norad routines according to the deep-space flag */
+    if (sat->flags & DEEP_SPACE_EPHEM_FLAG)
+        SDP4(sat, sat->tsince);
+    else
+        SGP4(sat, sat->tsince);
 
-    if (sat->el > 0.0)
-        t = find_los(sat, qth, start, maxdt) + 0.014;   // +20 min
+    Convert_Sat_State(&sat->pos, &sat->vel);
 
-    /* invalid time (potentially returned by find_los) */
-    if (t < 0.1)
-        return 0.0;
+    calc_derived(sat, frame);
+}
 
-    /* update satellite data */
-    predict_calc(sat, qth, t);
+/**
+ * \brief SGP4 driver for blocks of near-earth satellites.
+ * \param blocks Array of satellite blocks prepared with SGP4_Multi_Add.
+ * \param nblocks The number of blocks.
+ * \param frame The observer frame, see predict_obs_frame.
+ *
+ * This function has the same effect as calling predict_calc_frame for every
+ * satellite in the blocks, but the propagation is done SGP4_MULTI_LANES
+ * satellites at a time using the structure-of-arrays kernel.
+ */
+void predict_calc_multi(sgp4_multi_t * blocks, guint nblocks,
+                        const obs_frame_t * frame)
+{
+    gdouble         tsince[SGP4_MULTI_LANES];
+    sat_t          *sat;
+    guint           i;
+    gint            l;
 
-    /* use upper time limit */
-    if (maxdt > 0.0)
+    for (i = 0; i < nblocks; i++)
     {
+        for (l = 0; l < blocks[i].num; l++)
+        {
+            sat = blocks[i].sat[l];
+            sat->jul_utc = frame->jul_utc;
+            sat->tsince = (sat->jul_utc - sat->jul_epoch) * xmnpda;
+            tsince[l] = sat->tsince;
+        }
+
+        SGP4_Multi(&blocks[i], tsince);
 
-        /* coarse time steps */
-        while ((sat->el < -1.0) && (t <= (start + maxdt)))
+        for (l = 0; l < blocks[i].num; l++)
         {
-            t -= 0.00035 * (sat->el * ((sat->alt / 8400.0) + 0.46) - 2.0);
-            predict_calc(sat, qth, t);
+            sat = blocks[i].sat[l];
+            Convert_Sat_State(&sat->pos, &sat->vel);
+            calc_derived(sat, frame);
         }
+    }
+}
 
-        /* fine steps */
-        while ((aostime == 0.0) && (t <= (start + maxdt)))
+/**
+ * \brief SGP4SDP4 driver using an ephemeris cache.
+ * \param sat Pointer to the satellite data.
+ * \param cache The ephemeris cache of the satellite.
+ * \param frame The observer frame, see predict_obs_frame.
+ *
+ * Same as predict_calc_frame, but the position and velocity are
+ * interpolated from the cache. Falls back to direct propagation if the
+ * cache can not meet its tolerance.
+ */
+void predict_calc_ephem(sat_t * sat, ephem_cache_t * cache,
+                        const obs_frame_t * frame)
+{
+    if (ephem_cache_eval(cache, sat, frame->jul_utc))
+        calc_derived(sat, frame);
+    else
+        predict_calc_frame(sat, frame);
+}
+
+/**
+ * \brief Calculate sub-satellite points for a series of times.
+ * \param sat Pointer to the satellite data.
+ * \param t Array of num times (Julian Date).
+ * \param num The number of entries in t.
+ * \param lat Array of num elements receiving the SSP latitude [deg].
+ * \param lon Array of num elements receiving the SSP longitude [deg].
+ * \param orbit Array of num elements receiving the orbit number.
+ *
+ * This is the batch version of the SSP part of predict_calc. The propagation
+ * is done in chunks using Propagate_Series, so the per-step driver overhead
+ * is avoided. The topocentric data in sat is not updated; sat->pos, sat->vel,
+ * sat->jul_utc and sat->tsince correspond to the last entry in t.
+ */
+void predict_ssp_series(sat_t * sat, const gdouble * t, guint num,
+                        gdouble * lat, gdouble * lon, glong * orbit)
+{
+    double          tsince[SERIES_CHUNK];
+    vector_t        pos[SERIES_CHUNK];
+    vector_t        vel[SERIES_CHUNK];
+    geodetic_t      sat_geodetic;
+    guint           i, j, n;
+
+    for (i = 0; i < num; i += n)
+    {
+        n = MIN(num - i, SERIES_CHUNK);
+
+        for (j = 0; j < n; j++)
+            tsince[j] = (t[i + j] - sat->jul_epoch) * xmnpda;
+
+        Propagate_Series(sat, tsince, n, pos, vel);
+
+        for (j = 0; j < n; j++)
         {
+            Calculate_LatLonAlt(t[i + j], &pos[j], &sat_geodetic);
 
-            if (fabs(sat->el) < 0.005)
-            {
-                aostime = t;
-            }
-            else
-            {
-                t -= sat->el * sqrt(sat->alt) / 530000.0;
-                predict_calc(sat, qth, t);
-            }
+            while (sat_geodetic.lon < -pi)
+                sat_geodetic.lon += twopi;
+
+            while (sat_geodetic.lon > (pi))
+                sat_geodetic.lon -= twopi;
 
+            lat[i + j] = Degrees(sat_geodetic.lat);
+            lon[i + j] = Degrees(sat_geodetic.lon);
+            orbit[i + j] = calc_orbit_num(sat, t[i + j]);
         }
+    }
 
+    if (num > 0)
+    {
+        sat->jul_utc = t[num - 1];
+        sat->tsince = tsince[(num - 1) % SERIES_CHUNK];
+    }
+}
+
+/**
+ * \brief Rate of change of the elevation.
+ * \param sat Pointer to the satellite data with up to date position,
+ *            velocity, elevation and range rate for the observer.
+ * \param frame The observer frame.
+ * \return The rate of change of the elevation [deg/day].
+ *
+ * The elevation rate is derived from the topocentric position and the
+ * range rate, taking the rotation of the observer's zenith into account.
+ */
+static gdouble calc_eldot(sat_t * sat, const obs_frame_t * frame)
+{
+    gdouble         rx, ry, rz, range, zdot;
+    gdouble         upx, upy, upz;
+
+    rx = sat->pos.x - frame->obs_pos.x;
+    ry = sat->pos.y - frame->obs_pos.y;
+    rz = sat->pos.z - frame->obs_pos.z;
+    range = sqrt(rx * rx + ry * ry + rz * rz);
+
+    upx = frame->cos_lat * frame->cos_theta;
+    upy = frame->cos_lat * frame->sin_theta;
+    upz = frame->sin_lat;
+
+    /* d/dt of the zenith component of the range vector [km/s] */
+    zdot = (sat->vel.x - frame->obs_vel.x) * upx +
+        (sat->vel.y - frame->obs_vel.y) * upy +
+        (sat->vel.z - frame->obs_vel.z) * upz +
+        mfactor * (ry * upx - rx * upy);
+
+    return Degrees((zdot - sin(sat->el * de2ra) * sat->range_rate) /
+                   (range * cos(sat->el * de2ra))) * 86400.0;
+}
+
+/**
+ * \brief Propagate for the AOS/LOS search.
+ * \param sat Pointer to the satellite data.
+ * \param qth Pointer to the QTH data.
+ * \param t The time (Julian Date).
+ * \param evals The evaluation counter of the current search.
+ * \return The rate of change of the elevation [deg/day].
+ */
+static gdouble find_eval(sat_t * sat, qth_t * qth, gdouble t, guint * evals)
+{
+    obs_frame_t     frame;
+
+    predict_obs_frame(qth, t, &frame);
+    predict_calc_frame(sat, &frame);
+
+    (*evals)++;
+
+    return calc_eldot(sat, &frame);
+}
+
+/**
+ * \brief Add the evaluations of an AOS/LOS search to the global counter.
+ * \param evals The evaluation counter of the search.
+ * \param t The result of the search.
+ * \return t
+ */
+static gdouble find_done(guint evals, gdouble t)
+{
+    g_atomic_int_add(&find_evals, (gint) evals);
+
+    return t;
+}
+
+/**
+ * \brief Time step for the AOS/LOS search.
+ * \param sat Pointer to the satellite data.
+ * \param eldot The elevation rate [deg/day].
+ *
+ * The coarse steps are the heuristics of the former step loops; they are
+ * small enough not to jump over a pass. When the satellite approaches the
+ * horizon, the step is shortened to the linear estimate of the crossing
+ * plus a little, so that the next evaluation usually brackets it.
+ */
+static gdouble find_step(sat_t * sat, gdouble eldot)
+{
+    gdouble         dt;
+
+    if (sat->el < 0.0)
+    {
+        dt = 0.00035 * (2.0 - MIN(sat->el, -1.0) *
+                        ((sat->alt / 8400.0) + 0.46));
+        if (eldot > 0.0)
+            dt = MIN(dt, -sat->el / eldot + FIND_OVERSHOOT);
     }
-    /* don't use upper time limit */
     else
     {
-        /* coarse time steps */
-        while (sat->el < -1.0)
+        dt = cos((MAX(sat->el, 1.0) - 1.0) * de2ra) * sqrt(sat->alt) /
+            25000.0;
+        if (eldot < 0.0)
+            dt = MIN(dt, sat->el / -eldot + FIND_OVERSHOOT);
+    }
+
+    return MAX(dt, FIND_TIME_TOL);
+}
+
+/**
+ * \brief Refine a horizon crossing.
+ * \param sat Pointer to the satellite data, propagated to t.
+ * \param qth Pointer to the QTH data.
+ * \param a The end of the bracket before the crossing.
+ * \param b The end of the bracket after the crossing.
+ * \param t The time sat has been propagated to, either a or b.
+ * \param eldot The elevation rate at t [deg/day].
+ * \param rising TRUE for AOS, FALSE for LOS.
+ * \param evals The evaluation counter of the current search.
+ * \return The time of the crossing.
+ *
+ * Newton steps on the elevation, falling back to bisection whenever a
+ * step would leave the bracket.
+ */
+static gdouble find_root(sat_t * sat, qth_t * qth, gdouble a, gdouble b,
+                         gdouble t, gdouble eldot, gboolean rising,
+                         guint * evals)
+{
+    while ((fabs(sat->el) >= FIND_EL_TOL) && (b - a > FIND_TIME_TOL) &&
+           (*evals < FIND_MAX_EVALS))
+    {
+        t = (eldot != 0.0) ? t - sat->el / eldot : a;
+        if (!(t > a && t < b))
+            t = 0.5 * (a + b);
+
+        eldot = find_eval(sat, qth, t, evals);
+
+        if ((sat->el >= 0.0) == rising)
+            b = t;
+        else
+            a = t;
+    }
+
+    return t;
+}
+
+/**
+ * \brief Find the next horizon crossing.
+ * \param sat Pointer to the satellite data, propagated to start.
+ * \param qth Pointer to the QTH data.
+ * \param start The time where the search starts.
+ * \param end The time where the search ends.
+ * \param eldot The elevation rate at start [deg/day].
+ * \param rising TRUE to find AOS, FALSE to find LOS.
+ * \param evals The evaluation counter of the current search.
+ * \return The time of the crossing or 0.0 if none was found before end or
+ *         within FIND_MAX_EVALS evaluations.
+ *
+ * Only crossings that are preceded by a time on the other side of the
+ * horizon count, i.e. searching for AOS while the satellite is in range
+ * gives the AOS of the next pass.
+ */
+static gdouble find_crossing(sat_t * sat, qth_t * qth, gdouble start,
+                             gdouble end, gdouble eldot, gboolean rising,
+                             guint * evals)
+{
+    gdouble         t = start;
+    gdouble         prev = start;
+    gboolean        armed = FALSE;
+
+    while ((t <= end) && (*evals < FIND_MAX_EVALS))
+    {
+        if ((sat->el >= 0.0) != rising)
         {
-            t -= 0.00035 * (sat->el * ((sat->alt / 8400.0) + 0.46) - 2.0);
-            predict_calc(sat, qth, t);
+            armed = TRUE;
+            prev = t;
         }
-
-        /* fine steps */
-        while (aostime == 0.0)
+        else if (armed)
         {
-
-            if (fabs(sat->el) < 0.005)
-            {
-                aostime = t;
-            }
-            else
-            {
-                t -= sat->el * sqrt(sat->alt) / 530000.0;
-                predict_calc(sat, qth, t);
-            }
+            return find_root(sat, qth, prev, t, t, eldot, rising, evals);
         }
+
+        t += find_step(sat, eldot);
+        eldot = find_eval(sat, qth, t, evals);
     }
 
-    return aostime;
+    if (*evals >= FIND_MAX_EVALS)
+        sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                    _("%s: Gave up on %s after %d evaluations"),
+                    __func__, sat->nickname, *evals);
+
+    return 0.0;
+}
+
+/**
+ * \brief Get the number of propagations done by the AOS/LOS search.
+ * \return The number of evaluations done by find_aos, find_los and
+ *         find_prev_aos since the program started.
+ *
+ * The counter is shared by all threads; take the difference of two calls
+ * to measure a piece of code.
+ */
+guint get_find_evals(void)
+{
+    return (guint) g_atomic_int_get(&find_evals);
+}
+
+/**
+ * \brief Find the AOS time of the next pass.
+ * \param sat Pointer to the satellite data.
+ * \param qth Pointer to the QTH data.
+ * \param start The time where calculation should start.
+ * \param maxdt The upper time limit in days (0.0 = no limit)
+ * \return The time of the next AOS or 0.0 if the satellite has no AOS.
+ *
+ * This function finds the time of AOS for the first coming pass taking place
+ * no earlier that start. If the satellite is currently within range, that is
+ * the AOS following the current pass.
+ * The search brackets the horizon crossing and refines it with Newton steps
+ * on the elevation; it gives up after FIND_MAX_EVALS propagations, also when
+ * there is no time limit.
+ */
+gdouble find_aos(sat_t * sat, qth_t * qth, gdouble start, gdouble maxdt)
+{
+    gdouble         eldot;
+    gdouble         t;
+    guint           evals = 0;
+
+    /* make sure current sat values are in sync with the time */
+    eldot = find_eval(sat, qth, start, &evals);
+
+    /* check whether satellite has aos */
+    if (!has_aos(sat, qth))
+        return find_done(evals, 0.0);
+
+    t = find_crossing(sat, qth, start,
+                      (maxdt > 0.0) ? start + maxdt : G_MAXDOUBLE,
+                      eldot, TRUE, &evals);
+
+    return find_done(evals, t);
 }
 
 /**
  * \brief Find the LOS time of the next pass.
- * \author Alexandru Csete, OZ9AEC
- * \author John A. Magliacane, KD2BD
  * \param sat Pointer to the satellite data.
  * \param qth Pointer to the QTH data.
  * \param start The time where calculation should start.
@@ -214,133 +560,514 @@ gdouble find_aos(sat_t * sat, qth_t * qth, gdouble start, gdouble maxdt)
  * \return The time of the next LOS or 0.0 if the satellite has no LOS.
  *
  * This function finds the time of LOS for the first coming pass taking place
- * no earlier that start.
- * If the satellite is currently out of range, the function first calls
- * find_aos to get the next AOS time. Then the calculations are done using
- * the new start time.
- * The function has a built-in watchdog to ensure that we don't end up in
- * lengthy loops.
+ * no earlier that start. If the satellite is currently out of range, that is
+ * the LOS of the next pass.
+ * Like find_aos, the search is bounded by FIND_MAX_EVALS propagations.
  */
 gdouble find_los(sat_t * sat, qth_t * qth, gdouble start, gdouble maxdt)
 {
-    gdouble         t = start;
-    gdouble         lostime = 0.0;
-    gdouble         eltemp;
+    gdouble         eldot;
+    gdouble         t;
+    guint           evals = 0;
+
+    eldot = find_eval(sat, qth, start, &evals);
+
+    /* check whether satellite has aos */
+    if (!has_aos(sat, qth))
+        return find_done(evals, 0.0);
+
+    t = find_crossing(sat, qth, start,
+                      (maxdt > 0.0) ? start + maxdt : G_MAXDOUBLE,
+                      eldot, FALSE, &evals);
+
+    return find_done(evals, t);
+}
+
+/**
+ * \brief Find AOS time of current pass.
+ * \param sat The satellite to find AOS for.
+ * \param qth The ground station.
+ * \param start Start time, prefereably now.
+ * \return The time of the previous AOS or 0.0 if the satellite has no AOS
+ *         or it could not be found within FIND_MAX_EVALS propagations.
+ *
+ * This function can be used to find the AOS time in the past of the
+ * current pass.
+ */
+gdouble find_prev_aos(sat_t * sat, qth_t * qth, gdouble start)
+{
+    gdouble         aostime = start;
+    gdouble         eldot, dt = 0.0;
+    guint           evals = 0;
 
-    predict_calc(sat, qth, start);
+    /* make sure current sat values are in sync with the time */
+    eldot = find_eval(sat, qth, start, &evals);
 
     /* check whether satellite has aos */
     if (!has_aos(sat, qth))
     {
-        return 0.0;
+        return find_done(evals, 0.0);
     }
 
+    /* not in range */
     if (sat->el < 0.0)
-        t = find_aos(sat, qth, start, maxdt) + 0.001;   // +1.5 min
+        return find_done(evals, aostime);
 
-    /* invalid time (potentially returned by find_aos) */
-    if (t < 0.01)
-        return 0.0;
+    /* step backwards; reversing time reverses the elevation rate */
+    while (sat->el >= 0.0)
+    {
+        if (evals >= FIND_MAX_EVALS)
+            return find_done(evals, 0.0);
 
-    /* update satellite data */
-    predict_calc(sat, qth, t);
+        dt = find_step(sat, -eldot);
+        aostime -= dt;
+        eldot = find_eval(sat, qth, aostime, &evals);
+    }
+
+    aostime = find_root(sat, qth, aostime, aostime + dt, aostime, eldot,
+                        TRUE, &evals);
+
+    return find_done(evals, aostime);
+}
+
+/**
+ * \brief Size of the memory block holding a pass.
+ * \param num The number of detail entries.
+ * \param satname The satellite name or NULL.
+ */
+static gsize pass_size(guint num, const gchar * satname)
+{
+    return sizeof(pass_t) + num * sizeof(pass_detail_t) +
+        ((satname != NULL) ? strlen(satname) + 1 : 0);
+}
+
+/**
+ * \brief Set up the details and the name in the block of a pass.
+ * \param pass The pass, allocated with pass_size(num, satname) bytes.
+ * \param num The number of detail entries.
+ * \param satname The satellite name or NULL.
+ *
+ * The details follow the pass_t structure and the name follows the details.
+ * The entries of the details are not initialised.
+ */
+static void init_pass_block(pass_t * pass, guint num, const gchar * satname)
+{
+    pass->num_details = num;
+    pass->details = (pass_detail_t *) (pass + 1);
+
+    if (satname != NULL)
+        pass->satname = strcpy((gchar *) (pass->details + num), satname);
+    else
+        pass->satname = NULL;
+}
 
-    /* use upper time limit */
-    if (maxdt > 0.0)
+/**
+ * \brief Allocate a pass with room for its details.
+ * \param num The number of detail entries.
+ * \param satname The satellite name or NULL.
+ * \return A zero-filled pass that must be freed with free_pass.
+ */
+static pass_t  *alloc_pass(guint num, const gchar * satname)
+{
+    pass_t         *pass = g_malloc0(pass_size(num, satname));
+
+    init_pass_block(pass, num, satname);
+
+    return pass;
+}
+
+/**
+ * \brief Evaluate the visibility conditions of the satellite.
+ * \param sat The satellite; its data will be corrupt.
+ * \param qth The observer.
+ * \param t The time.
+ * \param thld The twilight threshold [deg].
+ * \param evals The propagation counter.
+ * \return A combination of VIS_ECLIPSED and VIS_DARK.
+ */
+static guint vis_eval(sat_t * sat, qth_t * qth, gdouble t, gdouble thld,
+                      guint * evals)
+{
+    vector_t        sun;
+    gdouble         sun_el;
+    gdouble         depth;
+    guint           state = 0;
+
+    find_eval(sat, qth, t, evals);
+    get_sun_pos(qth, t, &sun, &sun_el);
+
+    if (Sat_Eclipsed(&sat->pos, &sun, &depth))
+        state |= VIS_ECLIPSED;
+
+    if (sun_el <= thld)
+        state |= VIS_DARK;
+
+    return state;
+}
+
+/** \brief Visibility of a satellite above the horizon. */
+static sat_vis_t vis_state(guint state)
+{
+    if (state & VIS_ECLIPSED)
+        return SAT_VIS_ECLIPSED;
+
+    if (state & VIS_DARK)
+        return SAT_VIS_VISIBLE;
+
+    return SAT_VIS_DAYLIGHT;
+}
+
+/**
+ * \brief Find the time at which a visibility condition changes.
+ * \param state The conditions at t0; the condition in mask differs at t1.
+ * \param mask The condition, VIS_ECLIPSED or VIS_DARK.
+ *
+ * The umbra entry or exit and the crossing of the twilight threshold are
+ * found by bisection down to FIND_TIME_TOL.
+ */
+static gdouble vis_root(sat_t * sat, qth_t * qth, gdouble t0, gdouble t1,
+                        guint state, guint mask, gdouble thld, guint * evals)
+{
+    gdouble         t;
+
+    while (t1 - t0 > FIND_TIME_TOL && *evals < FIND_MAX_EVALS)
     {
-        /* coarse steps */
-        while ((sat->el >= 1.0) && (t <= (start + maxdt)))
+        t = 0.5 * (t0 + t1);
+        if ((vis_eval(sat, qth, t, thld, evals) & mask) == (state & mask))
+            t0 = t;
+        else
+            t1 = t;
+    }
+
+    return 0.5 * (t0 + t1);
+}
+
+/** \brief Start a new visibility segment at t unless nothing changes. */
+static void add_vis_segment(vis_segments_t * segs, gdouble t, sat_vis_t vis)
+{
+    if (segs->num > 0 && segs->vis[segs->num - 1] == vis)
+        return;
+
+    if (segs->num == VIS_MAX_SEGMENTS)
+        return;
+
+    segs->start[segs->num] = t;
+    segs->vis[segs->num] = vis;
+    segs->num++;
+}
+
+/**
+ * \brief Split a pass into segments of constant visibility.
+ * \param sat The satellite; its data will be corrupt.
+ * \param qth The observer.
+ * \param aos The AOS time of the pass.
+ * \param los The LOS time of the pass.
+ * \param segs Location where the segments are stored.
+ *
+ * The eclipse and twilight conditions are checked at least every
+ * VIS_MAX_STEP and the exact times at which they change are found by
+ * bisection. This assumes that each condition changes at most once per
+ * interval; only grazing eclipses shorter than VIS_MAX_STEP can be missed.
+ * Short LEO passes thus cost a few propagations instead of a solar and
+ * eclipse computation for each detail entry.
+ */
+static void find_vis_segments(sat_t * sat, qth_t * qth, gdouble aos,
+                              gdouble los, vis_segments_t * segs)
+{
+    gdouble         thld = sat_cfg_get_int(SAT_CFG_INT_PRED_TWILIGHT_THLD);
+    gdouble         t0, t1, dt;
+    gdouble         te, td;
+    guint           state0, state1, change;
+    guint           evals = 0;
+    guint           i, n;
+
+    n = (guint) ceil((los - aos) / VIS_MAX_STEP);
+    n = CLAMP(n, 1, FIND_MAX_EVALS / 4);
+    dt = (los - aos) / n;
+
+    segs->num = 0;
+    state0 = vis_eval(sat, qth, aos, thld, &evals);
+    add_vis_segment(segs, aos, vis_state(state0));
+
+    t0 = aos;
+    for (i = 1; i <= n; i++)
+    {
+        t1 = (i == n) ? los : aos + i * dt;
+        state1 = vis_eval(sat, qth, t1, thld, &evals);
+        change = state0 ^ state1;
+
+        if (change == VIS_ECLIPSED || change == VIS_DARK)
         {
-            t += cos((sat->el - 1.0) * de2ra) * sqrt(sat->alt) / 25000.0;
-            predict_calc(sat, qth, t);
+            te = vis_root(sat, qth, t0, t1, state0, change, thld, &evals);
+            add_vis_segment(segs, te, vis_state(state1));
         }
-
-        /* fine steps */
-        while ((lostime == 0.0) && (t <= (start + maxdt)))
+        else if (change != 0)
         {
-            t += sat->el * sqrt(sat->alt) / 502500.0;
-            predict_calc(sat, qth, t);
+            /* both conditions change; keep them in order */
+            te = vis_root(sat, qth, t0, t1, state0, VIS_ECLIPSED, thld,
+                          &evals);
+            td = vis_root(sat, qth, t0, t1, state0, VIS_DARK, thld, &evals);
+            if (te < td)
+                add_vis_segment(segs, te, vis_state(state0 ^ VIS_ECLIPSED));
+            else
+                add_vis_segment(segs, td, vis_state(state0 ^ VIS_DARK));
+            add_vis_segment(segs, MAX(te, td), vis_state(state1));
+        }
 
-            if (fabs(sat->el) < 0.005)
-            {
-                /* Two things are true at LOS time, the elevation is a zero and
-                   sat is descending. This checks that those two are true. */
-                eltemp = sat->el;
+        state0 = state1;
+        t0 = t1;
+    }
+}
+
+/**
+ * \brief Store the visibility of a pass.
+ * \param pass The pass with aos and los set.
+ * \param segs The visibility segments of the pass.
+ *
+ * Sets the visibility string and the first window in which the satellite
+ * is optically visible.
+ */
+static void set_pass_vis(pass_t * pass, vis_segments_t * segs)
+{
+    guint           i;
 
-                /* check elevation 1 second earlier */
-                predict_calc(sat, qth, t - 1.0 / 86400.0);
+    pass->vis[0] = '-';
+    pass->vis[1] = '-';
+    pass->vis[2] = '-';
+    pass->vis[3] = 0;
+    pass->vis_start = 0.0;
+    pass->vis_end = 0.0;
 
-                if (sat->el > eltemp)
-                    lostime = t;
+    for (i = 0; i < segs->num; i++)
+    {
+        switch (segs->vis[i])
+        {
+        case SAT_VIS_VISIBLE:
+            pass->vis[0] = 'V';
+            if (pass->vis_start == 0.0)
+            {
+                pass->vis_start = segs->start[i];
+                pass->vis_end = (i + 1 < segs->num) ?
+                    segs->start[i + 1] : pass->los;
             }
+            break;
+        case SAT_VIS_DAYLIGHT:
+            pass->vis[1] = 'D';
+            break;
+        case SAT_VIS_ECLIPSED:
+            pass->vis[2] = 'E';
+            break;
+        default:
+            break;
         }
     }
-    /* don't use upper limit */
-    else
+}
+
+/**
+ * \brief Calculate a pass with its details.
+ * \param sat The satellite; its data will be corrupt.
+ * \param qth The observer.
+ * \param aos The AOS time of the pass.
+ * \param los The LOS time of the pass.
+ * \return The pass, which must be freed with free_pass.
+ *
+ * The pass is sampled with the configured number of entries, but not with
+ * a coarser resolution than SAT_CFG_INT_PRED_RESOLUTION.
+ */
+static pass_t  *sample_pass(sat_t * sat, qth_t * qth, gdouble aos,
+                            gdouble los)
+{
+    gdouble         tca = 0.0;  /* time of TCA */
+    gdouble         dt;         /* time diff */
+    gdouble         step;       /* time step */
+    gdouble         t;          /* current time counter */
+    gdouble         tres;       /* required time resolution */
+    gdouble         max_el = 0.0;       /* maximum elevation */
+    pass_t         *pass;
+    pass_detail_t  *detail;
+    vis_segments_t  segs;       /* visibility of the pass */
+    guint           seg = 0;    /* visibility segment of the entry */
+    guint           i, num;     /* detail index and count */
+
+    /* get time resolution; sat-cfg stores it in seconds */
+    tres = sat_cfg_get_int(SAT_CFG_INT_PRED_RESOLUTION) / 86400.0;
+
+    dt = los - aos;
+
+    /* get time step, which will give us the max number of entries */
+    step = dt / sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_ENTRIES);
+
+    /* but if this is smaller than the required resolution
+       we go with the resolution
+     */
+    if (step < tres)
+        step = tres;
+
+    /* count the entries so that they can be allocated together
+       with the pass */
+    num = 0;
+    for (t = aos; t <= los; t += step)
+        num++;
+
+    pass = alloc_pass(num, sat->nickname);
+
+    pass->aos = aos;
+    pass->los = los;
+    pass->max_el = 0.0;
+    pass->aos_az = 0.0;
+    pass->los_az = 0.0;
+    pass->maxel_az = 0.0;
+    /*copy qth data into the pass for later comparisons */
+    qth_small_save(qth, &(pass->qth_comp));
+
+    /* visibility windows; the entries are looked up in them */
+    find_vis_segments(sat, qth, aos, los, &segs);
+    set_pass_vis(pass, &segs);
+
+    /* iterate over each time step */
+    for (i = 0, t = pass->aos; i < num; i++, t += step)
     {
-        /* coarse steps */
-        while (sat->el >= 1.0)
+
+        /* calculate satellite data */
+        predict_calc(sat, qth, t);
+
+        /* in the first iter we want to store
+           pass->aos_az
+         */
+        if (t == pass->aos)
         {
-            t += cos((sat->el - 1.0) * de2ra) * sqrt(sat->alt) / 25000.0;
-            predict_calc(sat, qth, t);
+            pass->aos_az = sat->az;
+            pass->orbit = sat->orbit;
         }
 
-        /* fine steps */
-        while (lostime == 0.0)
+        /* store details */
+        detail = &pass->details[i];
+        detail->time = t;
+        detail->pos.x = sat->pos.x;
+        detail->pos.y = sat->pos.y;
+        detail->pos.z = sat->pos.z;
+        detail->pos.w = sat->pos.w;
+        detail->vel.x = sat->vel.x;
+        detail->vel.y = sat->vel.y;
+        detail->vel.z = sat->vel.z;
+        detail->vel.w = sat->vel.w;
+        detail->velo = sat->velo;
+        detail->az = sat->az;
+        detail->el = sat->el;
+        detail->range = sat->range;
+        detail->range_rate = sat->range_rate;
+        detail->lat = sat->ssplat;
+        detail->lon = sat->ssplon;
+        detail->alt = sat->alt;
+        detail->ma = sat->ma;
+        detail->phase = sat->phase;
+        detail->footprint = sat->footprint;
+        detail->orbit = sat->orbit;
+        while (seg + 1 < segs.num && segs.start[seg + 1] <= t)
+            seg++;
+        detail->vis = segs.vis[seg];
+
+        /* store elevation if greater than the
+           previously stored one
+         */
+        if (sat->el > max_el)
         {
-            t += sat->el * sqrt(sat->alt) / 502500.0;
-            predict_calc(sat, qth, t);
-
-            if (fabs(sat->el) < 0.005)
-            {
-                /* two things are true at LOS time
-                   The elevation is a zero and descending.
-                   This checks that those two are true.
-                 */
-                eltemp = sat->el;
-
-                /*check elevation 1 second earlier */
-                predict_calc(sat, qth, t - 1.0 / 86400.0);
-
-                if (sat->el > eltemp)
-                    lostime = t;
-            }
+            max_el = sat->el;
+            tca = t;
+            pass->maxel_az = sat->az;
         }
+
+        /*     g_print ("TIME: %f\tAZ: %f\tEL: %f (MAX: %f)\n", */
+        /*           t, sat->az, sat->el, max_el); */
     }
 
-    return lostime;
+    /* calculate satellite data */
+    predict_calc(sat, qth, pass->los);
+    /* store los_az, max_el and tca */
+    pass->los_az = sat->az;
+    pass->max_el = max_el;
+    pass->tca = tca;
+
+    return pass;
 }
 
 /**
- * \brief Find AOS time of current pass.
- * \param sat The satellite to find AOS for.
- * \param qth The ground station.
- * \param start Start time, prefereably now.
- * \return The time of the previous AOS or 0.0 if the satellite has no AOS.
+ * \brief Calculate the summary of a pass.
+ * \param sat The satellite; its data will be corrupt.
+ * \param qth The observer.
+ * \param aos The AOS time of the pass.
+ * \param los The LOS time of the pass.
+ * \return The pass without details, which must be freed with free_pass.
  *
- * This function can be used to find the AOS time in the past of the
- * current pass.
+ * Instead of sampling the whole pass, the elevation rate is evaluated at
+ * SUMMARY_STEPS intervals and the TCA is found by bisection as the root of
+ * the elevation rate in the interval with the highest elevation. The
+ * visibility is found the same way as for a pass with details.
  */
-gdouble find_prev_aos(sat_t * sat, qth_t * qth, gdouble start)
+static pass_t  *summarize_pass(sat_t * sat, qth_t * qth, gdouble aos,
+                               gdouble los)
 {
-    gdouble         aostime = start;
+    gdouble         t0 = aos;
+    gdouble         t1 = los;
+    gdouble         t, dt;
+    gdouble         eldot, prev = 0.0;
+    gdouble         el, prev_el = 0.0;
+    gdouble         max_el = -90.0;
+    guint           evals = 0;
+    guint           i;
+    vis_segments_t  segs;
+    pass_t         *pass = alloc_pass(0, sat->nickname);
 
-    /* make sure current sat values are in sync with the time */
-    predict_calc(sat, qth, start);
+    pass->aos = aos;
+    pass->los = los;
+    qth_small_save(qth, &(pass->qth_comp));
 
-    /* check whether satellite has aos */
-    if (!has_aos(sat, qth))
+    /* coarse scan; long passes may have more than one maximum */
+    dt = (los - aos) / SUMMARY_STEPS;
+    for (i = 0; i <= SUMMARY_STEPS; i++)
     {
-        return 0.0;
+        t = aos + i * dt;
+        eldot = find_eval(sat, qth, t, &evals);
+        el = MAX(sat->el, prev_el);
+
+        if (i > 0 && prev > 0.0 && eldot <= 0.0 && el > max_el)
+        {
+            max_el = el;
+            t0 = t - dt;
+            t1 = t;
+        }
+
+        prev = eldot;
+        prev_el = sat->el;
     }
 
-    while (sat->el >= 0.0)
+    /* the elevation rises until TCA and falls after it */
+    while (t1 - t0 > FIND_TIME_TOL && evals < FIND_MAX_EVALS)
     {
-        aostime -= 0.0005;      // 0.75 min
-        predict_calc(sat, qth, aostime);
+        t = 0.5 * (t0 + t1);
+        if (find_eval(sat, qth, t, &evals) > 0.0)
+            t0 = t;
+        else
+            t1 = t;
     }
 
-    return aostime;
+    pass->tca = 0.5 * (t0 + t1);
+
+    find_eval(sat, qth, pass->tca, &evals);
+    pass->max_el = sat->el;
+    pass->maxel_az = sat->az;
+
+    find_eval(sat, qth, aos, &evals);
+    pass->aos_az = sat->az;
+    pass->orbit = sat->orbit;
+
+    find_eval(sat, qth, los, &evals);
+    pass->los_az = sat->az;
+
+    find_vis_segments(sat, qth, aos, los, &segs);
+    set_pass_vis(pass, &segs);
+
+    return pass;
 }
 
 /**
@@ -396,6 +1123,17 @@ GSList         *get_next_passes(sat_t * sat, qth_t * qth, gdouble maxdt,
     return get_passes(sat, qth, now, maxdt, num);
 }
 
+/** \brief The minimum elevation of the passes returned by get_pass. */
+static gdouble get_min_el(void)
+{
+    int      min_ele = sat_cfg_get_int(SAT_CFG_INT_PRED_MIN_EL);
+
+    if (min_ele == 0)
+        min_ele = 1;
+
+    return min_ele;
+}
+
 /**
  * \brief Predict first pass after a certain time.
  * \param sat Pointer to the satellite data.
@@ -410,29 +1148,82 @@ GSList         *get_next_passes(sat_t * sat, qth_t * qth, gdouble maxdt,
  */
 pass_t *get_pass(sat_t * sat_in, qth_t * qth, gdouble start, gdouble maxdt)
 {
-    int      min_ele = sat_cfg_get_int(SAT_CFG_INT_PRED_MIN_EL);
-
-    if (min_ele == 0)
-        min_ele = 1;
+    return get_pass_engine(sat_in, qth, start, maxdt, get_min_el(), TRUE);
+}
 
-    return get_pass_engine(sat_in, qth, start, maxdt, min_ele);
+/**
+ * \brief Predict first pass after a certain time ignoring the min elevation.
+ * \param sat Pointer to the satellite data.
+ * \param qth Pointer to the location data.
+ * \param start Starting time.
+ * \param maxdt The maximum number of days to look ahead (0 for no limit).
+ * \return Pointer to a newly allocated pass_t structure or NULL if
+ *         there was an error.
+ * This function assumes that you want a pass that achieves the 
+ * minimum elevation of is configured for.
+ */
+pass_t         *get_pass_no_min_el(sat_t * sat_in, qth_t * qth, gdouble start,
+                                   gdouble maxdt)
+{
+    return get_pass_engine(sat_in, qth, start, maxdt, 0.0, TRUE);
 }
 
 /**
- * \brief Predict first pass after a certain time ignoring the min elevation.
+ * \brief Predict the summary of the first pass after a certain time.
  * \param sat Pointer to the satellite data.
  * \param qth Pointer to the location data.
  * \param start Starting time.
  * \param maxdt The maximum number of days to look ahead (0 for no limit).
  * \return Pointer to a newly allocated pass_t structure or NULL if
  *         there was an error.
- * This function assumes that you want a pass that achieves the 
- * minimum elevation of is configured for.
+ *
+ * Same as get_pass but the pass has no details, only AOS, TCA, LOS, the
+ * azimuths, the maximum elevation, the orbit and the visibility. This is
+ * much cheaper to calculate; use get_pass_details to get the details
+ * later on.
  */
-pass_t         *get_pass_no_min_el(sat_t * sat_in, qth_t * qth, gdouble start,
-                                   gdouble maxdt)
+pass_t         *get_pass_summary(sat_t * sat, qth_t * qth, gdouble start,
+                                 gdouble maxdt)
+{
+    return get_pass_engine(sat, qth, start, maxdt, get_min_el(), FALSE);
+}
+
+/**
+ * \brief Predict the summary of the next pass.
+ * \param sat Pointer to the satellite data.
+ * \param qth Pointer to the observer data.
+ * \param maxdt The maximum number of days to look ahead.
+ * \return Pointer newly allocated pass_t structure without details or NULL
+ *         if no pass can be found.
+ *
+ * Same as get_next_pass but using get_pass_summary.
+ */
+pass_t         *get_next_pass_summary(sat_t * sat, qth_t * qth, gdouble maxdt)
+{
+    return get_pass_summary(sat, qth, get_current_daynum(), maxdt);
+}
+
+/**
+ * \brief Calculate the details of a pass.
+ * \param sat Pointer to the satellite data.
+ * \param qth Pointer to the observer data.
+ * \param pass The pass, e.g. from get_pass_summary.
+ * \return A newly allocated copy of the pass with its details, which must be
+ *         freed with free_pass.
+ *
+ * The details are sampled the same way as by get_pass. If the pass already
+ * has details, it is simply copied.
+ */
+pass_t         *get_pass_details(sat_t * sat, qth_t * qth, pass_t * pass)
 {
-    return get_pass_engine(sat_in, qth, start, maxdt, 0.0);
+    sat_t           sat_working;
+
+    if (pass->num_details > 0)
+        return copy_pass(pass);
+
+    memcpy(&sat_working, sat, sizeof(sat_t));
+
+    return sample_pass(&sat_working, qth, pass->aos, pass->los);
 }
 
 /**
@@ -453,52 +1244,72 @@ pass_t         *get_pass_no_min_el(sat_t * sat_in, qth_t * qth, gdouble start,
  *       by the caller, if the caller will need it later on (eg. if the caller
  *       is GtkSatList).
  *
- * \note Prepending to a singly linked list is much faster than appending.
- *       Therefore, the elements are prepended whereafter the GSList is
- *       reversed
+ * \note The result is taken from the pass cache if the same prediction has
+ *       been made before; see pass-cache.c.
+ *
+ * If details is FALSE, only the summary of the pass is calculated; see
+ * summarize_pass.
  */
 static pass_t  *get_pass_engine(sat_t * sat_in, qth_t * qth, gdouble start,
-                                gdouble maxdt, gdouble min_el)
+                                gdouble maxdt, gdouble min_el,
+                                gboolean details)
 {
     gdouble         aos = 0.0;  /* time of AOS */
-    gdouble         tca = 0.0;  /* time of TCA */
     gdouble         los = 0.0;  /* time of LOS */
-    gdouble         dt = 0.0;   /* time diff */
-    gdouble         step = 0.0; /* time step */
     gdouble         t0 = start;
-    gdouble         t;          /* current time counter */
-    gdouble         tres = 0.0; /* required time resolution */
-    gdouble         max_el = 0.0;       /* maximum elevation */
+    gdouble         tlos;       /* start of the LOS search */
     pass_t         *pass = NULL;
-    pass_detail_t  *detail = NULL;
     gboolean        done = FALSE;
     guint           iter = 0;   /* number of iterations */
+    guint           evals = 0;
+    gboolean        in_range;   /* whether a pass is in progress at t0 */
     sat_t          *sat, sat_working;
 
-    /* FIXME: watchdog */
+    if (pass_cache_lookup(sat_in, qth, start, maxdt, min_el, details, &pass))
+        return pass;
 
-    /*copy sat_in to a working structure */
+    /* copy sat_in to a working structure; the propagation constants
+       are shared, only the mutable state is copied */
     sat = memcpy(&sat_working, sat_in, sizeof(sat_t));
 
-    /* get time resolution; sat-cfg stores it in seconds */
-    tres = sat_cfg_get_int(SAT_CFG_INT_PRED_RESOLUTION) / 86400.0;
-
-    /* loop until we find a pass with elevation > SAT_CFG_INT_PRED_MIN_EL
-       or we run out of time
-       FIXME: we should have a safety break
+    /* loop until we find a pass with elevation > SAT_CFG_INT_PRED_MIN_EL,
+       we run out of time or PASS_MAX_ITER passes have been too low
      */
     while (!done)
     {
-        /* Find los of next pass or of current pass */
-        los = find_los(sat, qth, t0, maxdt);    // See if a pass is ongoing
+        /* skip the time in which the satellite cannot make a pass */
+        t0 = next_pass_window(sat, qth, t0,
+                              (maxdt > 0.0) ? start + maxdt : 0.0, min_el);
+        if (t0 == 0.0)
+            break;
+
+        /* Find los of next pass or of current pass; for the next pass the
+           search continues from its AOS instead of stepping over it again */
+        find_eval(sat, qth, t0, &evals);
+        in_range = (sat->el >= 0.0);
         aos = find_aos(sat, qth, t0, start + maxdt - t0);
+        tlos = (in_range || aos == 0.0) ? t0 : aos;
+        los = find_los(sat, qth, tlos, maxdt);
+
+        /* the pass may end after the time window; without its LOS we
+           would continue from t0 = 0.014 */
+        if (los == 0.0 && maxdt > 0.0)
+            los = find_los(sat, qth, tlos, 0.0);
 
         if (aos > los)
             // los is from an currently happening pass, find previous aos
             aos = find_prev_aos(sat, qth, t0);
+        else if (aos == 0.0 && los > 0.0)
+        {
+            /* no AOS in the time window but a pass may be in progress;
+               find_prev_aos returns t0 if it is not */
+            aos = find_prev_aos(sat, qth, t0);
+            if (aos >= t0)
+                aos = 0.0;
+        }
 
-        /* aos = 0.0 means no aos */
-        if (aos == 0.0)
+        /* aos = 0.0 means no aos, los = 0.0 that it could not be found */
+        if (aos == 0.0 || los == 0.0)
             done = TRUE;
 
         /* check whether we are within time limits;
@@ -511,119 +1322,13 @@ static pass_t  *get_pass_engine(sat_t * sat_in, qth_t * qth, gdouble start,
         else
         {
             //los = find_los (sat, qth, aos + 0.001, maxdt); // +1.5 min later
-            dt = los - aos;
-
-            /* get time step, which will give us the max number of entries */
-            step = dt / sat_cfg_get_int(SAT_CFG_INT_PRED_NUM_ENTRIES);
-
-            /* but if this is smaller than the required resolution
-               we go with the resolution
-             */
-            if (step < tres)
-                step = tres;
-
-            /* create a pass_t entry; FIXME: g_try_new in 2.8 */
-            pass = g_new(pass_t, 1);
-
-            pass->aos = aos;
-            pass->los = los;
-            pass->max_el = 0.0;
-            pass->aos_az = 0.0;
-            pass->los_az = 0.0;
-            pass->maxel_az = 0.0;
-            pass->vis[0] = '-';
-            pass->vis[1] = '-';
-            pass->vis[2] = '-';
-            pass->vis[3] = 0;
-            pass->satname = g_strdup(sat->nickname);
-            pass->details = NULL;
-            /*copy qth data into the pass for later comparisons */
-            qth_small_save(qth, &(pass->qth_comp));
-
-            /* iterate over each time step */
-            for (t = pass->aos; t <= pass->los; t += step)
-            {
-
-                /* calculate satellite data */
-                predict_calc(sat, qth, t);
-
-                /* in the first iter we want to store
-                   pass->aos_az
-                 */
-                if (t == pass->aos)
-                {
-                    pass->aos_az = sat->az;
-                    pass->orbit = sat->orbit;
-                }
-
-                /* append details to sat->details */
-                detail = g_new(pass_detail_t, 1);
-                detail->time = t;
-                detail->pos.x = sat->pos.x;
-                detail->pos.y = sat->pos.y;
-                detail->pos.z = sat->pos.z;
-                detail->pos.w = sat->pos.w;
-                detail->vel.x = sat->vel.x;
-                detail->vel.y = sat->vel.y;
-                detail->vel.z = sat->vel.z;
-                detail->vel.w = sat->vel.w;
-                detail->velo = sat->velo;
-                detail->az = sat->az;
-                detail->el = sat->el;
-                detail->range = sat->range;
-                detail->range_rate = sat->range_rate;
-                detail->lat = sat->ssplat;
-                detail->lon = sat->ssplon;
-                detail->alt = sat->alt;
-                detail->ma = sat->ma;
-                detail->phase = sat->phase;
-                detail->footprint = sat->footprint;
-                detail->orbit = sat->orbit;
-                detail->vis = get_sat_vis(sat, qth, t);
-
-                /* also store visibility "bit" */
-                switch (detail->vis)
-                {
-                case SAT_VIS_VISIBLE:
-                    pass->vis[0] = 'V';
-                    break;
-                case SAT_VIS_DAYLIGHT:
-                    pass->vis[1] = 'D';
-                    break;
-                case SAT_VIS_ECLIPSED:
-                    pass->vis[2] = 'E';
-                    break;
-                default:
-                    break;
-                }
-
-                pass->details = g_slist_prepend(pass->details, detail);
-
-                /* store elevation if greater than the
-                   previously stored one
-                 */
-                if (sat->el > max_el)
-                {
-                    max_el = sat->el;
-                    tca = t;
-                    pass->maxel_az = sat->az;
-                }
-
-                /*     g_print ("TIME: %f\tAZ: %f\tEL: %f (MAX: %f)\n", */
-                /*           t, sat->az, sat->el, max_el); */
-            }
-
-            pass->details = g_slist_reverse(pass->details);
-
-            /* calculate satellite data */
-            predict_calc(sat, qth, pass->los);
-            /* store los_az, max_el and tca */
-            pass->los_az = sat->az;
-            pass->max_el = max_el;
-            pass->tca = tca;
+            if (details)
+                pass = sample_pass(sat, qth, aos, los);
+            else
+                pass = summarize_pass(sat, qth, aos, los);
 
             /* check whether this pass is good */
-            if (max_el >= min_el)
+            if (pass->max_el >= min_el)
             {
                 done = TRUE;
             }
@@ -635,10 +1340,18 @@ static pass_t  *get_pass_engine(sat_t * sat_in, qth_t * qth, gdouble start,
                 pass = NULL;
             }
 
-            iter++;
+            if (++iter >= PASS_MAX_ITER && !done)
+            {
+                sat_log_log(SAT_LOG_LEVEL_DEBUG,
+                            _("%s: Gave up on %s after %u passes below %.1f"),
+                            __func__, sat->nickname, iter, min_el);
+                done = TRUE;
+            }
         }
     }
 
+    pass_cache_store(sat_in, qth, start, maxdt, min_el, details, pass);
+
     return pass;
 }
 
@@ -662,6 +1375,24 @@ static pass_t  *get_pass_engine(sat_t * sat_in, qth_t * qth, gdouble start,
  */
 GSList         *get_passes(sat_t * sat, qth_t * qth, gdouble start,
                            gdouble maxdt, guint num)
+{
+    return get_passes_engine(sat, qth, start, maxdt, num, TRUE);
+}
+
+/**
+ * \brief Predict the summaries of passes after a certain time.
+ *
+ * Same as get_passes but the passes have no details; see get_pass_summary.
+ */
+GSList         *get_passes_summary(sat_t * sat, qth_t * qth, gdouble start,
+                                   gdouble maxdt, guint num)
+{
+    return get_passes_engine(sat, qth, start, maxdt, num, FALSE);
+}
+
+/** \brief Predict passes with or without details; see get_passes. */
+static GSList  *get_passes_engine(sat_t * sat, qth_t * qth, gdouble start,
+                                  gdouble maxdt, guint num, gboolean details)
 {
     GSList         *passes = NULL;
     pass_t         *pass = NULL;
@@ -677,7 +1408,7 @@ GSList         *get_passes(sat_t * sat, qth_t * qth, gdouble start,
 
     for (i = 0; i < num; i++)
     {
-        pass = get_pass(sat, qth, t, maxdt);
+        pass = get_pass_engine(sat, qth, t, maxdt, get_min_el(), details);
 
         if (pass != NULL)
         {
@@ -711,52 +1442,441 @@ GSList         *get_passes(sat_t * sat, qth_t * qth, gdouble start,
     return passes;
 }
 
-pass_t         *copy_pass(pass_t * pass)
+/**
+ * \brief Topocentric data of a propagated satellite.
+ * \param sat Pointer to the satellite data with up to date position and
+ *            velocity.
+ * \param frame The observer frame at sat->jul_utc.
+ *
+ * Only the azimuth, elevation, range and range rate are updated, which is
+ * all that is needed to look at one propagated position from several
+ * ground stations.
+ */
+static void calc_topo(sat_t * sat, const obs_frame_t * frame)
 {
-    pass_t         *new;
+    obs_set_t       obs_set;
 
-    new = g_try_new(pass_t, 1);
+    Calculate_Frame_Obs(frame, &sat->pos, &sat->vel, &obs_set);
 
-    if (new != NULL)
+    sat->az = Degrees(obs_set.az);
+    sat->el = Degrees(obs_set.el);
+    sat->range = obs_set.range;
+    sat->range_rate = obs_set.range_rate;
+}
+
+/**
+ * \brief Propagate once and look at the satellite from several observers.
+ * \param sat Pointer to the satellite data.
+ * \param qths Array of nqth ground stations.
+ * \param nqth The number of ground stations.
+ * \param active The ground stations to look from.
+ * \param t The time (Julian Date).
+ * \param el Array receiving the elevation for each ground station [deg].
+ * \param eldot Array receiving the elevation rate [deg/day].
+ * \return The time step to the next evaluation, the smallest search step
+ *         of all ground stations.
+ */
+static gdouble multi_eval(sat_t * sat, qth_t ** qths, guint nqth,
+                          const gboolean * active, gdouble t, gdouble * el,
+                          gdouble * eldot)
+{
+    obs_frame_t     frame;
+    gboolean        propagated = FALSE;
+    gdouble         step = G_MAXDOUBLE;
+    guint           i;
+
+    for (i = 0; i < nqth; i++)
     {
-        new->aos = pass->aos;
-        new->los = pass->los;
-        new->tca = pass->tca;
-        new->max_el = pass->max_el;
-        new->aos_az = pass->aos_az;
-        new->los_az = pass->los_az;
-        new->orbit = pass->orbit;
-        new->maxel_az = pass->maxel_az;
-        new->vis[0] = pass->vis[0];
-        new->vis[1] = pass->vis[1];
-        new->vis[2] = pass->vis[2];
-        new->vis[3] = pass->vis[3];
-        new->details = copy_pass_details(pass->details);
-
-        if (pass->satname != NULL)
-            new->satname = g_strdup(pass->satname);
+        if (!active[i])
+            continue;
+
+        predict_obs_frame(qths[i], t, &frame);
+
+        if (!propagated)
+        {
+            predict_calc_frame(sat, &frame);
+            propagated = TRUE;
+        }
         else
-            new->satname = NULL;
+        {
+            calc_topo(sat, &frame);
+        }
+
+        el[i] = sat->el;
+        eldot[i] = calc_eldot(sat, &frame);
+        step = MIN(step, find_step(sat, eldot[i]));
     }
 
-    return new;
+    return step;
+}
+
+/**
+ * \brief Refine a horizon crossing found by the multi-station search.
+ * \param a The time before the crossing.
+ * \param b The time after the crossing.
+ */
+static gdouble multi_root(sat_t * sat, qth_t * qth, gdouble a, gdouble b,
+                          gboolean rising)
+{
+    guint           evals = 0;
+    gdouble         eldot;
+
+    eldot = find_eval(sat, qth, b, &evals);
+
+    return find_root(sat, qth, a, b, b, eldot, rising, &evals);
 }
 
-GSList         *copy_pass_details(GSList * details)
+/** \brief AOS or LOS of a pass, used to find the mutual windows. */
+typedef struct {
+    gdouble         t;          /*!< Time of the event */
+    guint           qth;        /*!< Index of the ground station */
+    gboolean        aos;        /*!< TRUE for AOS, FALSE for LOS */
+} multi_event_t;
+
+static gint compare_multi_events(gconstpointer a, gconstpointer b)
 {
-    GSList         *new = NULL;
-    guint           i, n;
+    const multi_event_t *ea = a;
+    const multi_event_t *eb = b;
+
+    if (ea->t < eb->t)
+        return -1;
+
+    return (ea->t > eb->t) ? 1 : 0;
+}
+
+/** \brief Number of ground stations in a mask. */
+static guint count_qths(guint32 mask)
+{
+    guint           n = 0;
+
+    for (; mask != 0; mask &= mask - 1)
+        n++;
+
+    return n;
+}
+
+/**
+ * \brief Find the windows in which several ground stations see a satellite.
+ * \param passes Array of nqth pass lists.
+ * \param nqth The number of ground stations.
+ * \return List of mutual_window_t, one for each period in which the same
+ *         two or more ground stations see the satellite.
+ */
+static GSList  *find_mutual_windows(GSList ** passes, guint nqth)
+{
+    GArray         *events;
+    GSList         *windows = NULL;
+    GSList         *node;
+    multi_event_t   ev;
+    multi_event_t  *e;
+    mutual_window_t *win = NULL;
+    guint32         mask = 0;
+    guint32         next;
+    guint           i;
+
+    events = g_array_new(FALSE, FALSE, sizeof(multi_event_t));
+
+    for (i = 0; i < nqth; i++)
+    {
+        for (node = passes[i]; node != NULL; node = node->next)
+        {
+            ev.qth = i;
+            ev.t = PASS(node->data)->aos;
+            ev.aos = TRUE;
+            g_array_append_val(events, ev);
+            ev.t = PASS(node->data)->los;
+            ev.aos = FALSE;
+            g_array_append_val(events, ev);
+        }
+    }
+
+    g_array_sort(events, compare_multi_events);
+
+    for (i = 0; i < events->len; i++)
+    {
+        e = &g_array_index(events, multi_event_t, i);
+        next = e->aos ? (mask | (1u << e->qth)) : (mask & ~(1u << e->qth));
+
+        if (next == mask)
+            continue;
+
+        if (win != NULL)
+        {
+            win->end = e->t;
+            if (win->end > win->start)
+                windows = g_slist_prepend(windows, win);
+            else
+                g_free(win);
+            win = NULL;
+        }
+
+        if (count_qths(next) >= 2)
+        {
+            win = g_new(mutual_window_t, 1);
+            win->start = e->t;
+            win->qths = next;
+        }
+
+        mask = next;
+    }
+
+    /* the passes end with a LOS, so there is no open window left */
+    g_free(win);
+    g_array_free(events, TRUE);
+
+    return g_slist_reverse(windows);
+}
+
+/**
+ * \brief Predict the passes of a satellite over several ground stations.
+ * \param sat Pointer to the satellite data.
+ * \param qths Array of nqth ground stations.
+ * \param nqth The number of ground stations, at most MULTI_QTH_MAX.
+ * \param start The start time.
+ * \param maxdt The number of days to look ahead, must be positive.
+ * \param mutual Location where the mutual visibility windows are stored,
+ *               or NULL. Each entry is a mutual_window_t that must be freed
+ *               with g_free.
+ * \return Array of nqth lists, one per ground station, with the passes that
+ *         are in progress at start or have AOS no later than start+maxdt;
+ *         free it with free_passes_multi. The passes have no details; see
+ *         get_pass_summary.
+ *
+ * This gives the same passes as calling get_passes_summary for each ground
+ * station, but the satellite is propagated only once per time step of the
+ * search and the step is shared: the elevation for the other ground
+ * stations is a topocentric transformation of the same position. Only the
+ * refinement of the AOS and LOS times and the pass summaries are done for
+ * each ground station. Like find_los, the search for the LOS of a pass
+ * gives up after FIND_MAX_EVALS steps; as with get_passes_summary, that
+ * pass and all later ones are left out for the ground station.
+ */
+GSList        **get_passes_multi(sat_t * sat_in, qth_t ** qths, guint nqth,
+                                 gdouble start, gdouble maxdt,
+                                 GSList ** mutual)
+{
+    sat_t           sat_working;
+    sat_t          *sat;
+    GSList        **passes;
+    pass_t         *pass;
+    gboolean       *active;
+    gdouble        *el, *eldot, *el_next, *eldot_next, *aos, *tmp;
+    guint          *evals;      /* steps since the AOS of the open pass */
+    gdouble         min_el = get_min_el();
+    gdouble         end = start + maxdt;
+    gdouble         t, tnext, tw, w, step, step_next, root;
+    gboolean        jumped;
+    guint           nactive = 0, nopen;
+    guint           i;
+
+    if (nqth > MULTI_QTH_MAX)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Too many ground stations (%d)"), __func__, nqth);
+        nqth = MULTI_QTH_MAX;
+    }
+
+    passes = g_new0(GSList *, nqth);
+    active = g_new0(gboolean, nqth);
+    el = g_new0(gdouble, nqth);
+    eldot = g_new0(gdouble, nqth);
+    el_next = g_new0(gdouble, nqth);
+    eldot_next = g_new0(gdouble, nqth);
+    aos = g_new0(gdouble, nqth);
+    evals = g_new0(guint, nqth);
+
+    sat = memcpy(&sat_working, sat_in, sizeof(sat_t));
 
-    n = g_slist_length(details);
-    for (i = 0; i < n; i++)
+    for (i = 0; i < nqth; i++)
     {
-        new = g_slist_prepend(new,
-                              copy_pass_detail(PASS_DETAIL
-                                               (g_slist_nth_data
-                                                (details, i))));
+        active[i] = has_aos(sat, qths[i]);
+        if (active[i])
+            nactive++;
+    }
+
+    t = start;
+    step = multi_eval(sat, qths, nqth, active, t, el, eldot);
+    jumped = TRUE;
+
+    while (nactive > 0 && maxdt > 0.0)
+    {
+        /* passes in progress at the start or after skipping ahead */
+        nopen = 0;
+        for (i = 0; i < nqth; i++)
+        {
+            if (jumped && active[i] && el[i] >= 0.0 && aos[i] == 0.0)
+            {
+                aos[i] = find_prev_aos(sat, qths[i], t);
+                evals[i] = 0;
+            }
+            if (aos[i] > 0.0)
+                nopen++;
+        }
+        jumped = FALSE;
+
+        if (nopen == 0)
+        {
+            if (t >= end)
+                break;
+
+            /* skip the time in which no ground station can see a pass */
+            tw = G_MAXDOUBLE;
+            for (i = 0; i < nqth; i++)
+            {
+                w = active[i] ?
+                    next_pass_window(sat, qths[i], t, end, min_el) : 0.0;
+                if (w > 0.0)
+                    tw = MIN(tw, w);
+            }
+
+            if (tw == G_MAXDOUBLE)
+                break;
+
+            if (tw > t)
+            {
+                t = tw;
+                step = multi_eval(sat, qths, nqth, active, t, el, eldot);
+                jumped = TRUE;
+                continue;
+            }
+        }
+
+        tnext = t + step;
+        step_next = multi_eval(sat, qths, nqth, active, tnext, el_next,
+                               eldot_next);
+
+        for (i = 0; i < nqth; i++)
+        {
+            if (!active[i])
+                continue;
+
+            if (el[i] < 0.0 && el_next[i] >= 0.0)
+            {
+                /* passes starting after the window are not wanted */
+                root = multi_root(sat, qths[i], t, tnext, TRUE);
+                if (root <= end)
+                {
+                    aos[i] = root;
+                    evals[i] = 0;
+                }
+            }
+            else if (el[i] >= 0.0 && el_next[i] < 0.0 && aos[i] > 0.0)
+            {
+                root = multi_root(sat, qths[i], t, tnext, FALSE);
+                pass = summarize_pass(sat, qths[i], aos[i], root);
+                if (pass->max_el >= min_el)
+                    passes[i] = g_slist_prepend(passes[i], pass);
+                else
+                    free_pass(pass);
+                aos[i] = 0.0;
+            }
+            else if (aos[i] > 0.0 && ++evals[i] > FIND_MAX_EVALS)
+            {
+                /* the pass does not end, e.g. a satellite near GEO */
+                aos[i] = 0.0;
+                active[i] = FALSE;
+                nactive--;
+            }
+        }
+
+        tmp = el;
+        el = el_next;
+        el_next = tmp;
+        tmp = eldot;
+        eldot = eldot_next;
+        eldot_next = tmp;
+        step = step_next;
+        t = tnext;
     }
 
-    new = g_slist_reverse(new);
+    for (i = 0; i < nqth; i++)
+        passes[i] = g_slist_reverse(passes[i]);
+
+    if (mutual != NULL)
+        *mutual = find_mutual_windows(passes, nqth);
+
+    g_free(active);
+    g_free(el);
+    g_free(eldot);
+    g_free(el_next);
+    g_free(eldot_next);
+    g_free(aos);
+    g_free(evals);
+
+    return passes;
+}
+
+/**
+ * \brief Free the result of get_passes_multi.
+ * \param passes The array of pass lists.
+ * \param nqth The number of ground stations.
+ */
+void free_passes_multi(GSList ** passes, guint nqth)
+{
+    guint           i;
+
+    if (passes == NULL)
+        return;
+
+    for (i = 0; i < nqth; i++)
+        free_passes(passes[i]);
+
+    g_free(passes);
+}
+
+/**
+ * \brief Get a pass detail entry.
+ * \param pass The pass.
+ * \param i The index of the entry.
+ * \return Pointer to entry i of the details, or NULL if i is out of range.
+ */
+pass_detail_t  *pass_get_detail(pass_t * pass, guint i)
+{
+    if (pass == NULL || i >= pass->num_details)
+        return NULL;
+
+    return &pass->details[i];
+}
+
+/**
+ * \brief Get the pass details as a list.
+ * \param pass The pass.
+ * \return A newly allocated list of pointers to the entries of the details.
+ *
+ * This is for code written against the former GSList details. The entries
+ * belong to the pass; free the list with g_slist_free only and do not use
+ * it after the pass has been freed.
+ */
+GSList         *pass_get_details_list(pass_t * pass)
+{
+    GSList         *list = NULL;
+    guint           i;
+
+    for (i = pass->num_details; i > 0; i--)
+        list = g_slist_prepend(list, &pass->details[i - 1]);
+
+    return list;
+}
+
+/**
+ * \brief Copy a pass.
+ * \param pass The pass to copy.
+ * \return A newly allocated copy of the pass including its details, or NULL
+ *         if the memory could not be allocated.
+ */
+pass_t         *copy_pass(pass_t * pass)
+{
+    pass_t         *new;
+
+    new = g_try_malloc(pass_size(pass->num_details, pass->satname));
+
+    if (new != NULL)
+    {
+        *new = *pass;
+        init_pass_block(new, pass->num_details, pass->satname);
+        memcpy(new->details, pass->details,
+               pass->num_details * sizeof(pass_detail_t));
+    }
 
     return new;
 }
@@ -794,42 +1914,16 @@ pass_detail_t  *copy_pass_detail(pass_detail_t * detail)
     return new;
 }
 
+/** \brief Free a pass including its details. */
 void free_pass(pass_t * pass)
 {
-    if (pass != NULL)
-    {
-        free_pass_details(pass->details);
-
-        if (pass->satname != NULL)
-        {
-            g_free(pass->satname);
-            pass->satname = NULL;
-        }
-
-        g_free(pass);
-        pass = NULL;
-    }
+    g_free(pass);
 }
 
 /** \brief Free a list of passes. */
 void free_passes(GSList * passes)
 {
-    guint           n, i;
-    gpointer        pass;
-
-    n = g_slist_length(passes);
-
-    for (i = 0; i < n; i++)
-    {
-        pass = g_slist_nth_data(passes, i);
-
-        /* free element data */
-        free_pass(PASS(pass));
-    }
-
-    /* now free the list elements */
-    g_slist_free(passes);
-    passes = NULL;
+    g_slist_free_full(passes, (GDestroyNotify) free_pass);
 }
 
 /**
@@ -844,28 +1938,6 @@ void free_pass_detail(pass_detail_t * detail)
     detail = NULL;
 }
 
-/** Free the whole list of details. */
-void free_pass_details(GSList * details)
-{
-    guint           n, i;
-    gpointer        detail;
-
-    n = g_slist_length(details);
-
-    for (i = 0; i < n; i++)
-    {
-
-        detail = g_slist_nth_data(details, i);
-
-        /* free element data */
-        free_pass_detail(PASS_DETAIL(detail));
-    }
-
-    /* free list elements */
-    g_slist_free(details);
-    details = NULL;
-}
-
 /**
  * \brief Get current pass.
  * \param sat Pointer to the satellite data.
@@ -890,7 +1962,8 @@ pass_t         *get_current_pass(sat_t * sat_in, qth_t * qth, gdouble start)
     sat_t          *sat, sat_working;
     pass_t         *pass;
 
-    /*copy sat_in to a working structure */
+    /* copy sat_in to a working structure; the propagation constants
+       are shared, only the mutable state is copied */
     sat = memcpy(&sat_working, sat_in, sizeof(sat_t));
 
     if (start > 0.0)
@@ -29,27 +29,12 @@
 #define PREDICT_TOOLS_H 1
 
 #include <glib.h>
+#include "ephem-cache.h"
 #include "gtk-sat-data.h"
 #include "sat-vis.h"
 #include "sgpsdp/sgp4sdp4.h"
 
 
-/** \brief Brief satellite pass info. */
-typedef struct {
-    gchar      *satname;  /*!< satellite name */
-    gdouble     aos;      /*!< AOS time in "jul_utc" */
-    gdouble     tca;      /*!< TCA time in "jul_utc" */
-    gdouble     los;      /*!< LOS time in "jul_utc" */
-    gdouble     max_el;   /*!< Maximum elevation during pass */
-    gdouble     aos_az;   /*!< Azimuth at AOS */
-    gdouble     los_az;   /*!< Azimuth at LOS */
-    gint        orbit;    /*!< Orbit number */
-    gdouble     maxel_az; /*!< Azimuth at maximum elevation */
-    gchar       vis[4];   /*!< Visibility string, e.g. VSE, -S-, V-- */
-    GSList     *details;  /*!< List of pass_detail_t entries */
-    qth_small_t qth_comp; /*!< Short version of qth at time computed */
-} pass_t;
-
 /**
  * \brief Pass detail entry.
  *
@@ -78,20 +63,70 @@ typedef struct {
     gint      orbit;
 } pass_detail_t;
 
+/**
+ * \brief Brief satellite pass info.
+ *
+ * The pass, its details and the satellite name are allocated as one block
+ * by get_pass and copy_pass and must be freed with free_pass. Passes from
+ * get_pass_summary have no details (num_details = 0).
+ */
+typedef struct {
+    gchar      *satname;  /*!< satellite name */
+    gdouble     aos;      /*!< AOS time in "jul_utc" */
+    gdouble     tca;      /*!< TCA time in "jul_utc" */
+    gdouble     los;      /*!< LOS time in "jul_utc" */
+    gdouble     max_el;   /*!< Maximum elevation during pass */
+    gdouble     aos_az;   /*!< Azimuth at AOS */
+    gdouble     los_az;   /*!< Azimuth at LOS */
+    gint        orbit;    /*!< Orbit number */
+    gdouble     maxel_az; /*!< Azimuth at maximum elevation */
+    gchar       vis[4];   /*!< Visibility string, e.g. VSE, -S-, V-- */
+    gdouble     vis_start; /*!< Start of the first visible window, 0 if none */
+    gdouble     vis_end;  /*!< End of the first visible window */
+    qth_small_t qth_comp; /*!< Short version of qth at time computed */
+    guint       num_details; /*!< Number of entries in details */
+    pass_detail_t *details;  /*!< Array of num_details entries */
+} pass_t;
+
+/** \brief Maximum number of ground stations for get_passes_multi. */
+#define MULTI_QTH_MAX 32
+
+/**
+ * \brief Window in which several ground stations see a satellite.
+ *
+ * Bit i of qths is set for ground station i of get_passes_multi. The set of
+ * ground stations is the same during the whole window.
+ */
+typedef struct {
+    gdouble     start;    /*!< Start of the window in "jul_utc" */
+    gdouble     end;      /*!< End of the window in "jul_utc" */
+    guint32     qths;     /*!< The ground stations seeing the satellite */
+} mutual_window_t;
+
 /* type casting macros */
 #define PASS(x) ((pass_t *) x)
 #define PASS_DETAIL(x) ((pass_detail_t *) x)
 
 /* SGP4/SDP4 driver */
 void predict_calc (sat_t *sat, qth_t *qth, gdouble t);
+void predict_obs_frame (qth_t *qth, gdouble t, obs_frame_t *frame);
+void predict_calc_frame (sat_t *sat, const obs_frame_t *frame);
+void predict_calc_multi (sgp4_multi_t *blocks, guint nblocks,
+                         const obs_frame_t *frame);
+void predict_calc_ephem (sat_t *sat, ephem_cache_t *cache,
+                         const obs_frame_t *frame);
+void predict_ssp_series (sat_t *sat, const gdouble *t, guint num,
+                         gdouble *lat, gdouble *lon, glong *orbit);
 
 /* AOS/LOS time calculators */
 gdouble find_aos           (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt);
 gdouble find_los           (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt);
 gdouble find_prev_aos      (sat_t *sat, qth_t *qth, gdouble start);
+guint   get_find_evals     (void);
 
 /* next events */
 pass_t *get_next_pass      (sat_t *sat, qth_t *qth, gdouble maxdt);
+pass_t *get_next_pass_summary (sat_t *sat, qth_t *qth, gdouble maxdt);
 GSList *get_next_passes    (sat_t *sat, qth_t *qth, gdouble maxdt, guint num);
 
 /* future events */
@@ -100,15 +135,26 @@ GSList *get_passes         (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt
 pass_t *get_current_pass   (sat_t *sat, qth_t *qth, gdouble start);
 pass_t *get_pass_no_min_el (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt);
 
+/* pass summaries without details */
+pass_t *get_pass_summary   (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt);
+GSList *get_passes_summary (sat_t *sat, qth_t *qth, gdouble start, gdouble maxdt, guint num);
+pass_t *get_pass_details   (sat_t *sat, qth_t *qth, pass_t *pass);
+
+/* several ground stations */
+GSList **get_passes_multi  (sat_t *sat, qth_t **qths, guint nqth, gdouble start, gdouble maxdt, GSList **mutual);
+void     free_passes_multi (GSList **passes, guint nqth);
+
+/* pass details */
+pass_detail_t *pass_get_detail       (pass_t *pass, guint i);
+GSList        *pass_get_details_list (pass_t *pass);
+
 /* copying */
 pass_t        *copy_pass         (pass_t *pass);
-GSList        *copy_pass_details (GSList *details);
 pass_detail_t *copy_pass_detail  (pass_detail_t *detail);
 
 /* memory cleaning */
 void free_pass         (pass_t *pass);
 void free_passes       (GSList *passes);
 void free_pass_detail  (pass_detail_t *detail);
-void free_pass_details (GSList *details);
 
 #endif
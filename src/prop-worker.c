@@ -0,0 +1,430 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Background propagation of the satellites of a module.
+ *
+ * The worker thread keeps its own independent copy of every satellite, the
+ * back buffer. While the main loop is busy with the current cycle, the
+ * worker propagates the back buffer to the time of the next cycle. When that
+ * cycle starts, prop_worker_fetch copies the results into the satellites of
+ * the module, the front buffer, which are read by the views. The copy is done
+ * while the worker is idle, so the views never see a partially updated
+ * satellite and the main loop does not run SGP4/SDP4 for the module.
+ *
+ * The time of the next cycle is only an estimate. If the actual time or the
+ * observer position is different, the result is dropped and the caller has
+ * to propagate the satellites itself.
+ *
+ * When the ephemeris cache is enabled the worker evaluates its own caches
+ * of the back buffer instead of running SGP4/SDP4 directly.
+ *
+ * All functions must be called from the main loop thread.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <math.h>
+
+#include "ephem-cache.h"
+#include "predict-tools.h"
+#include "prop-worker.h"
+#include "sat-cfg.h"
+#include "sat-log.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/** \brief State of the back buffer. */
+typedef enum {
+    PROP_IDLE = 0,              /*!< Nothing requested */
+    PROP_PENDING,               /*!< Requested, not started yet */
+    PROP_BUSY,                  /*!< Being propagated by the worker */
+    PROP_READY                  /*!< Propagated, can be fetched */
+} prop_state_t;
+
+struct _prop_worker {
+    GThread        *thread;     /*!< The worker thread, NULL if not running */
+    GMutex          lock;       /*!< Protects all fields below */
+    GCond           cond;       /*!< Signalled when the state changes */
+    prop_state_t    state;      /*!< State of the back buffer */
+    gboolean        quit;       /*!< Set to stop the worker thread */
+    guint           nsats;      /*!< Number of satellites */
+    sat_t         **front;      /*!< The satellites of the module */
+    sat_t          *back;       /*!< Independent copies of the satellites */
+    GArray         *blocks;     /*!< Near-earth back satellites as sgp4_multi_t */
+    ephem_cache_t **caches;     /*!< Ephemeris caches of the back satellites */
+    qth_t           qth;        /*!< Observer position of the request */
+    gdouble         t;          /*!< Time of the request [jul_utc] */
+    gdouble         span;       /*!< Cache segment length of the request [days], 0 for no cache */
+    gdouble         tol;        /*!< Cache tolerance of the request [km] */
+};
+
+
+/**
+ * \brief Get the ephemeris cache of a back satellite.
+ *
+ * The cache is created on first use and created again when the segment
+ * length or tolerance of the request differ from its own.
+ */
+static ephem_cache_t *get_cache(prop_worker_t * worker, guint i)
+{
+    ephem_cache_t  *cache = worker->caches[i];
+
+    if (cache != NULL &&
+        (cache->span != worker->span || cache->tol != worker->tol))
+    {
+        ephem_cache_free(cache);
+        cache = NULL;
+    }
+
+    if (cache == NULL)
+    {
+        cache = ephem_cache_new(worker->span, worker->tol);
+        worker->caches[i] = cache;
+    }
+
+    return cache;
+}
+
+/** \brief Propagate the back buffer; called without holding the lock. */
+static void propagate(prop_worker_t * worker)
+{
+    obs_frame_t     frame;
+    guint           i;
+
+    predict_obs_frame(&worker->qth, worker->t, &frame);
+
+    if (worker->span > 0.0)
+    {
+        for (i = 0; i < worker->nsats; i++)
+            predict_calc_ephem(&worker->back[i], get_cache(worker, i),
+                               &frame);
+
+        return;
+    }
+
+    predict_calc_multi((sgp4_multi_t *) worker->blocks->data,
+                       worker->blocks->len, &frame);
+
+    for (i = 0; i < worker->nsats; i++)
+    {
+        if (worker->back[i].flags & DEEP_SPACE_EPHEM_FLAG)
+            predict_calc_frame(&worker->back[i], &frame);
+    }
+}
+
+/** \brief Worker thread function. */
+static gpointer prop_worker_run(gpointer data)
+{
+    prop_worker_t  *worker = data;
+
+    g_mutex_lock(&worker->lock);
+
+    for (;;)
+    {
+        while (!worker->quit && worker->state != PROP_PENDING)
+            g_cond_wait(&worker->cond, &worker->lock);
+
+        if (worker->quit)
+            break;
+
+        worker->state = PROP_BUSY;
+        g_mutex_unlock(&worker->lock);
+
+        propagate(worker);
+
+        g_mutex_lock(&worker->lock);
+        worker->state = PROP_READY;
+        g_cond_broadcast(&worker->cond);
+    }
+
+    g_mutex_unlock(&worker->lock);
+
+    return NULL;
+}
+
+/** \brief Wait until the worker is not using the back buffer. */
+static void wait_not_busy(prop_worker_t * worker)
+{
+    while (worker->state == PROP_BUSY)
+        g_cond_wait(&worker->cond, &worker->lock);
+}
+
+/** \brief Free the back buffer; the lock must be held. */
+static void free_sats(prop_worker_t * worker)
+{
+    guint           i;
+
+    for (i = 0; i < worker->nsats; i++)
+    {
+        free_ephemeris(&worker->back[i]);
+        if (worker->caches[i] != NULL)
+            ephem_cache_free(worker->caches[i]);
+    }
+
+    g_free(worker->caches);
+    g_free(worker->back);
+    g_free(worker->front);
+    worker->caches = NULL;
+    worker->back = NULL;
+    worker->front = NULL;
+    worker->nsats = 0;
+    g_array_set_size(worker->blocks, 0);
+}
+
+/**
+ * \brief Copy the propagated state of a satellite.
+ *
+ * Only the fields that are set by the propagation are copied; AOS, LOS and
+ * everything else belongs to the module.
+ */
+static void copy_state(sat_t * dest, const sat_t * src)
+{
+    dest->pos = src->pos;
+    dest->vel = src->vel;
+    dest->jul_utc = src->jul_utc;
+    dest->tsince = src->tsince;
+    dest->az = src->az;
+    dest->el = src->el;
+    dest->range = src->range;
+    dest->range_rate = src->range_rate;
+    dest->ssplat = src->ssplat;
+    dest->ssplon = src->ssplon;
+    dest->alt = src->alt;
+    dest->velo = src->velo;
+    dest->ma = src->ma;
+    dest->footprint = src->footprint;
+    dest->phase = src->phase;
+    dest->meanmo = src->meanmo;
+    dest->orbit = src->orbit;
+}
+
+/**
+ * \brief Create a propagation worker.
+ *
+ * If the thread can not be started, the worker never has any results and
+ * the caller propagates the satellites itself.
+ */
+prop_worker_t  *prop_worker_new(void)
+{
+    prop_worker_t  *worker;
+    GError         *err = NULL;
+
+    worker = g_new0(prop_worker_t, 1);
+    g_mutex_init(&worker->lock);
+    g_cond_init(&worker->cond);
+    worker->blocks = g_array_new(FALSE, FALSE, sizeof(sgp4_multi_t));
+
+    worker->thread = g_thread_try_new("gpredict_prop", prop_worker_run,
+                                      worker, &err);
+    if (err != NULL)
+    {
+        sat_log_log(SAT_LOG_LEVEL_ERROR,
+                    _("%s: Failed to create propagation thread (%s)"),
+                    __func__, err->message);
+        g_clear_error(&err);
+    }
+
+    return worker;
+}
+
+/** \brief Stop the worker thread and free the worker. */
+void prop_worker_free(prop_worker_t * worker)
+{
+    if (worker == NULL)
+        return;
+
+    g_mutex_lock(&worker->lock);
+    worker->quit = TRUE;
+    g_cond_broadcast(&worker->cond);
+    g_mutex_unlock(&worker->lock);
+
+    if (worker->thread != NULL)
+        g_thread_join(worker->thread);
+
+    free_sats(worker);
+    g_array_free(worker->blocks, TRUE);
+    g_mutex_clear(&worker->lock);
+    g_cond_clear(&worker->cond);
+    g_free(worker);
+}
+
+/**
+ * \brief Set the satellites to propagate.
+ * \param worker The worker.
+ * \param sats Hash table with the satellites of the module, or NULL.
+ *
+ * Must be called every time the satellites are (re)loaded. Any result that
+ * has not been fetched yet is dropped.
+ */
+void prop_worker_set_sats(prop_worker_t * worker, GHashTable * sats)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    sgp4_multi_t    block;
+    sat_t          *sat;
+    guint           i;
+
+    g_mutex_lock(&worker->lock);
+    wait_not_busy(worker);
+
+    free_sats(worker);
+    worker->state = PROP_IDLE;
+
+    if (sats != NULL && g_hash_table_size(sats) > 0)
+    {
+        worker->nsats = g_hash_table_size(sats);
+        worker->front = g_new(sat_t *, worker->nsats);
+        worker->back = g_new0(sat_t, worker->nsats);
+        worker->caches = g_new0(ephem_cache_t *, worker->nsats);
+
+        i = 0;
+        g_hash_table_iter_init(&iter, sats);
+        while (g_hash_table_iter_next(&iter, NULL, &value))
+        {
+            sat = SAT(value);
+            worker->front[i] = sat;
+            clone_ephemeris(&worker->back[i], sat);
+
+            /* the worker has no use for the strings of the module */
+            worker->back[i].name = NULL;
+            worker->back[i].nickname = NULL;
+            worker->back[i].website = NULL;
+            i++;
+        }
+
+        /* the blocks point into back, which is not reallocated */
+        SGP4_Multi_Init(&block);
+        for (i = 0; i < worker->nsats; i++)
+        {
+            if (worker->back[i].flags & DEEP_SPACE_EPHEM_FLAG)
+                continue;
+
+            SGP4_Multi_Add(&block, &worker->back[i]);
+            if (block.num == SGP4_MULTI_LANES)
+            {
+                g_array_append_val(worker->blocks, block);
+                SGP4_Multi_Init(&block);
+            }
+        }
+
+        if (block.num > 0)
+            g_array_append_val(worker->blocks, block);
+    }
+
+    g_mutex_unlock(&worker->lock);
+}
+
+/**
+ * \brief Start propagating the satellites to a given time.
+ * \param worker The worker.
+ * \param qth The observer.
+ * \param t The time, usually the expected time of the next cycle.
+ *
+ * Does nothing if the worker is still busy with a previous request.
+ */
+void prop_worker_request(prop_worker_t * worker, qth_t * qth, gdouble t)
+{
+    if (worker->thread == NULL)
+        return;
+
+    g_mutex_lock(&worker->lock);
+
+    if (worker->state != PROP_BUSY && worker->nsats > 0)
+    {
+        /* only the position is used by the propagation */
+        worker->qth.lat = qth->lat;
+        worker->qth.lon = qth->lon;
+        worker->qth.alt = qth->alt;
+        worker->t = t;
+
+        /* the configuration is only read in the main loop */
+        if (sat_cfg_get_bool(SAT_CFG_BOOL_EPHEM_CACHE))
+        {
+            worker->span = sat_cfg_get_int(SAT_CFG_INT_EPHEM_CACHE_SPAN) /
+                86400.0;
+            worker->tol = sat_cfg_get_int(SAT_CFG_INT_EPHEM_CACHE_TOL) /
+                1000.0;
+        }
+        else
+        {
+            worker->span = 0.0;
+        }
+
+        worker->state = PROP_PENDING;
+        g_cond_broadcast(&worker->cond);
+    }
+
+    g_mutex_unlock(&worker->lock);
+}
+
+/**
+ * \brief Copy the propagated satellites into the satellites of the module.
+ * \param worker The worker.
+ * \param qth The observer of the current cycle.
+ * \param t The time of the current cycle.
+ * \param tol The largest acceptable difference between t and the requested
+ *            time [days].
+ * \return TRUE if the satellites of the module have been updated, FALSE if
+ *         there was no matching request and the caller has to propagate the
+ *         satellites itself.
+ *
+ * If a matching request is still being propagated, this waits for it; the
+ * worker has a head start, so that is never slower than propagating here.
+ */
+gboolean prop_worker_fetch(prop_worker_t * worker, qth_t * qth, gdouble t,
+                           gdouble tol)
+{
+    gboolean        match;
+    guint           i;
+
+    g_mutex_lock(&worker->lock);
+
+    match = (worker->state != PROP_IDLE &&
+             fabs(worker->t - t) <= tol &&
+             worker->qth.lat == qth->lat &&
+             worker->qth.lon == qth->lon && worker->qth.alt == qth->alt);
+
+    if (match)
+    {
+        while (worker->state != PROP_READY)
+            g_cond_wait(&worker->cond, &worker->lock);
+
+        for (i = 0; i < worker->nsats; i++)
+            copy_state(worker->front[i], &worker->back[i]);
+    }
+
+    /* a result that does not match is of no use later either */
+    if (worker->state == PROP_READY)
+        worker->state = PROP_IDLE;
+
+    g_mutex_unlock(&worker->lock);
+
+    return match;
+}
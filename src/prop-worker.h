@@ -0,0 +1,47 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef PROP_WORKER_H
+#define PROP_WORKER_H 1
+
+#include <glib.h>
+#include "gtk-sat-data.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+/** \brief Background propagation of a set of satellites; opaque. */
+typedef struct _prop_worker prop_worker_t;
+
+prop_worker_t  *prop_worker_new(void);
+void            prop_worker_free(prop_worker_t * worker);
+void            prop_worker_set_sats(prop_worker_t * worker,
+                                     GHashTable * sats);
+void            prop_worker_request(prop_worker_t * worker, qth_t * qth,
+                                    gdouble t);
+gboolean        prop_worker_fetch(prop_worker_t * worker, qth_t * qth,
+                                  gdouble t, gdouble tol);
+
+#endif
@@ -132,7 +132,8 @@ sat_cfg_bool_t  sat_cfg_bool[SAT_CFG_BOOL_NUM] = {
     {"TLE", "PROXY_AUTH", FALSE},
     {"TLE", "ADD_NEW_SATS", TRUE},
     {"LOG", "KEEP_LOG_FILES", FALSE},
-    {"PREDICT", "USE_REAL_T0", FALSE}
+    {"PREDICT", "USE_REAL_T0", FALSE},
+    {"MODULES", "EPHEM_CACHE", FALSE}
 };
 
 /** Array containing the integer configuration parameters */
@@ -206,7 +207,10 @@ sat_cfg_int_t   sat_cfg_int[SAT_CFG_INT_NUM] = {
     {"TLE", "AUTO_UPDATE_ACTION", 1},   /* notify, see tle_auto_upd_action_t */
     {"TLE", "LAST_UPDATE", 0},
     {"LOG", "CLEAN_AGE", 0},    /* 0 = Never clean */
-    {"LOG", "LEVEL", 2}
+    {"LOG", "LEVEL", 2},
+    {"MODULES", "EPHEM_CACHE_SPAN", 600},
+    {"MODULES", "EPHEM_CACHE_TOL", 100},
+    {"MODULES", "PROFILE_LOG", 0}
 };
 
 /** Array containing the string configuration values */
@@ -248,6 +252,141 @@ sat_cfg_str_t   sat_cfg_str[SAT_CFG_STR_NUM] = {
 /* The configuration data buffer */
 static GKeyFile *config = NULL;
 
+/* Protects config; the pass prediction workers read it concurrently */
+G_LOCK_DEFINE_STATIC(config);
+
+/*
+ * Typed copies of the values in config.
+ *
+ * The getters are called in hot paths, e.g. by the pass predictions and the
+ * cell renderers of the satellite list, so the values are parsed once when
+ * the configuration is loaded and kept up to date by the setters. The bool
+ * and int values are accessed atomically and can be read without the lock;
+ * the strings are protected by the config lock.
+ */
+static gint     bool_cache[SAT_CFG_BOOL_NUM];
+static gint     int_cache[SAT_CFG_INT_NUM];
+static gchar   *str_cache[SAT_CFG_STR_NUM];
+static gboolean cache_valid = FALSE;
+
+/* A registered change notification */
+typedef struct {
+    guint           id;
+    sat_cfg_notify_cb func;
+    gpointer        data;
+} sat_cfg_notify_t;
+
+static GSList  *notifiers = NULL;
+static guint    next_notify_id = 1;
+
+/** Read a boolean value from config; the lock must be held. */
+static gboolean fetch_bool(sat_cfg_bool_e param)
+{
+    gboolean        value;
+    GError         *error = NULL;
+
+    value = g_key_file_get_boolean(config, sat_cfg_bool[param].group,
+                                   sat_cfg_bool[param].key, &error);
+    if (error != NULL)
+    {
+        g_clear_error(&error);
+        value = sat_cfg_bool[param].defval;
+    }
+
+    return value;
+}
+
+/** Read an integer value from config; the lock must be held. */
+static gint fetch_int(sat_cfg_int_e param)
+{
+    gint            value;
+    GError         *error = NULL;
+
+    value = g_key_file_get_integer(config, sat_cfg_int[param].group,
+                                   sat_cfg_int[param].key, &error);
+    if (error != NULL)
+    {
+        g_clear_error(&error);
+        value = sat_cfg_int[param].defval;
+    }
+
+    return value;
+}
+
+/** Read a string value from config; the lock must be held. */
+static gchar   *fetch_str(sat_cfg_str_e param)
+{
+    gchar          *value;
+    GError         *error = NULL;
+
+    value = g_key_file_get_string(config, sat_cfg_str[param].group,
+                                  sat_cfg_str[param].key, &error);
+    if (error != NULL)
+    {
+        g_clear_error(&error);
+        value = g_strdup(sat_cfg_str[param].defval);
+    }
+
+    return value;
+}
+
+/** Fill the typed cache from config. */
+static void fill_cache(void)
+{
+    guint           i;
+
+    G_LOCK(config);
+
+    for (i = 0; i < SAT_CFG_BOOL_NUM; i++)
+        g_atomic_int_set(&bool_cache[i], fetch_bool(i));
+
+    for (i = 0; i < SAT_CFG_INT_NUM; i++)
+        g_atomic_int_set(&int_cache[i], fetch_int(i));
+
+    for (i = 0; i < SAT_CFG_STR_NUM; i++)
+    {
+        g_free(str_cache[i]);
+        str_cache[i] = fetch_str(i);
+    }
+
+    cache_valid = TRUE;
+
+    G_UNLOCK(config);
+}
+
+/** Free the cached strings and mark the cache invalid. */
+static void clear_cache(void)
+{
+    guint           i;
+
+    G_LOCK(config);
+
+    cache_valid = FALSE;
+    for (i = 0; i < SAT_CFG_STR_NUM; i++)
+    {
+        g_free(str_cache[i]);
+        str_cache[i] = NULL;
+    }
+
+    G_UNLOCK(config);
+}
+
+/** Call the registered change notifications. */
+static void notify(sat_cfg_type_e type, guint param)
+{
+    GSList         *node;
+    GSList         *next;
+    sat_cfg_notify_t *n;
+
+    /* a callback may remove itself */
+    for (node = notifiers; node != NULL; node = next)
+    {
+        next = node->next;
+        n = node->data;
+        n->func(type, param, n->data);
+    }
+}
+
 /**
  * Load configuration data.
  * @return 0 if everything OK, 1 otherwise.
@@ -275,6 +414,9 @@ guint sat_cfg_load()
                               &error);
     g_free(keyfile);
 
+    /* the built-in defaults are cached if the file could not be read */
+    fill_cache();
+
     if (error != NULL)
     {
         sat_log_log(SAT_LOG_LEVEL_WARN,
@@ -360,7 +502,9 @@ guint sat_cfg_save()
 
     confdir = get_user_conf_dir();
     keyfile = g_strconcat(confdir, G_DIR_SEPARATOR_S, "gpredict.cfg", NULL);
+    G_LOCK(config);
     err = gpredict_save_key_file(config, keyfile);
+    G_UNLOCK(config);
     g_free(confdir);
 
     return err;
@@ -377,6 +521,8 @@ guint sat_cfg_save()
  */
 void sat_cfg_close()
 {
+    clear_cache();
+
     if (config != NULL)
     {
         g_key_file_free(config);
@@ -388,7 +534,6 @@ void sat_cfg_close()
 gboolean sat_cfg_get_bool(sat_cfg_bool_e param)
 {
     gboolean        value = FALSE;
-    GError         *error = NULL;
 
     if (param < SAT_CFG_BOOL_NUM)
     {
@@ -400,18 +545,16 @@ gboolean sat_cfg_get_bool(sat_cfg_bool_e param)
             /* return default value */
             value = sat_cfg_bool[param].defval;
         }
+        else if (cache_valid)
+        {
+            value = g_atomic_int_get(&bool_cache[param]);
+        }
         else
         {
             /* fetch value */
-            value = g_key_file_get_boolean(config,
-                                           sat_cfg_bool[param].group,
-                                           sat_cfg_bool[param].key, &error);
-
-            if (error != NULL)
-            {
-                g_clear_error(&error);
-                value = sat_cfg_bool[param].defval;
-            }
+            G_LOCK(config);
+            value = fetch_bool(param);
+            G_UNLOCK(config);
         }
 
     }
@@ -448,10 +591,12 @@ gboolean sat_cfg_get_bool_def(sat_cfg_bool_e param)
  * @param value The value of the parameter.
  *
  * This function stores a boolean configuration value in the configuration
- * table.
+ * table. The change notifications are called if the value has changed.
  */
 void sat_cfg_set_bool(sat_cfg_bool_e param, gboolean value)
 {
+    gboolean        old;
+
     if (param < SAT_CFG_BOOL_NUM)
     {
         if (config == NULL)
@@ -461,9 +606,17 @@ void sat_cfg_set_bool(sat_cfg_bool_e param, gboolean value)
         }
         else
         {
+            old = sat_cfg_get_bool(param);
+
+            G_LOCK(config);
             g_key_file_set_boolean(config,
                                    sat_cfg_bool[param].group,
                                    sat_cfg_bool[param].key, value);
+            g_atomic_int_set(&bool_cache[param], value);
+            G_UNLOCK(config);
+
+            if (old != value)
+                notify(SAT_CFG_TYPE_BOOL, param);
         }
     }
     else
@@ -475,6 +628,8 @@ void sat_cfg_set_bool(sat_cfg_bool_e param, gboolean value)
 
 void sat_cfg_reset_bool(sat_cfg_bool_e param)
 {
+    gboolean        old;
+
     if (param < SAT_CFG_BOOL_NUM)
     {
         if (config == NULL)
@@ -484,9 +639,17 @@ void sat_cfg_reset_bool(sat_cfg_bool_e param)
         }
         else
         {
+            old = sat_cfg_get_bool(param);
+
+            G_LOCK(config);
             g_key_file_remove_key(config,
                                   sat_cfg_bool[param].group,
                                   sat_cfg_bool[param].key, NULL);
+            g_atomic_int_set(&bool_cache[param], sat_cfg_bool[param].defval);
+            G_UNLOCK(config);
+
+            if (old != sat_cfg_bool[param].defval)
+                notify(SAT_CFG_TYPE_BOOL, param);
         }
 
     }
@@ -505,7 +668,6 @@ void sat_cfg_reset_bool(sat_cfg_bool_e param)
 gchar          *sat_cfg_get_str(sat_cfg_str_e param)
 {
     gchar          *value;
-    GError         *error = NULL;
 
     if (param < SAT_CFG_STR_NUM)
     {
@@ -520,14 +682,12 @@ gchar          *sat_cfg_get_str(sat_cfg_str_e param)
         else
         {
             /* fetch value */
-            value = g_key_file_get_string(config,
-                                          sat_cfg_str[param].group,
-                                          sat_cfg_str[param].key, &error);
-            if (error != NULL)
-            {
-                g_clear_error(&error);
-                value = g_strdup(sat_cfg_str[param].defval);
-            }
+            G_LOCK(config);
+            if (cache_valid)
+                value = g_strdup(str_cache[param]);
+            else
+                value = fetch_str(param);
+            G_UNLOCK(config);
         }
     }
     else
@@ -565,9 +725,17 @@ gchar          *sat_cfg_get_str_def(sat_cfg_str_e param)
     return value;
 }
 
-/** Store a str configuration value. */
+/**
+ * Store a str configuration value.
+ *
+ * A NULL value removes the parameter, i.e. resets it to the default. The
+ * change notifications are called if the value has changed.
+ */
 void sat_cfg_set_str(sat_cfg_str_e param, const gchar * value)
 {
+    gchar          *old;
+    gboolean        changed;
+
     if (param < SAT_CFG_STR_NUM)
     {
         if (config == NULL)
@@ -577,6 +745,7 @@ void sat_cfg_set_str(sat_cfg_str_e param, const gchar * value)
         }
         else
         {
+            G_LOCK(config);
             if (value)
             {
                 g_key_file_set_string(config,
@@ -590,6 +759,15 @@ void sat_cfg_set_str(sat_cfg_str_e param, const gchar * value)
                                       sat_cfg_str[param].group,
                                       sat_cfg_str[param].key, NULL);
             }
+
+            old = str_cache[param];
+            str_cache[param] = fetch_str(param);
+            changed = g_strcmp0(old, str_cache[param]) != 0;
+            g_free(old);
+            G_UNLOCK(config);
+
+            if (changed)
+                notify(SAT_CFG_TYPE_STR, param);
         }
     }
     else
@@ -601,33 +779,12 @@ void sat_cfg_set_str(sat_cfg_str_e param, const gchar * value)
 
 void sat_cfg_reset_str(sat_cfg_str_e param)
 {
-
-    if (param < SAT_CFG_STR_NUM)
-    {
-        if (config == NULL)
-        {
-            sat_log_log(SAT_LOG_LEVEL_ERROR,
-                        _("%s: Module not initialised\n"), __func__);
-        }
-        else
-        {
-            g_key_file_remove_key(config,
-                                  sat_cfg_str[param].group,
-                                  sat_cfg_str[param].key, NULL);
-        }
-
-    }
-    else
-    {
-        sat_log_log(SAT_LOG_LEVEL_ERROR,
-                    _("%s: Unknown STR param index (%d)\n"), __func__, param);
-    }
+    sat_cfg_set_str(param, NULL);
 }
 
 gint sat_cfg_get_int(sat_cfg_int_e param)
 {
     gint            value = 0;
-    GError         *error = NULL;
 
     if (param < SAT_CFG_INT_NUM)
     {
@@ -639,18 +796,16 @@ gint sat_cfg_get_int(sat_cfg_int_e param)
             /* return default value */
             value = sat_cfg_int[param].defval;
         }
+        else if (cache_valid)
+        {
+            value = g_atomic_int_get(&int_cache[param]);
+        }
         else
         {
             /* fetch value */
-            value = g_key_file_get_integer(config,
-                                           sat_cfg_int[param].group,
-                                           sat_cfg_int[param].key, &error);
-
-            if (error != NULL)
-            {
-                g_clear_error(&error);
-                value = sat_cfg_int[param].defval;
-            }
+            G_LOCK(config);
+            value = fetch_int(param);
+            G_UNLOCK(config);
         }
 
     }
@@ -680,8 +835,15 @@ gint sat_cfg_get_int_def(sat_cfg_int_e param)
     return value;
 }
 
+/**
+ * Store an integer configuration value.
+ *
+ * The change notifications are called if the value has changed.
+ */
 void sat_cfg_set_int(sat_cfg_int_e param, gint value)
 {
+    gint            old;
+
     if (param < SAT_CFG_INT_NUM)
     {
         if (config == NULL)
@@ -691,9 +853,17 @@ void sat_cfg_set_int(sat_cfg_int_e param, gint value)
         }
         else
         {
+            old = sat_cfg_get_int(param);
+
+            G_LOCK(config);
             g_key_file_set_integer(config,
                                    sat_cfg_int[param].group,
                                    sat_cfg_int[param].key, value);
+            g_atomic_int_set(&int_cache[param], value);
+            G_UNLOCK(config);
+
+            if (old != value)
+                notify(SAT_CFG_TYPE_INT, param);
         }
 
     }
@@ -706,6 +876,8 @@ void sat_cfg_set_int(sat_cfg_int_e param, gint value)
 
 void sat_cfg_reset_int(sat_cfg_int_e param)
 {
+    gint            old;
+
     if (param < SAT_CFG_INT_NUM)
     {
         if (config == NULL)
@@ -715,9 +887,17 @@ void sat_cfg_reset_int(sat_cfg_int_e param)
         }
         else
         {
+            old = sat_cfg_get_int(param);
+
+            G_LOCK(config);
             g_key_file_remove_key(config,
                                   sat_cfg_int[param].group,
                                   sat_cfg_int[param].key, NULL);
+            g_atomic_int_set(&int_cache[param], sat_cfg_int[param].defval);
+            G_UNLOCK(config);
+
+            if (old != sat_cfg_int[param].defval)
+                notify(SAT_CFG_TYPE_INT, param);
         }
 
     }
@@ -727,3 +907,45 @@ void sat_cfg_reset_int(sat_cfg_int_e param)
                     _("%s: Unknown INT param index (%d)\n"), __func__, param);
     }
 }
+
+/**
+ * Register a change notification.
+ *
+ * @param func The function to call when a value has been changed by one of
+ *             the sat_cfg_set and sat_cfg_reset functions.
+ * @param data User data passed to func.
+ * @return An ID that can be used with sat_cfg_remove_notify.
+ *
+ * The notifications are called from the thread that changes the value,
+ * i.e. the main loop; they are not called by sat_cfg_load.
+ */
+guint sat_cfg_add_notify(sat_cfg_notify_cb func, gpointer data)
+{
+    sat_cfg_notify_t *n;
+
+    n = g_new0(sat_cfg_notify_t, 1);
+    n->id = next_notify_id++;
+    n->func = func;
+    n->data = data;
+    notifiers = g_slist_append(notifiers, n);
+
+    return n->id;
+}
+
+/** Remove a change notification registered with sat_cfg_add_notify. */
+void sat_cfg_remove_notify(guint id)
+{
+    GSList         *node;
+    sat_cfg_notify_t *n;
+
+    for (node = notifiers; node != NULL; node = node->next)
+    {
+        n = node->data;
+        if (n->id == id)
+        {
+            notifiers = g_slist_delete_link(notifiers, node);
+            g_free(n);
+            return;
+        }
+    }
+}
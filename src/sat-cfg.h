@@ -53,6 +53,7 @@ typedef enum {
     SAT_CFG_BOOL_TLE_ADD_NEW,   /*!< Add new satellites to database. */
     SAT_CFG_BOOL_KEEP_LOG_FILES,        /*!< Whether to keep old log files */
     SAT_CFG_BOOL_PRED_USE_REAL_T0,      /*!< Whether to use current time as T0 fro predictions */
+    SAT_CFG_BOOL_EPHEM_CACHE,   /*!< Use Chebyshev ephemeris cache in modules */
     SAT_CFG_BOOL_NUM            /*!< Number of boolean parameters */
 } sat_cfg_bool_e;
 
@@ -128,6 +129,9 @@ typedef enum {
     SAT_CFG_INT_TLE_LAST_UPDATE,        /*!< Date and time of last update, Unix seconds. */
     SAT_CFG_INT_LOG_CLEAN_AGE,  /*!< Age of log file to delete (seconds) */
     SAT_CFG_INT_LOG_LEVEL,      /*!< Logging level */
+    SAT_CFG_INT_EPHEM_CACHE_SPAN,       /*!< Ephemeris cache segment length (seconds) */
+    SAT_CFG_INT_EPHEM_CACHE_TOL,        /*!< Ephemeris cache tolerance (metres) */
+    SAT_CFG_INT_MODULE_PROF_LOG,        /*!< Interval of module timing log lines (sec, 0 = off) */
     SAT_CFG_INT_NUM             /*!< Number of integer parameters. */
 } sat_cfg_int_e;
 
@@ -154,6 +158,22 @@ typedef enum {
     SAT_CFG_STR_NUM             /*!< Number of string parameters */
 } sat_cfg_str_e;
 
+/** Type of a changed config value. */
+typedef enum {
+    SAT_CFG_TYPE_BOOL = 0,      /*!< param is a sat_cfg_bool_e */
+    SAT_CFG_TYPE_INT,           /*!< param is a sat_cfg_int_e */
+    SAT_CFG_TYPE_STR            /*!< param is a sat_cfg_str_e */
+} sat_cfg_type_e;
+
+/**
+ * Callback called when a config value has changed.
+ * @param type The type of the value.
+ * @param param The index of the value.
+ * @param data The user data given to sat_cfg_add_notify.
+ */
+typedef void    (*sat_cfg_notify_cb) (sat_cfg_type_e type, guint param,
+                                      gpointer data);
+
 guint           sat_cfg_load(void);
 guint           sat_cfg_save(void);
 void            sat_cfg_close(void);
@@ -169,5 +189,7 @@ gint            sat_cfg_get_int(sat_cfg_int_e param);
 gint            sat_cfg_get_int_def(sat_cfg_int_e param);
 void            sat_cfg_set_int(sat_cfg_int_e param, gint value);
 void            sat_cfg_reset_int(sat_cfg_int_e param);
+guint           sat_cfg_add_notify(sat_cfg_notify_cb func, gpointer data);
+void            sat_cfg_remove_notify(guint id);
 
 #endif
@@ -55,6 +55,9 @@ static GIOChannel *logfile = NULL;
 static sat_log_level_t loglevel = SAT_LOG_LEVEL_DEBUG;
 static gboolean debug_to_stderr = FALSE; // whether to also send debug msg to stderr
 
+/* Serialises the output; messages may come from the worker threads */
+G_LOCK_DEFINE_STATIC(logfile);
+
 /** String representation of debug levels. */
 const gchar    *debug_level_str[] = {
     N_(" --- "),
@@ -214,6 +217,9 @@ static void manage_debug_message(sat_log_level_t debug_level,
     gsize           written;
     GError         *error = NULL;
 
+    /* localtime and the log file are shared with the worker threads */
+    G_LOCK(logfile);
+
     /* get the time */
     g_get_current_time(&tval);
     t = (time_t) tval.tv_sec;
@@ -250,6 +256,8 @@ static void manage_debug_message(sat_log_level_t debug_level,
         g_fprintf(stderr, "%s", msg);
     }
 
+    G_UNLOCK(logfile);
+
     g_free(msg);
 }
 
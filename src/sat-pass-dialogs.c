@@ -338,11 +338,11 @@ void show_pass(const gchar * satname, qth_t * qth, pass_t * pass,
                                    G_TYPE_STRING);      // visibility
 
     /* add rows to list store */
-    num = g_slist_length(pass->details);
+    num = pass->num_details;
 
     for (i = 0; i < num; i++)
     {
-        detail = PASS_DETAIL(g_slist_nth_data(pass->details, i));
+        detail = &pass->details[i];
 
         gtk_list_store_append(liststore, &item);
         gtk_list_store_set(liststore, &item,
@@ -920,13 +920,14 @@ static void Calc_RADec(gdouble jul_utc, gdouble saz, gdouble sel,
  * @param qth Pointer to the QTH data.
  * @param passes List of passes to show.
  * @param toplevel The toplevel window or NULL.
+ * @return The dialog. satname and qth must stay valid while it exists.
  *
  * This function creates a dialog window with a list showing the
  * details of a pass.
  *
  */
-void show_passes(const gchar * satname, qth_t * qth, GSList * passes,
-                 GtkWidget * toplevel)
+GtkWidget      *show_passes(const gchar * satname, qth_t * qth,
+                            GSList * passes, GtkWidget * toplevel)
 {
     GtkWidget      *dialog;
     GtkWidget      *list;
@@ -1072,6 +1073,8 @@ void show_passes(const gchar * satname, qth_t * qth, GSList * passes,
 
     gtk_window_set_default_size(GTK_WINDOW(dialog), -1, 300);
     gtk_widget_show_all(dialog);
+
+    return dialog;
 }
 
 /**
@@ -1364,3 +1367,169 @@ static void row_activated_cb(GtkTreeView * treeview, GtkTreePath * path,
                     __LINE__);
     }
 }
+
+/** Columns of the network pass list. */
+enum {
+    NETWORK_COL_SAT = 0,
+    NETWORK_COL_START,
+    NETWORK_COL_END,
+    NETWORK_COL_DURATION,
+    NETWORK_COL_QTHS,
+    NETWORK_COL_NUMBER
+};
+
+static void network_pass_response(GtkWidget * dialog, gint response,
+                                  gpointer data)
+{
+    (void)response;
+    (void)data;
+
+    gtk_widget_destroy(dialog);
+}
+
+/** Comma separated names of the ground stations in a mutual window. */
+static gchar   *network_qth_names(qth_t ** qths, guint nqth, guint32 mask)
+{
+    GString        *names = g_string_new(NULL);
+    guint           i;
+
+    for (i = 0; i < nqth; i++)
+    {
+        if (!(mask & (1u << i)))
+            continue;
+
+        if (names->len > 0)
+            g_string_append(names, ", ");
+        g_string_append(names, qths[i]->name);
+    }
+
+    return g_string_free(names, FALSE);
+}
+
+/**
+ * Show the windows in which several ground stations see the same satellite.
+ *
+ * @param sats Hash table with the satellites.
+ * @param qths The ground stations, at most MULTI_QTH_MAX.
+ * @param nqth The number of ground stations.
+ * @param start The start time of the prediction.
+ * @param maxdt The number of days to look ahead.
+ * @param toplevel The toplevel window or NULL.
+ *
+ * The passes of each satellite are predicted for all ground stations at once
+ * using get_passes_multi.
+ */
+void show_network_passes(GHashTable * sats, qth_t ** qths, guint nqth,
+                         gdouble start, gdouble maxdt, GtkWidget * toplevel)
+{
+    GtkWidget      *dialog;
+    GtkWidget      *list;
+    GtkListStore   *liststore;
+    GtkCellRenderer *renderer;
+    GtkTreeViewColumn *column;
+    GtkTreeIter     item;
+    GtkWidget      *swin;
+    GHashTableIter  iter;
+    gpointer        value;
+    sat_t          *sat;
+    GSList        **passes;
+    GSList         *mutual;
+    GSList         *node;
+    mutual_window_t *win;
+    gchar          *names;
+    gchar          *buff;
+    guint           i;
+
+    const gchar    *titles[NETWORK_COL_NUMBER] = {
+        N_("Satellite"),
+        N_("Start"),
+        N_("End"),
+        N_("Duration"),
+        N_("Ground stations")
+    };
+
+    list = gtk_tree_view_new();
+
+    for (i = 0; i < NETWORK_COL_NUMBER; i++)
+    {
+        renderer = gtk_cell_renderer_text_new();
+        column = gtk_tree_view_column_new_with_attributes(_(titles[i]),
+                                                          renderer, "text", i,
+                                                          NULL);
+        gtk_tree_view_insert_column(GTK_TREE_VIEW(list), column, -1);
+        gtk_tree_view_column_set_alignment(column, 0.5);
+        gtk_tree_view_column_set_sort_column_id(column, i);
+
+        if (i == NETWORK_COL_START || i == NETWORK_COL_END)
+            gtk_tree_view_column_set_cell_data_func(column, renderer,
+                                                    time_cell_data_function,
+                                                    GUINT_TO_POINTER(i),
+                                                    NULL);
+        else if (i == NETWORK_COL_DURATION)
+            gtk_tree_view_column_set_cell_data_func(column, renderer,
+                                                    duration_cell_data_function,
+                                                    GUINT_TO_POINTER(i),
+                                                    NULL);
+    }
+
+    liststore = gtk_list_store_new(NETWORK_COL_NUMBER, G_TYPE_STRING,   // satellite
+                                   G_TYPE_DOUBLE,       // start
+                                   G_TYPE_DOUBLE,       // end
+                                   G_TYPE_DOUBLE,       // duration
+                                   G_TYPE_STRING);      // ground stations
+
+    g_hash_table_iter_init(&iter, sats);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        sat = SAT(value);
+        passes = get_passes_multi(sat, qths, nqth, start, maxdt, &mutual);
+
+        for (node = mutual; node != NULL; node = node->next)
+        {
+            win = (mutual_window_t *) node->data;
+            names = network_qth_names(qths, nqth, win->qths);
+            gtk_list_store_append(liststore, &item);
+            gtk_list_store_set(liststore, &item,
+                               NETWORK_COL_SAT, sat->nickname,
+                               NETWORK_COL_START, win->start,
+                               NETWORK_COL_END, win->end,
+                               NETWORK_COL_DURATION, win->end - win->start,
+                               NETWORK_COL_QTHS, names, -1);
+            g_free(names);
+        }
+
+        g_slist_free_full(mutual, g_free);
+        free_passes_multi(passes, nqth);
+    }
+
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(liststore),
+                                         NETWORK_COL_START,
+                                         GTK_SORT_ASCENDING);
+    gtk_tree_view_set_model(GTK_TREE_VIEW(list), GTK_TREE_MODEL(liststore));
+    g_object_unref(liststore);
+
+    swin = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(swin),
+                                   GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_container_add(GTK_CONTAINER(swin), list);
+
+    dialog = gtk_dialog_new_with_buttons(_("Network passes"),
+                                         GTK_WINDOW(toplevel),
+                                         GTK_DIALOG_DESTROY_WITH_PARENT,
+                                         "_Close", GTK_RESPONSE_CLOSE, NULL);
+    gtk_dialog_set_default_response(GTK_DIALOG(dialog), GTK_RESPONSE_CLOSE);
+
+    buff = icon_file_name("gpredict-sat-list.png");
+    gtk_window_set_icon_from_file(GTK_WINDOW(dialog), buff, NULL);
+    g_free(buff);
+
+    gtk_window_set_modal(GTK_WINDOW(dialog), FALSE);
+    g_signal_connect(dialog, "response", G_CALLBACK(network_pass_response),
+                     NULL);
+
+    gtk_box_pack_start(GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog))),
+                       swin, TRUE, TRUE, 0);
+
+    gtk_window_set_default_size(GTK_WINDOW(dialog), -1, 300);
+    gtk_widget_show_all(dialog);
+}
@@ -111,7 +111,10 @@ typedef enum {
 
 void            show_pass(const gchar * satname, qth_t * qth, pass_t * pass,
                           GtkWidget * toplevel);
-void            show_passes(const gchar * satname, qth_t * qth,
+GtkWidget      *show_passes(const gchar * satname, qth_t * qth,
                             GSList * passes, GtkWidget * toplevel);
+void            show_network_passes(GHashTable * sats, qth_t ** qths,
+                                    guint nqth, gdouble start, gdouble maxdt,
+                                    GtkWidget * toplevel);
 
 #endif
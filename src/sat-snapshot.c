@@ -0,0 +1,182 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Per-cycle snapshots of the satellites of a module.
+ *
+ * The views used to derive values such as RA/Dec and visibility from the
+ * shared sat_t structures themselves, each view on its own and sometimes by
+ * writing the results back into the satellite. The module now takes one
+ * snapshot of every satellite per cycle, after the propagation, and the
+ * views only read the snapshots. The snapshots are not touched again until
+ * the next cycle.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <math.h>
+
+#include "sat-snapshot.h"
+#include "sat-vis.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+
+/**
+ * \brief Calculate the topocentric RA and Dec from azimuth and elevation.
+ *
+ * Reference: Methods of Orbit Determination by Pedro Ramon Escobal,
+ * pp. 401-402
+ */
+static void calc_radec(gdouble jul_utc, gdouble saz, gdouble sel,
+                       qth_t * qth, obs_astro_t * obs_set)
+{
+    double          phi, theta, sin_theta, cos_theta, sin_phi, cos_phi,
+        az, el, Lxh, Lyh, Lzh, Sx, Ex, Zx, Sy, Ey, Zy, Sz, Ez, Zz,
+        Lx, Ly, Lz, cos_delta, sin_alpha, cos_alpha;
+
+    az = saz * de2ra;
+    el = sel * de2ra;
+    phi = qth->lat * de2ra;
+    theta = FMod2p(ThetaG_JD(jul_utc) + qth->lon * de2ra);
+    sin_theta = sin(theta);
+    cos_theta = cos(theta);
+    sin_phi = sin(phi);
+    cos_phi = cos(phi);
+    Lxh = -cos(az) * cos(el);
+    Lyh = sin(az) * cos(el);
+    Lzh = sin(el);
+    Sx = sin_phi * cos_theta;
+    Ex = -sin_theta;
+    Zx = cos_theta * cos_phi;
+    Sy = sin_phi * sin_theta;
+    Ey = cos_theta;
+    Zy = sin_theta * cos_phi;
+    Sz = -cos_phi;
+    Ez = 0;
+    Zz = sin_phi;
+    Lx = Sx * Lxh + Ex * Lyh + Zx * Lzh;
+    Ly = Sy * Lxh + Ey * Lyh + Zy * Lzh;
+    Lz = Sz * Lxh + Ez * Lyh + Zz * Lzh;
+    obs_set->dec = ArcSin(Lz);  /* Declination (radians) */
+    cos_delta = sqrt(1 - Sqr(Lz));
+    sin_alpha = Ly / cos_delta;
+    cos_alpha = Lx / cos_delta;
+    obs_set->ra = AcTan(sin_alpha, cos_alpha);  /* Right Ascension (radians) */
+    obs_set->ra = FMod2p(obs_set->ra);
+}
+
+/**
+ * \brief Take a snapshot of a satellite.
+ * \param snap The snapshot to fill.
+ * \param sat The satellite; it is not modified.
+ * \param qth The observer.
+ */
+void sat_snap_take(sat_snap_t * snap, sat_t * sat, qth_t * qth)
+{
+    obs_astro_t     astro;
+
+    calc_radec(sat->jul_utc, sat->az, sat->el, qth, &astro);
+
+    snap->catnum = sat->tle.catnr;
+    snap->jul_utc = sat->jul_utc;
+    snap->az = sat->az;
+    snap->el = sat->el;
+    snap->range = sat->range;
+    snap->range_rate = sat->range_rate;
+    snap->ra = Degrees(astro.ra);
+    snap->dec = Degrees(astro.dec);
+    snap->ssplat = sat->ssplat;
+    snap->ssplon = sat->ssplon;
+    snap->alt = sat->alt;
+    snap->velo = sat->velo;
+    snap->ma = sat->ma;
+    snap->phase = sat->phase;
+    snap->footprint = sat->footprint;
+    snap->orbit = sat->orbit;
+    snap->aos = sat->aos;
+    snap->los = sat->los;
+    snap->vis = get_sat_vis(sat, qth, sat->jul_utc);
+}
+
+/**
+ * \brief Create an empty snapshot table.
+ *
+ * The table is keyed by catalogue number like the satellite table of the
+ * module; the keys point into the snapshots.
+ */
+GHashTable     *sat_snap_table_new(void)
+{
+    return g_hash_table_new_full(g_int_hash, g_int_equal, NULL, g_free);
+}
+
+/**
+ * \brief Take a snapshot of every satellite.
+ * \param snaps The snapshot table.
+ * \param sats The satellites of the module.
+ * \param qth The observer.
+ *
+ * Snapshots of satellites that are no longer in sats are kept; the table
+ * should be emptied when the satellites are reloaded.
+ */
+void sat_snap_table_update(GHashTable * snaps, GHashTable * sats,
+                           qth_t * qth)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+    sat_snap_t     *snap;
+    sat_t          *sat;
+
+    g_hash_table_iter_init(&iter, sats);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        sat = SAT(value);
+        snap = g_hash_table_lookup(snaps, &sat->tle.catnr);
+        if (snap == NULL)
+        {
+            snap = g_new0(sat_snap_t, 1);
+            sat_snap_take(snap, sat, qth);
+            g_hash_table_insert(snaps, &snap->catnum, snap);
+        }
+        else
+        {
+            sat_snap_take(snap, sat, qth);
+        }
+    }
+}
+
+/**
+ * \brief Look up the snapshot of a satellite.
+ * \return The snapshot or NULL if there is none.
+ */
+const sat_snap_t *sat_snap_lookup(GHashTable * snaps, guint catnum)
+{
+    if (snaps == NULL)
+        return NULL;
+
+    return g_hash_table_lookup(snaps, &catnum);
+}
@@ -0,0 +1,70 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef SAT_SNAPSHOT_H
+#define SAT_SNAPSHOT_H 1
+
+#include <glib.h>
+#include "gtk-sat-data.h"
+#include "sat-vis.h"
+#include "sgpsdp/sgp4sdp4.h"
+
+/**
+ * \brief State of a satellite in one cycle of a module, as seen by the views.
+ *
+ * The snapshots are filled by the module after the satellites have been
+ * updated and must be treated as read-only by the views.
+ */
+typedef struct {
+    guint           catnum;     /*!< Catalogue number; key in the table */
+    gdouble         jul_utc;    /*!< Time of the snapshot */
+    gdouble         az;         /*!< Azimuth [deg] */
+    gdouble         el;         /*!< Elevation [deg] */
+    gdouble         range;      /*!< Range [km] */
+    gdouble         range_rate; /*!< Range rate [km/sec] */
+    gdouble         ra;         /*!< Topocentric right ascension [deg] */
+    gdouble         dec;        /*!< Topocentric declination [deg] */
+    gdouble         ssplat;     /*!< SSP latitude [deg] */
+    gdouble         ssplon;     /*!< SSP longitude [deg] */
+    gdouble         alt;        /*!< Altitude [km] */
+    gdouble         velo;       /*!< Velocity [km/s] */
+    gdouble         ma;         /*!< Mean anomaly */
+    gdouble         phase;      /*!< Orbit phase */
+    gdouble         footprint;  /*!< Footprint [km] */
+    glong           orbit;      /*!< Orbit number */
+    gdouble         aos;        /*!< Next AOS */
+    gdouble         los;        /*!< Next LOS */
+    sat_vis_t       vis;        /*!< Visibility */
+} sat_snap_t;
+
+void            sat_snap_take(sat_snap_t * snap, sat_t * sat, qth_t * qth);
+GHashTable     *sat_snap_table_new(void);
+void            sat_snap_table_update(GHashTable * snaps, GHashTable * sats,
+                                      qth_t * qth);
+const sat_snap_t *sat_snap_lookup(GHashTable * snaps, guint catnum);
+
+#endif
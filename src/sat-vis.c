@@ -45,64 +45,149 @@ static gchar *VIS2STR[SAT_VIS_NUM] = {
 
 
 
-/** \brief Calculate satellite visibility.
- *  \param sat The satellite structure.
- *  \param qth The QTH
- *  \param jul_utc The time at which the visibility should be calculated.
- *  \return The visiblity code.
- *
- */
-sat_vis_t
-get_sat_vis (sat_t *sat, qth_t *qth, gdouble jul_utc)
+/* Seconds between the cached solar positions. The solar vector and
+   elevation are interpolated linearly between them, which keeps the
+   error of the solar elevation below 0.01 degrees. */
+#define SOLAR_CACHE_STEP 300.0
+
+/* Number of observers cached per thread */
+#define SOLAR_CACHE_SIZE 4
+
+/** \brief Cached solar positions for one observer. */
+typedef struct {
+    gboolean  valid;
+    gdouble   lat;        /*!< Observer latitude [deg] */
+    gdouble   lon;        /*!< Observer longitude [deg] */
+    gint      alt;        /*!< Observer altitude [m] */
+    gdouble   bucket;     /*!< Index of the cached interval */
+    vector_t  sun[2];     /*!< Solar ECI vectors at the interval ends */
+    gdouble   el[2];      /*!< Solar elevations at the interval ends [deg] */
+} solar_cache_t;
+
+typedef struct {
+    solar_cache_t entry[SOLAR_CACHE_SIZE];
+    guint         next;   /*!< Entry to replace next */
+} solar_caches_t;
+
+/* one set of caches per thread so that predictions can run in parallel */
+static GPrivate solar_key = G_PRIVATE_INIT (g_free);
+
+
+/** \brief Calculate the solar position and elevation without cache. */
+static void
+calc_sun (qth_t *qth, gdouble jul_utc, vector_t *sun, gdouble *el)
 {
-    gboolean sat_sun_status;
-    gdouble  sun_el;
-    gdouble  threshold;
-    gdouble  eclipse_depth;
-    sat_vis_t vis = SAT_VIS_NONE;
-    vector_t zero_vector = {0,0,0,0};
+    vector_t   zero_vector = {0,0,0,0};
     geodetic_t obs_geodetic;
+    obs_set_t  solar_set;
 
-    /* Solar ECI position vector  */
-    vector_t solar_vector=zero_vector;
-
-    /* Solar observed az and el vector  */
-    obs_set_t solar_set;
-
-    /* FIXME: could be passed as parameter */
     obs_geodetic.lon = qth->lon * de2ra;
     obs_geodetic.lat = qth->lat * de2ra;
     obs_geodetic.alt = qth->alt / 1000.0;
     obs_geodetic.theta = 0;
 
+    Calculate_Solar_Position (jul_utc, sun);
+    Calculate_Obs (jul_utc, sun, &zero_vector, &obs_geodetic, &solar_set);
+    *el = Degrees (solar_set.el);
+}
 
-    Calculate_Solar_Position (jul_utc, &solar_vector);
-    Calculate_Obs (jul_utc, &solar_vector, &zero_vector, &obs_geodetic, &solar_set);
 
-    if (Sat_Eclipsed (&sat->pos, &solar_vector, &eclipse_depth)) {
-        /* satellite is eclipsed */
-        sat_sun_status = FALSE;
+/** \brief Get the position of the sun.
+ *  \param qth The observer.
+ *  \param jul_utc The time.
+ *  \param sun Location where the solar ECI vector is stored.
+ *  \param el Location where the solar elevation [deg] is stored.
+ *
+ * The values are interpolated between solar positions that are computed
+ * every SOLAR_CACHE_STEP seconds and cached per observer, so that the
+ * many calls for nearby times made by the pass predictions and the
+ * satellite list only cost an interpolation.
+ */
+void
+get_sun_pos (qth_t *qth, gdouble jul_utc, vector_t *sun, gdouble *el)
+{
+    solar_caches_t *caches;
+    solar_cache_t  *c = NULL;
+    gdouble         x, bucket, frac;
+    guint           i;
+
+    caches = g_private_get (&solar_key);
+    if (caches == NULL) {
+        caches = g_new0 (solar_caches_t, 1);
+        g_private_set (&solar_key, caches);
     }
-    else {
-        /* satellite in sunlight => may be visible */
-        sat_sun_status = TRUE;
+
+    for (i = 0; i < SOLAR_CACHE_SIZE; i++) {
+        if (caches->entry[i].valid && caches->entry[i].lat == qth->lat &&
+            caches->entry[i].lon == qth->lon && caches->entry[i].alt == qth->alt) {
+            c = &caches->entry[i];
+            break;
+        }
     }
 
+    x = jul_utc * 86400.0 / SOLAR_CACHE_STEP;
+    bucket = floor (x);
+
+    if (c == NULL) {
+        c = &caches->entry[caches->next];
+        caches->next = (caches->next + 1) % SOLAR_CACHE_SIZE;
+        c->valid = FALSE;
+    }
 
-    if (sat_sun_status) {
-        sun_el = Degrees (solar_set.el);
-        threshold = (gdouble) sat_cfg_get_int (SAT_CFG_INT_PRED_TWILIGHT_THLD);
-        
-        if (sun_el <= threshold && sat->el >= 0.0)
-            vis = SAT_VIS_VISIBLE;
+    if (!c->valid || c->bucket != bucket) {
+        if (c->valid && c->bucket + 1.0 == bucket) {
+            /* moving forward; reuse the end of the previous interval */
+            c->sun[0] = c->sun[1];
+            c->el[0] = c->el[1];
+        }
         else
-            vis = SAT_VIS_DAYLIGHT;
+            calc_sun (qth, bucket * SOLAR_CACHE_STEP / 86400.0, &c->sun[0], &c->el[0]);
+
+        calc_sun (qth, (bucket + 1.0) * SOLAR_CACHE_STEP / 86400.0, &c->sun[1], &c->el[1]);
+
+        c->valid = TRUE;
+        c->lat = qth->lat;
+        c->lon = qth->lon;
+        c->alt = qth->alt;
+        c->bucket = bucket;
     }
-    else
-        vis = SAT_VIS_ECLIPSED;
 
+    frac = x - bucket;
+    sun->x = c->sun[0].x + frac * (c->sun[1].x - c->sun[0].x);
+    sun->y = c->sun[0].y + frac * (c->sun[1].y - c->sun[0].y);
+    sun->z = c->sun[0].z + frac * (c->sun[1].z - c->sun[0].z);
+    Magnitude (sun);
+    *el = c->el[0] + frac * (c->el[1] - c->el[0]);
+}
+
+
+/** \brief Calculate satellite visibility.
+ *  \param sat The satellite structure.
+ *  \param qth The QTH
+ *  \param jul_utc The time at which the visibility should be calculated.
+ *  \return The visiblity code.
+ *
+ * The position of the sun is taken from the cache of get_sun_pos, so
+ * that this is essentially an eclipse test.
+ */
+sat_vis_t
+get_sat_vis (sat_t *sat, qth_t *qth, gdouble jul_utc)
+{
+    gdouble  sun_el;
+    gdouble  eclipse_depth;
+    vector_t solar_vector;
+
+    get_sun_pos (qth, jul_utc, &solar_vector, &sun_el);
+
+    if (Sat_Eclipsed (&sat->pos, &solar_vector, &eclipse_depth))
+        return SAT_VIS_ECLIPSED;
+
+    /* satellite in sunlight => may be visible */
+    if (sun_el <= (gdouble) sat_cfg_get_int (SAT_CFG_INT_PRED_TWILIGHT_THLD) &&
+        sat->el >= 0.0)
+        return SAT_VIS_VISIBLE;
 
-    return vis;
+    return SAT_VIS_DAYLIGHT;
 }
 
 
@@ -50,6 +50,7 @@ typedef enum {
 
 
 sat_vis_t  get_sat_vis (sat_t *sat, qth_t *qth, gdouble jul_utc);
+void       get_sun_pos (qth_t *qth, gdouble jul_utc, vector_t *sun, gdouble *el);
 gchar      vis_to_chr  (sat_vis_t vis);
 gchar     *vis_to_str  (sat_vis_t vis);
 
@@ -0,0 +1,321 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2008  Alexandru Csete.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the
+          Free Software Foundation, Inc.,
+      59 Temple Place, Suite 330,
+      Boston, MA  02111-1307
+      USA
+*/
+/*
+ * Propagator micro-benchmark.
+ *
+ * Loads every element set from the bundled satellites.dat and times
+ * SGP4, SDP4, predict_calc, get_sat_vis and find_aos/find_los over a time
+ * grid starting at the newest epoch in the file. For the AOS/LOS search
+ * the number of propagations per search is reported as well. Usage:
+ *
+ *   bench-sgp [satellites.dat [days [step]]]
+ *
+ * where days is the length of the grid (default 1) and step the grid
+ * spacing in seconds (default 60).
+ */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glib.h>
+#include "sgp4sdp4.h"
+#include "../orbit-tools.h"
+#include "../predict-tools.h"
+#include "../qth-data.h"
+#include "../sat-cfg.h"
+#include "../sat-log.h"
+#include "../sat-vis.h"
+
+#define DEFAULT_FILE "../../data/satdata/satellites.dat"
+#define DEFAULT_DAYS 1.0
+#define DEFAULT_STEP 60.0
+
+/* observer; same location as the default sample.qth */
+#define BENCH_LAT 55.6167
+#define BENCH_LON 12.6500
+#define BENCH_ALT 5
+
+
+/*
+ * The benchmark does not read the gpredict configuration; the prediction
+ * code gets the default values of the parameters it uses.
+ */
+gint sat_cfg_get_int(sat_cfg_int_e param)
+{
+    switch (param)
+    {
+    case SAT_CFG_INT_PRED_MIN_EL:
+        return 5;
+    case SAT_CFG_INT_PRED_RESOLUTION:
+        return 10;
+    case SAT_CFG_INT_PRED_NUM_ENTRIES:
+        return 20;
+    case SAT_CFG_INT_PRED_TWILIGHT_THLD:
+        return -6;
+    default:
+        return 0;
+    }
+}
+
+gboolean sat_cfg_get_bool(sat_cfg_bool_e param)
+{
+    (void)param;
+
+    return FALSE;
+}
+
+void sat_log_log(sat_log_level_t level, const char *fmt, ...)
+{
+    (void)level;
+    (void)fmt;
+}
+
+/* qth-data.c depends on gpsd and the GTK utilities */
+void qth_small_save(qth_t * qth, qth_small_t * qth_small)
+{
+    qth_small->lat = qth->lat;
+    qth_small->lon = qth->lon;
+    qth_small->alt = qth->alt;
+}
+
+/* the benchmark has a single observer */
+double qth_small_dist(qth_t * qth, qth_small_t qth_small)
+{
+    (void)qth;
+    (void)qth_small;
+
+    return 0.0;
+}
+
+/* read all element sets from a satellites.dat file */
+static sat_t   *load_sats(const char *file, int *num)
+{
+    FILE           *fp;
+    sat_t          *sats = NULL;
+    char            line[80];
+    char            tle_str[3][80];
+    int             have = 0, alloc = 0, bad = 0;
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        printf("Could not open %s\n", file);
+        return NULL;
+    }
+
+    *num = 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strncmp(line, "NAME=", 5) == 0)
+        {
+            strcpy(tle_str[0], line + 5);
+            have = 1;
+        }
+        else if (have == 1 && strncmp(line, "TLE1=", 5) == 0)
+        {
+            strcpy(tle_str[1], line + 5);
+            have = 2;
+        }
+        else if (have == 2 && strncmp(line, "TLE2=", 5) == 0)
+        {
+            strcpy(tle_str[2], line + 5);
+            have = 0;
+
+            if (*num == alloc)
+            {
+                alloc = alloc ? 2 * alloc : 256;
+                sats = realloc(sats, alloc * sizeof(sat_t));
+                if (sats == NULL)
+                    abort();
+            }
+
+            memset(&sats[*num], 0, sizeof(sat_t));
+            if (Get_Next_Tle_Set(tle_str, &sats[*num].tle) != 1)
+            {
+                bad++;
+                continue;
+            }
+
+            select_ephemeris(&sats[*num]);
+            sats[*num].jul_epoch =
+                Julian_Date_of_Epoch(sats[*num].tle.epoch);
+            sats[*num].otype = get_orbit_type(&sats[*num]);
+            (*num)++;
+        }
+    }
+    fclose(fp);
+
+    if (bad)
+        printf("Skipped %d element sets with bad checksum\n", bad);
+
+    return sats;
+}
+
+/* print one line of the result table; evals < 0 if not counted */
+static void report(const char *name, gint64 usec, long count, long evals)
+{
+    if (count == 0)
+        printf("%-16s %12ld            -\n", name, count);
+    else if (evals < 0)
+        printf("%-16s %12ld %12.1f\n", name, count, 1000.0 * usec / count);
+    else
+        printf("%-16s %12ld %12.1f %12.1f\n", name, count,
+               1000.0 * usec / count, (double)evals / count);
+}
+
+int main(int argc, char *argv[])
+{
+    const char     *file = DEFAULT_FILE;
+    double          days = DEFAULT_DAYS;
+    double          step = DEFAULT_STEP;
+    sat_t          *sats;
+    qth_t           qth;
+    double          start = 0.0, t, maxdt;
+    long            nsteps, nsgp = 0, nsdp = 0, ncalc, nfind = 0;
+    gint64          t0, usgp, usdp, ucalc, uvis, ufind;
+    guint           evals0, nevals;
+    int             num, i, vis = 0;
+    long            k;
+
+    if (argc > 1)
+        file = argv[1];
+    if (argc > 2)
+        days = atof(argv[2]);
+    if (argc > 3)
+        step = atof(argv[3]);
+
+    if (days <= 0.0 || step <= 0.0)
+    {
+        printf("Usage: %s [satellites.dat [days [step]]]\n", argv[0]);
+        return 1;
+    }
+
+    sats = load_sats(file, &num);
+    if (sats == NULL || num == 0)
+        return 1;
+
+    /* start the grid at the newest epoch so that the results do not
+       depend on when the benchmark is run */
+    for (i = 0; i < num; i++)
+        start = fmax(start, sats[i].jul_epoch);
+
+    nsteps = (long)(days * 86400.0 / step) + 1;
+    maxdt = days;
+
+    memset(&qth, 0, sizeof(qth));
+    qth.lat = BENCH_LAT;
+    qth.lon = BENCH_LON;
+    qth.alt = BENCH_ALT;
+
+    printf("%d satellites, %ld time steps of %.0f s\n\n", num, nsteps, step);
+
+    /* raw propagation */
+    usgp = usdp = 0;
+    for (i = 0; i < num; i++)
+    {
+        t0 = g_get_monotonic_time();
+        for (k = 0; k < nsteps; k++)
+        {
+            t = (start - sats[i].jul_epoch) * xmnpda + k * step / 60.0;
+            if (sats[i].flags & DEEP_SPACE_EPHEM_FLAG)
+                SDP4(&sats[i], t);
+            else
+                SGP4(&sats[i], t);
+        }
+
+        if (sats[i].flags & DEEP_SPACE_EPHEM_FLAG)
+        {
+            usdp += g_get_monotonic_time() - t0;
+            nsdp += nsteps;
+        }
+        else
+        {
+            usgp += g_get_monotonic_time() - t0;
+            nsgp += nsteps;
+        }
+    }
+
+    /* full update; get_sat_vis needs the updated position so it is
+       timed as the difference to a second run that calls both */
+    t0 = g_get_monotonic_time();
+    for (i = 0; i < num; i++)
+        for (k = 0; k < nsteps; k++)
+            predict_calc(&sats[i], &qth, start + k * step / 86400.0);
+    ucalc = g_get_monotonic_time() - t0;
+    ncalc = (long)num * nsteps;
+
+    t0 = g_get_monotonic_time();
+    for (i = 0; i < num; i++)
+    {
+        for (k = 0; k < nsteps; k++)
+        {
+            t = start + k * step / 86400.0;
+            predict_calc(&sats[i], &qth, t);
+            vis += get_sat_vis(&sats[i], &qth, t);
+        }
+    }
+    uvis = MAX(g_get_monotonic_time() - t0 - ucalc, 0);
+
+    /* AOS/LOS search over the whole grid; one call is one search, and the
+       number of propagations per search compares search engines */
+    evals0 = get_find_evals();
+    t0 = g_get_monotonic_time();
+    for (i = 0; i < num; i++)
+    {
+        if (!has_aos(&sats[i], &qth))
+            continue;
+
+        find_aos(&sats[i], &qth, start, maxdt);
+        find_los(&sats[i], &qth, start, maxdt);
+        nfind += 2;
+    }
+    ufind = g_get_monotonic_time() - t0;
+    nevals = get_find_evals() - evals0;
+
+    printf("                        CALLS    NS / CALL  EVALS / CALL\n");
+    printf("--------------------------------------------------------\n");
+    report("SGP4", usgp, nsgp, -1);
+    report("SDP4", usdp, nsdp, -1);
+    report("predict_calc", ucalc, ncalc, -1);
+    report("get_sat_vis", uvis, ncalc, -1);
+    report("find_aos/los", ufind, nfind, (long)nevals);
+
+    /* keep the visibility results alive */
+    if (vis < 0)
+        printf("%d\n", vis);
+
+    for (i = 0; i < num; i++)
+        free_ephemeris(&sats[i]);
+    free(sats);
+
+    return 0;
+}
@@ -0,0 +1,267 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * Unit SGP4_Multi
+ *
+ * Structure-of-arrays version of the SGP4 propagation step from
+ * sgp4sdp4.c, propagating up to SGP4_MULTI_LANES near-earth satellites
+ * per call. Every stage is a plain loop over the lanes with no calls
+ * between lanes, so the compiler is free to vectorize the arithmetic.
+ * The operations are carried out in exactly the same order as in SGP4(),
+ * so the results are identical to the scalar path.
+ *
+ * Deep-space objects are not handled here; use SDP4() for those.
+ */
+
+#include "sgp4sdp4.h"
+
+/* SGP4_Multi_Init */
+/* Resets m to an empty block. */
+void
+SGP4_Multi_Init (sgp4_multi_t *m)
+{
+	memset (m, 0, sizeof (sgp4_multi_t));
+} /* SGP4_Multi_Init */
+
+/*------------------------------------------------------------------*/
+
+/* SGP4_Multi_Add */
+/* Copies the propagation constants of sat into the next free lane */
+/* of m. Returns 1 on success and 0 if the block is full or sat is  */
+/* a deep-space object. The satellite is initialized if necessary. */
+/* The lane refers to sat by pointer and must be rebuilt if the     */
+/* elements of sat change.                                          */
+int
+SGP4_Multi_Add (sgp4_multi_t *m, sat_t *sat)
+{
+	int l = m->num;
+
+	if ((l >= SGP4_MULTI_LANES) || (sat->flags & DEEP_SPACE_EPHEM_FLAG))
+		return 0;
+
+	/* make sure sat->sgps is valid */
+	if (~sat->flags & SGP4_INITIALIZED_FLAG)
+		SGP4 (sat, 0.0);
+
+	m->sat[l]    = sat;
+	m->simple[l] = (sat->flags & SIMPLE_FLAG) ? 1 : 0;
+
+	m->xmo[l]    = sat->tle.xmo;
+	m->omegao[l] = sat->tle.omegao;
+	m->xnodeo[l] = sat->tle.xnodeo;
+	m->eo[l]     = sat->tle.eo;
+	m->xincl[l]  = sat->tle.xincl;
+	m->bstar[l]  = sat->tle.bstar;
+
+	m->aodp[l]   = sat->sgps->aodp;
+	m->aycof[l]  = sat->sgps->aycof;
+	m->c1[l]     = sat->sgps->c1;
+	m->c4[l]     = sat->sgps->c4;
+	m->c5[l]     = sat->sgps->c5;
+	m->cosio[l]  = sat->sgps->cosio;
+	m->delmo[l]  = sat->sgps->delmo;
+	m->omgcof[l] = sat->sgps->omgcof;
+	m->eta[l]    = sat->sgps->eta;
+	m->omgdot[l] = sat->sgps->omgdot;
+	m->sinio[l]  = sat->sgps->sinio;
+	m->xnodp[l]  = sat->sgps->xnodp;
+	m->sinmo[l]  = sat->sgps->sinmo;
+	m->t2cof[l]  = sat->sgps->t2cof;
+	m->x1mth2[l] = sat->sgps->x1mth2;
+	m->x3thm1[l] = sat->sgps->x3thm1;
+	m->x7thm1[l] = sat->sgps->x7thm1;
+	m->xmcof[l]  = sat->sgps->xmcof;
+	m->xmdot[l]  = sat->sgps->xmdot;
+	m->xnodcf[l] = sat->sgps->xnodcf;
+	m->xnodot[l] = sat->sgps->xnodot;
+	m->xlcof[l]  = sat->sgps->xlcof;
+
+	/* these are not initialized by SGP4() for "simple" orbits */
+	if (m->simple[l]) {
+		m->d2[l] = m->d3[l] = m->d4[l] = 0.0;
+		m->t3cof[l] = m->t4cof[l] = m->t5cof[l] = 0.0;
+	}
+	else {
+		m->d2[l]    = sat->sgps->d2;
+		m->d3[l]    = sat->sgps->d3;
+		m->d4[l]    = sat->sgps->d4;
+		m->t3cof[l] = sat->sgps->t3cof;
+		m->t4cof[l] = sat->sgps->t4cof;
+		m->t5cof[l] = sat->sgps->t5cof;
+	}
+
+	m->num++;
+
+	return 1;
+} /* SGP4_Multi_Add */
+
+/*------------------------------------------------------------------*/
+
+/* SGP4_Multi */
+/* Propagates every satellite in m. tsince holds m->num times since */
+/* epoch in minutes, one for each lane. The results are stored in   */
+/* the satellites exactly as SGP4() would store them: pos, vel,     */
+/* phase and the squint angles in tle. Use Convert_Sat_State() to   */
+/* convert pos and vel to km and km/s.                              */
+void
+SGP4_Multi (sgp4_multi_t *m, const double *tsince)
+{
+	double
+		a[SGP4_MULTI_LANES], xn[SGP4_MULTI_LANES],
+		xnode[SGP4_MULTI_LANES], omgadf[SGP4_MULTI_LANES],
+		xlt[SGP4_MULTI_LANES], axn[SGP4_MULTI_LANES],
+		ayn[SGP4_MULTI_LANES], capu[SGP4_MULTI_LANES],
+		epw[SGP4_MULTI_LANES], sinepw[SGP4_MULTI_LANES],
+		cosepw[SGP4_MULTI_LANES], t3[SGP4_MULTI_LANES],
+		t4[SGP4_MULTI_LANES], t5[SGP4_MULTI_LANES],
+		t6[SGP4_MULTI_LANES], uk[SGP4_MULTI_LANES],
+		rk[SGP4_MULTI_LANES], xnodek[SGP4_MULTI_LANES],
+		xinck[SGP4_MULTI_LANES], rdotk[SGP4_MULTI_LANES],
+		rfdotk[SGP4_MULTI_LANES], omega[SGP4_MULTI_LANES];
+
+	double
+		cosuk,sinuk,vx,vy,vz,ux,uy,uz,xmy,xmx,cosnok,sinnok,
+		cosik,sinik,cos2u,sin2u,u,sinu,cosu,betal,rfdot,rdot,r,pl,
+		elsq,esine,ecose,tfour,xll,beta,xl,e,tcube,delm,delomg,
+		templ,tempe,tempa,tsq,xmp,xnoddf,xmdf,temp,temp1,temp2,
+		temp3,aynl,ts,phase;
+
+	int done[SGP4_MULTI_LANES];
+	int i, l, n = m->num;
+
+	/* Update for secular gravity and atmospheric drag */
+	/* and long period periodics                       */
+	for (l = 0; l < n; l++) {
+		ts = tsince[l];
+		xmdf = m->xmo[l] + m->xmdot[l] * ts;
+		omgadf[l] = m->omegao[l] + m->omgdot[l] * ts;
+		xnoddf = m->xnodeo[l] + m->xnodot[l] * ts;
+		omega[l] = omgadf[l];
+		xmp = xmdf;
+		tsq = ts*ts;
+		xnode[l] = xnoddf + m->xnodcf[l] * tsq;
+		tempa = 1.0 - m->c1[l] * ts;
+		tempe = m->bstar[l] * m->c4[l] * ts;
+		templ = m->t2cof[l] * tsq;
+		if (!m->simple[l]) {
+			delomg = m->omgcof[l] * ts;
+			delm = m->xmcof[l] * (pow (1 + m->eta[l] * cos (xmdf), 3) - m->delmo[l]);
+			temp = delomg + delm;
+			xmp = xmdf + temp;
+			omega[l] = omgadf[l] - temp;
+			tcube = tsq * ts;
+			tfour = ts * tcube;
+			tempa = tempa - m->d2[l] * tsq - m->d3[l] * tcube - m->d4[l] * tfour;
+			tempe = tempe + m->bstar[l] * m->c5[l] * (sin (xmp) - m->sinmo[l]);
+			templ = templ + m->t3cof[l] * tcube + tfour *
+				(m->t4cof[l] + ts * m->t5cof[l]);
+		}
+
+		a[l] = m->aodp[l] * pow (tempa, 2);
+		e = m->eo[l] - tempe;
+		xl = xmp + omega[l] + xnode[l] + m->xnodp[l] * templ;
+		beta = sqrt (1.0 - e*e);
+		xn[l] = xke / pow (a[l], 1.5);
+
+		axn[l] = e * cos (omega[l]);
+		temp = 1.0 / (a[l] * beta * beta);
+		xll = temp * m->xlcof[l] * axn[l];
+		aynl = temp * m->aycof[l];
+		xlt[l] = xl + xll;
+		ayn[l] = e * sin (omega[l]) + aynl;
+
+		capu[l] = FMod2p (xlt[l] - xnode[l]);
+		epw[l] = capu[l];
+		done[l] = 0;
+	}
+
+	/* Solve Kepler's' Equation; same iteration limit and */
+	/* tolerance as SGP4(), converged lanes are frozen     */
+	for (i = 0; i <= 10; i++) {
+		for (l = 0; l < n; l++) {
+			if (done[l])
+				continue;
+			sinepw[l] = sin (epw[l]);
+			cosepw[l] = cos (epw[l]);
+			t3[l] = axn[l] * sinepw[l];
+			t4[l] = ayn[l] * cosepw[l];
+			t5[l] = axn[l] * cosepw[l];
+			t6[l] = ayn[l] * sinepw[l];
+			temp = (capu[l] - t4[l] + t3[l] - epw[l]) /
+				(1.0 - t5[l] - t6[l]) + epw[l];
+			if (fabs (temp - epw[l]) <= e6a)
+				done[l] = 1;
+			else
+				epw[l] = temp;
+		}
+	}
+
+	/* Short period preliminary quantities and update for short periodics */
+	for (l = 0; l < n; l++) {
+		ecose = t5[l] + t6[l];
+		esine = t3[l] - t4[l];
+		elsq = axn[l]*axn[l] + ayn[l]*ayn[l];
+		temp = 1.0 - elsq;
+		pl = a[l] * temp;
+		r = a[l] * (1.0 - ecose);
+		temp1 = 1.0 / r;
+		rdot = xke * sqrt (a[l]) * esine * temp1;
+		rfdot = xke * sqrt (pl) * temp1;
+		temp2 = a[l] * temp1;
+		betal = sqrt (temp);
+		temp3 = 1.0 / (1.0 + betal);
+		cosu = temp2 * (cosepw[l] - axn[l] + ayn[l] * esine * temp3);
+		sinu = temp2 * (sinepw[l] - ayn[l] - axn[l] * esine * temp3);
+		u = AcTan (sinu, cosu);
+		sin2u = 2.0 * sinu * cosu;
+		cos2u = 2.0 * cosu * cosu - 1.0;
+		temp = 1.0 / pl;
+		temp1 = ck2 * temp;
+		temp2 = temp1 * temp;
+
+		rk[l] = r * (1.0 - 1.5 * temp2 * betal * m->x3thm1[l]) +
+			0.5 * temp1 * m->x1mth2[l] * cos2u;
+		uk[l] = u - 0.25 * temp2 * m->x7thm1[l] * sin2u;
+		xnodek[l] = xnode[l] + 1.5 * temp2 * m->cosio[l] * sin2u;
+		xinck[l] = m->xincl[l] + 1.5 * temp2 * m->cosio[l] * m->sinio[l] * cos2u;
+		rdotk[l] = rdot - xn[l] * temp1 * m->x1mth2[l] * sin2u;
+		rfdotk[l] = rfdot + xn[l] * temp1 * (m->x1mth2[l] * cos2u + 1.5 * m->x3thm1[l]);
+	}
+
+	/* Orientation vectors, position and velocity */
+	for (l = 0; l < n; l++) {
+		sat_t *sat = m->sat[l];
+
+		sinuk = sin (uk[l]);
+		cosuk = cos (uk[l]);
+		sinik = sin (xinck[l]);
+		cosik = cos (xinck[l]);
+		sinnok = sin (xnodek[l]);
+		cosnok = cos (xnodek[l]);
+		xmx = -sinnok * cosik;
+		xmy = cosnok * cosik;
+		ux = xmx * sinuk + cosnok * cosuk;
+		uy = xmy * sinuk + sinnok * cosuk;
+		uz = sinik * sinuk;
+		vx = xmx * cosuk - cosnok * sinuk;
+		vy = xmy * cosuk - sinnok * sinuk;
+		vz = sinik * cosuk;
+
+		sat->pos.x = rk[l]*ux;
+		sat->pos.y = rk[l]*uy;
+		sat->pos.z = rk[l]*uz;
+		sat->vel.x = rdotk[l]*ux+rfdotk[l]*vx;
+		sat->vel.y = rdotk[l]*uy+rfdotk[l]*vy;
+		sat->vel.z = rdotk[l]*uz+rfdotk[l]*vz;
+
+		phase = xlt[l] - xnode[l] - omgadf[l] + twopi;
+		if (phase < 0)
+			phase += twopi;
+		sat->phase = FMod2p (phase);
+
+		sat->tle.omegao1 = omega[l];
+		sat->tle.xincl1  = xinck[l];
+		sat->tle.xnodeo1 = xnodek[l];
+	}
+} /* SGP4_Multi */
+
+/*------------------------------------------------------------------*/
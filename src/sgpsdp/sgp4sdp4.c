@@ -48,23 +48,23 @@ SGP4 (sat_t *sat, double tsince)
 		/* Recover original mean motion (xnodp) and   */
 		/* semimajor axis (aodp) from input elements. */
 		a1 = pow (xke/sat->tle.xno, tothrd);
-		sat->sgps.cosio = cos (sat->tle.xincl);
-		theta2 = sat->sgps.cosio * sat->sgps.cosio;
-		sat->sgps.x3thm1 = 3 * theta2 - 1.0;
+		sat->sgps->cosio = cos (sat->tle.xincl);
+		theta2 = sat->sgps->cosio * sat->sgps->cosio;
+		sat->sgps->x3thm1 = 3 * theta2 - 1.0;
 		eosq = sat->tle.eo * sat->tle.eo;
 		betao2 = 1 - eosq;
 		betao = sqrt (betao2);
-		del1 = 1.5 * ck2 * sat->sgps.x3thm1 / (a1*a1*betao*betao2);
+		del1 = 1.5 * ck2 * sat->sgps->x3thm1 / (a1*a1*betao*betao2);
 		ao = a1*(1-del1*(0.5*tothrd+del1*(1+134.0/81.0*del1)));
-		delo = 1.5 * ck2 * sat->sgps.x3thm1 / (ao*ao*betao*betao2);
-		sat->sgps.xnodp = sat->tle.xno / (1.0 + delo);
-		sat->sgps.aodp = ao / (1.0 - delo);
+		delo = 1.5 * ck2 * sat->sgps->x3thm1 / (ao*ao*betao*betao2);
+		sat->sgps->xnodp = sat->tle.xno / (1.0 + delo);
+		sat->sgps->aodp = ao / (1.0 - delo);
 
 		/* For perigee less than 220 kilometers, the "simple" flag is set */
 		/* and the equations are truncated to linear variation in sqrt a  */
 		/* and quadratic variation in mean anomaly.  Also, the c3 term,   */
 		/* the delta omega term, and the delta m term are dropped.        */
-		if ((sat->sgps.aodp * (1.0 - sat->tle.eo) / ae) < (220.0 / xkmper + ae))
+		if ((sat->sgps->aodp * (1.0 - sat->tle.eo) / ae) < (220.0 / xkmper + ae))
 			sat->flags |= SIMPLE_FLAG;
 		else
 			sat->flags &= ~SIMPLE_FLAG;
@@ -73,7 +73,7 @@ SGP4 (sat_t *sat, double tsince)
 		/* values of s and qoms2t are altered. */
 		s4 = __s__;
 		qoms24 = qoms2t;
-		perige = (sat->sgps.aodp * (1 - sat->tle.eo) - ae) * xkmper;
+		perige = (sat->sgps->aodp * (1 - sat->tle.eo) - ae) * xkmper;
 		if (perige < 156.0) {
 			if (perige <= 98.0)
 				s4 = 20.0;
@@ -83,108 +83,108 @@ SGP4 (sat_t *sat, double tsince)
 			s4 = s4 / xkmper + ae;
 		}; /* FIXME FIXME: End of if(perige <= 98) NO WAY!!!! */
 
-		pinvsq = 1.0 / (sat->sgps.aodp * sat->sgps.aodp * betao2 * betao2);
-		tsi = 1.0 / (sat->sgps.aodp - s4);
-		sat->sgps.eta = sat->sgps.aodp * sat->tle.eo * tsi;
-		etasq = sat->sgps.eta * sat->sgps.eta;
-		eeta = sat->tle.eo * sat->sgps.eta;
+		pinvsq = 1.0 / (sat->sgps->aodp * sat->sgps->aodp * betao2 * betao2);
+		tsi = 1.0 / (sat->sgps->aodp - s4);
+		sat->sgps->eta = sat->sgps->aodp * sat->tle.eo * tsi;
+		etasq = sat->sgps->eta * sat->sgps->eta;
+		eeta = sat->tle.eo * sat->sgps->eta;
 		psisq = fabs (1.0 - etasq);
 		coef = qoms24 * pow (tsi, 4);
 		coef1 = coef / pow (psisq, 3.5);
-		c2 = coef1 * sat->sgps.xnodp * (sat->sgps.aodp *
+		c2 = coef1 * sat->sgps->xnodp * (sat->sgps->aodp *
 						(1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
-						0.75 * ck2 * tsi / psisq * sat->sgps.x3thm1 *
+						0.75 * ck2 * tsi / psisq * sat->sgps->x3thm1 *
 						(8.0 + 3.0 * etasq * (8 + etasq)));
-		sat->sgps.c1 = c2 * sat->tle.bstar;
-		sat->sgps.sinio = sin (sat->tle.xincl);
+		sat->sgps->c1 = c2 * sat->tle.bstar;
+		sat->sgps->sinio = sin (sat->tle.xincl);
 		a3ovk2 = -xj3 / ck2 * pow (ae, 3);
-		c3 = coef * tsi * a3ovk2 * sat->sgps.xnodp * ae * sat->sgps.sinio / sat->tle.eo;
-		sat->sgps.x1mth2 = 1.0 - theta2;
-		sat->sgps.c4 = 2.0 * sat->sgps.xnodp * coef1 * sat->sgps.aodp * betao2 *
-			(sat->sgps.eta * (2.0 + 0.5 * etasq) +
+		c3 = coef * tsi * a3ovk2 * sat->sgps->xnodp * ae * sat->sgps->sinio / sat->tle.eo;
+		sat->sgps->x1mth2 = 1.0 - theta2;
+		sat->sgps->c4 = 2.0 * sat->sgps->xnodp * coef1 * sat->sgps->aodp * betao2 *
+			(sat->sgps->eta * (2.0 + 0.5 * etasq) +
 			 sat->tle.eo * (0.5 + 2.0 * etasq) -
-			 2.0 * ck2 * tsi / (sat->sgps.aodp * psisq) *
-			 (-3.0 * sat->sgps.x3thm1 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) + 
-			  0.75 * sat->sgps.x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * 
+			 2.0 * ck2 * tsi / (sat->sgps->aodp * psisq) *
+			 (-3.0 * sat->sgps->x3thm1 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) + 
+			  0.75 * sat->sgps->x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * 
 			  cos (2.0 * sat->tle.omegao)));
-		sat->sgps.c5 = 2.0 * coef1 * sat->sgps.aodp * betao2 *
+		sat->sgps->c5 = 2.0 * coef1 * sat->sgps->aodp * betao2 *
 			(1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
 		theta4 = theta2 * theta2;
-		temp1 = 3.0 * ck2 * pinvsq * sat->sgps.xnodp;
+		temp1 = 3.0 * ck2 * pinvsq * sat->sgps->xnodp;
 		temp2 = temp1 * ck2 * pinvsq;
-		temp3 = 1.25 * ck4 * pinvsq * pinvsq * sat->sgps.xnodp;
-		sat->sgps.xmdot = sat->sgps.xnodp + 0.5 * temp1 * betao * sat->sgps.x3thm1 +
+		temp3 = 1.25 * ck4 * pinvsq * pinvsq * sat->sgps->xnodp;
+		sat->sgps->xmdot = sat->sgps->xnodp + 0.5 * temp1 * betao * sat->sgps->x3thm1 +
 			0.0625 * temp2 * betao * (13.0 - 78.0 * theta2 + 137.0 * theta4);
 		x1m5th = 1.0 - 5.0 * theta2;
-		sat->sgps.omgdot = -0.5 * temp1 * x1m5th +
+		sat->sgps->omgdot = -0.5 * temp1 * x1m5th +
 			0.0625 * temp2 * (7.0 - 114.0 * theta2 + 395.0 * theta4) +
 			temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
-		xhdot1 = -temp1 * sat->sgps.cosio;
-		sat->sgps.xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) +
-					     2.0 * temp3 * (3.0 - 7.0 * theta2)) * sat->sgps.cosio;
-		sat->sgps.omgcof = sat->tle.bstar * c3 * cos (sat->tle.omegao);
-		sat->sgps.xmcof = -tothrd * coef * sat->tle.bstar * ae / eeta;
-		sat->sgps.xnodcf = 3.5 * betao2 * xhdot1 * sat->sgps.c1;
-		sat->sgps.t2cof = 1.5 * sat->sgps.c1;
-		sat->sgps.xlcof = 0.125 * a3ovk2 * sat->sgps.sinio *
-			(3.0 + 5.0 * sat->sgps.cosio) / (1.0 + sat->sgps.cosio);
-		sat->sgps.aycof = 0.25 * a3ovk2 * sat->sgps.sinio;
-		sat->sgps.delmo = pow (1.0 + sat->sgps.eta * cos (sat->tle.xmo), 3);
-		sat->sgps.sinmo = sin (sat->tle.xmo);
-		sat->sgps.x7thm1 = 7.0 * theta2 - 1.0;
+		xhdot1 = -temp1 * sat->sgps->cosio;
+		sat->sgps->xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) +
+					     2.0 * temp3 * (3.0 - 7.0 * theta2)) * sat->sgps->cosio;
+		sat->sgps->omgcof = sat->tle.bstar * c3 * cos (sat->tle.omegao);
+		sat->sgps->xmcof = -tothrd * coef * sat->tle.bstar * ae / eeta;
+		sat->sgps->xnodcf = 3.5 * betao2 * xhdot1 * sat->sgps->c1;
+		sat->sgps->t2cof = 1.5 * sat->sgps->c1;
+		sat->sgps->xlcof = 0.125 * a3ovk2 * sat->sgps->sinio *
+			(3.0 + 5.0 * sat->sgps->cosio) / (1.0 + sat->sgps->cosio);
+		sat->sgps->aycof = 0.25 * a3ovk2 * sat->sgps->sinio;
+		sat->sgps->delmo = pow (1.0 + sat->sgps->eta * cos (sat->tle.xmo), 3);
+		sat->sgps->sinmo = sin (sat->tle.xmo);
+		sat->sgps->x7thm1 = 7.0 * theta2 - 1.0;
 		if (~sat->flags & SIMPLE_FLAG) {
-			c1sq = sat->sgps.c1 * sat->sgps.c1;
-			sat->sgps.d2 = 4.0 * sat->sgps.aodp * tsi * c1sq;
-			temp = sat->sgps.d2 * tsi * sat->sgps.c1 / 3.0;
-			sat->sgps.d3 = (17.0 * sat->sgps.aodp + s4) * temp;
-			sat->sgps.d4 = 0.5 * temp * sat->sgps.aodp * tsi *
-				(221.0 * sat->sgps.aodp + 31.0 * s4) * sat->sgps.c1;
-			sat->sgps.t3cof = sat->sgps.d2 + 2.0 * c1sq;
-			sat->sgps.t4cof = 0.25 * (3.0 * sat->sgps.d3 + sat->sgps.c1 *
-						  (12.0 * sat->sgps.d2 + 10.0 * c1sq));
-			sat->sgps.t5cof = 0.2 * (3.0 * sat->sgps.d4 +
-						 12.0 * sat->sgps.c1 * sat->sgps.d3 +
-						 6.0 * sat->sgps.d2 * sat->sgps.d2 +
-						 15.0 * c1sq * (2.0 * sat->sgps.d2 + c1sq));
+			c1sq = sat->sgps->c1 * sat->sgps->c1;
+			sat->sgps->d2 = 4.0 * sat->sgps->aodp * tsi * c1sq;
+			temp = sat->sgps->d2 * tsi * sat->sgps->c1 / 3.0;
+			sat->sgps->d3 = (17.0 * sat->sgps->aodp + s4) * temp;
+			sat->sgps->d4 = 0.5 * temp * sat->sgps->aodp * tsi *
+				(221.0 * sat->sgps->aodp + 31.0 * s4) * sat->sgps->c1;
+			sat->sgps->t3cof = sat->sgps->d2 + 2.0 * c1sq;
+			sat->sgps->t4cof = 0.25 * (3.0 * sat->sgps->d3 + sat->sgps->c1 *
+						  (12.0 * sat->sgps->d2 + 10.0 * c1sq));
+			sat->sgps->t5cof = 0.2 * (3.0 * sat->sgps->d4 +
+						 12.0 * sat->sgps->c1 * sat->sgps->d3 +
+						 6.0 * sat->sgps->d2 * sat->sgps->d2 +
+						 15.0 * c1sq * (2.0 * sat->sgps->d2 + c1sq));
 		}; /* End of if (isFlagClear(SIMPLE_FLAG)) */
 	}; /* End of SGP4() initialization */
 
 	/* Update for secular gravity and atmospheric drag. */
-	xmdf = sat->tle.xmo + sat->sgps.xmdot * tsince;
-	omgadf = sat->tle.omegao + sat->sgps.omgdot * tsince;
-	xnoddf = sat->tle.xnodeo + sat->sgps.xnodot * tsince;
+	xmdf = sat->tle.xmo + sat->sgps->xmdot * tsince;
+	omgadf = sat->tle.omegao + sat->sgps->omgdot * tsince;
+	xnoddf = sat->tle.xnodeo + sat->sgps->xnodot * tsince;
 	omega = omgadf;
 	xmp = xmdf;
 	tsq = tsince*tsince;
-	xnode = xnoddf + sat->sgps.xnodcf * tsq;
-	tempa = 1.0 - sat->sgps.c1 * tsince;
-	tempe = sat->tle.bstar * sat->sgps.c4 * tsince;
-	templ = sat->sgps.t2cof * tsq;
+	xnode = xnoddf + sat->sgps->xnodcf * tsq;
+	tempa = 1.0 - sat->sgps->c1 * tsince;
+	tempe = sat->tle.bstar * sat->sgps->c4 * tsince;
+	templ = sat->sgps->t2cof * tsq;
 	if (~sat->flags & SIMPLE_FLAG) {
-		delomg = sat->sgps.omgcof * tsince;
-		delm = sat->sgps.xmcof * (pow (1 + sat->sgps.eta * cos (xmdf), 3) - sat->sgps.delmo);
+		delomg = sat->sgps->omgcof * tsince;
+		delm = sat->sgps->xmcof * (pow (1 + sat->sgps->eta * cos (xmdf), 3) - sat->sgps->delmo);
 		temp = delomg + delm;
 		xmp = xmdf + temp;
 		omega = omgadf - temp;
 		tcube = tsq * tsince;
 		tfour = tsince * tcube;
-		tempa = tempa - sat->sgps.d2 * tsq - sat->sgps.d3 * tcube - sat->sgps.d4 * tfour;
-		tempe = tempe + sat->tle.bstar * sat->sgps.c5 * (sin (xmp) - sat->sgps.sinmo);
-		templ = templ + sat->sgps.t3cof * tcube + tfour *
-			(sat->sgps.t4cof + tsince * sat->sgps.t5cof);
+		tempa = tempa - sat->sgps->d2 * tsq - sat->sgps->d3 * tcube - sat->sgps->d4 * tfour;
+		tempe = tempe + sat->tle.bstar * sat->sgps->c5 * (sin (xmp) - sat->sgps->sinmo);
+		templ = templ + sat->sgps->t3cof * tcube + tfour *
+			(sat->sgps->t4cof + tsince * sat->sgps->t5cof);
 	}; /* End of if (isFlagClear(SIMPLE_FLAG)) */
 
-	a = sat->sgps.aodp * pow (tempa, 2);
+	a = sat->sgps->aodp * pow (tempa, 2);
 	e = sat->tle.eo - tempe;
-	xl = xmp + omega + xnode + sat->sgps.xnodp * templ;
+	xl = xmp + omega + xnode + sat->sgps->xnodp * templ;
 	beta = sqrt (1.0 - e*e);
 	xn = xke / pow (a, 1.5);
 
 	/* Long period periodics */
 	axn = e * cos (omega);
 	temp = 1.0 / (a * beta * beta);
-	xll = temp * sat->sgps.xlcof * axn;
-	aynl = temp * sat->sgps.aycof;
+	xll = temp * sat->sgps->xlcof * axn;
+	aynl = temp * sat->sgps->aycof;
 	xlt = xl + xll;
 	ayn = e * sin (omega) + aynl;
 
@@ -230,13 +230,13 @@ SGP4 (sat_t *sat, double tsince)
 	temp2 = temp1 * temp;
 
 	/* Update for short periodics */
-	rk = r * (1.0 - 1.5 * temp2 * betal * sat->sgps.x3thm1) +
-		0.5 * temp1 * sat->sgps.x1mth2 * cos2u;
-	uk = u - 0.25 * temp2 * sat->sgps.x7thm1 * sin2u;
-	xnodek = xnode + 1.5 * temp2 * sat->sgps.cosio * sin2u;
-	xinck = sat->tle.xincl + 1.5 * temp2 * sat->sgps.cosio * sat->sgps.sinio * cos2u;
-	rdotk = rdot - xn * temp1 * sat->sgps.x1mth2 * sin2u;
-	rfdotk = rfdot + xn * temp1 * (sat->sgps.x1mth2 * cos2u + 1.5 * sat->sgps.x3thm1);
+	rk = r * (1.0 - 1.5 * temp2 * betal * sat->sgps->x3thm1) +
+		0.5 * temp1 * sat->sgps->x1mth2 * cos2u;
+	uk = u - 0.25 * temp2 * sat->sgps->x7thm1 * sin2u;
+	xnodek = xnode + 1.5 * temp2 * sat->sgps->cosio * sin2u;
+	xinck = sat->tle.xincl + 1.5 * temp2 * sat->sgps->cosio * sat->sgps->sinio * cos2u;
+	rdotk = rdot - xn * temp1 * sat->sgps->x1mth2 * sin2u;
+	rfdotk = rfdot + xn * temp1 * (sat->sgps->x1mth2 * cos2u + 1.5 * sat->sgps->x3thm1);
 
 
 	/* Orientation vectors */
@@ -311,14 +311,14 @@ SDP4 (sat_t *sat, double tsince)
 		a1 = pow (xke / sat->tle.xno, tothrd);
 		sat->deep_arg.cosio = cos (sat->tle.xincl);
 		sat->deep_arg.theta2 = sat->deep_arg.cosio * sat->deep_arg.cosio;
-		sat->sgps.x3thm1 = 3.0 * sat->deep_arg.theta2 - 1.0;
+		sat->sgps->x3thm1 = 3.0 * sat->deep_arg.theta2 - 1.0;
 		sat->deep_arg.eosq = sat->tle.eo * sat->tle.eo;
 		sat->deep_arg.betao2 = 1.0 - sat->deep_arg.eosq;
 		sat->deep_arg.betao = sqrt (sat->deep_arg.betao2);
-		del1 = 1.5 * ck2 * sat->sgps.x3thm1 /
+		del1 = 1.5 * ck2 * sat->sgps->x3thm1 /
 			(a1 * a1 * sat->deep_arg.betao * sat->deep_arg.betao2);
 		ao = a1 * (1.0 - del1 * (0.5 * tothrd + del1 * (1.0 + 134.0 / 81.0 * del1)));
-		delo = 1.5 * ck2 * sat->sgps.x3thm1 /
+		delo = 1.5 * ck2 * sat->sgps->x3thm1 /
 			(ao * ao * sat->deep_arg.betao * sat->deep_arg.betao2);
 		sat->deep_arg.xnodp = sat->tle.xno / (1.0 + delo);
 		sat->deep_arg.aodp = ao / (1.0 - delo);
@@ -350,20 +350,20 @@ SDP4 (sat_t *sat, double tsince)
 		c2 = coef1 * sat->deep_arg.xnodp * (sat->deep_arg.aodp *
 						    (1.0 + 1.5 * etasq + eeta *
 						     (4.0 + etasq)) + 0.75 * ck2 * tsi / psisq * 
-						    sat->sgps.x3thm1 * (8.0 + 3.0 * etasq *
+						    sat->sgps->x3thm1 * (8.0 + 3.0 * etasq *
 									(8.0 + etasq)));
-		sat->sgps.c1 = sat->tle.bstar * c2;
+		sat->sgps->c1 = sat->tle.bstar * c2;
 		sat->deep_arg.sinio = sin (sat->tle.xincl);
 		a3ovk2 = -xj3 / ck2 * pow (ae, 3);
-		sat->sgps.x1mth2 = 1.0 - sat->deep_arg.theta2;
-		sat->sgps.c4 = 2.0 * sat->deep_arg.xnodp * coef1 *
+		sat->sgps->x1mth2 = 1.0 - sat->deep_arg.theta2;
+		sat->sgps->c4 = 2.0 * sat->deep_arg.xnodp * coef1 *
 			sat->deep_arg.aodp * sat->deep_arg.betao2 *
 			(eta * (2.0 + 0.5 * etasq) + sat->tle.eo *
 			 (0.5 + 2.0 * etasq) - 2.0 * ck2 * tsi /
-			 (sat->deep_arg.aodp * psisq) * (-3.0 * sat->sgps.x3thm1 *
+			 (sat->deep_arg.aodp * psisq) * (-3.0 * sat->sgps->x3thm1 *
 							 (1.0 - 2.0 * eeta + etasq *
 							  (1.5 - 0.5 * eeta)) +
-							 0.75 * sat->sgps.x1mth2 * 
+							 0.75 * sat->sgps->x1mth2 * 
 							 (2.0 * etasq - eeta * (1.0 + etasq)) *
 							 cos (2.0 * sat->tle.omegao)));
 		theta4 = sat->deep_arg.theta2 * sat->deep_arg.theta2;
@@ -371,7 +371,7 @@ SDP4 (sat_t *sat, double tsince)
 		temp2 = temp1 * ck2 * pinvsq;
 		temp3 = 1.25 * ck4 * pinvsq * pinvsq * sat->deep_arg.xnodp;
 		sat->deep_arg.xmdot = sat->deep_arg.xnodp + 0.5 * temp1 * sat->deep_arg.betao *
-			sat->sgps.x3thm1 + 0.0625 * temp2 * sat->deep_arg.betao *
+			sat->sgps->x3thm1 + 0.0625 * temp2 * sat->deep_arg.betao *
 			(13.0 - 78.0 * sat->deep_arg.theta2 + 137.0 * theta4);
 		x1m5th = 1.0 - 5.0 * sat->deep_arg.theta2;
 		sat->deep_arg.omgdot = -0.5 * temp1 * x1m5th + 0.0625 * temp2 *
@@ -381,12 +381,12 @@ SDP4 (sat_t *sat, double tsince)
 		sat->deep_arg.xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * sat->deep_arg.theta2) +
 						 2.0 * temp3 * (3.0 - 7.0 * sat->deep_arg.theta2)) *
 			sat->deep_arg.cosio;
-		sat->sgps.xnodcf = 3.5 * sat->deep_arg.betao2 * xhdot1 * sat->sgps.c1;
-		sat->sgps.t2cof = 1.5 * sat->sgps.c1;
-		sat->sgps.xlcof = 0.125 * a3ovk2 * sat->deep_arg.sinio *
+		sat->sgps->xnodcf = 3.5 * sat->deep_arg.betao2 * xhdot1 * sat->sgps->c1;
+		sat->sgps->t2cof = 1.5 * sat->sgps->c1;
+		sat->sgps->xlcof = 0.125 * a3ovk2 * sat->deep_arg.sinio *
 			(3.0 + 5.0 * sat->deep_arg.cosio) / (1.0 + sat->deep_arg.cosio);
-		sat->sgps.aycof = 0.25 * a3ovk2 * sat->deep_arg.sinio;
-		sat->sgps.x7thm1 = 7.0 * sat->deep_arg.theta2 - 1.0;
+		sat->sgps->aycof = 0.25 * a3ovk2 * sat->deep_arg.sinio;
+		sat->sgps->x7thm1 = 7.0 * sat->deep_arg.theta2 - 1.0;
 
 		/* initialize Deep() */
 		Deep (dpinit, sat);
@@ -397,10 +397,10 @@ SDP4 (sat_t *sat, double tsince)
 	sat->deep_arg.omgadf = sat->tle.omegao + sat->deep_arg.omgdot * tsince;
 	xnoddf = sat->tle.xnodeo + sat->deep_arg.xnodot * tsince;
 	tsq = tsince * tsince;
-	sat->deep_arg.xnode = xnoddf + sat->sgps.xnodcf * tsq;
-	tempa = 1.0 - sat->sgps.c1 * tsince;
-	tempe = sat->tle.bstar * sat->sgps.c4 * tsince;
-	templ = sat->sgps.t2cof * tsq;
+	sat->deep_arg.xnode = xnoddf + sat->sgps->xnodcf * tsq;
+	tempa = 1.0 - sat->sgps->c1 * tsince;
+	tempe = sat->tle.bstar * sat->sgps->c4 * tsince;
+	templ = sat->sgps->t2cof * tsq;
 	sat->deep_arg.xn = sat->deep_arg.xnodp;
 
 	/* Update for deep-space secular effects */
@@ -427,8 +427,8 @@ SDP4 (sat_t *sat, double tsince)
 	/* Long period periodics */
 	axn = sat->deep_arg.em * cos (sat->deep_arg.omgadf);
 	temp = 1.0 / (a * beta * beta);
-	xll = temp * sat->sgps.xlcof * axn;
-	aynl = temp * sat->sgps.aycof;
+	xll = temp * sat->sgps->xlcof * axn;
+	aynl = temp * sat->sgps->aycof;
 	xlt = xl + xll;
 	ayn = sat->deep_arg.em * sin (sat->deep_arg.omgadf) + aynl;
 
@@ -474,15 +474,15 @@ SDP4 (sat_t *sat, double tsince)
 	temp2 = temp1 * temp;
 
 	/* Update for short periodics */
-	rk = r * (1.0 - 1.5 * temp2 * betal * sat->sgps.x3thm1) +
-	     0.5 * temp1 * sat->sgps.x1mth2 * cos2u;
-	uk = u - 0.25 * temp2 * sat->sgps.x7thm1 * sin2u;
+	rk = r * (1.0 - 1.5 * temp2 * betal * sat->sgps->x3thm1) +
+	     0.5 * temp1 * sat->sgps->x1mth2 * cos2u;
+	uk = u - 0.25 * temp2 * sat->sgps->x7thm1 * sin2u;
 	xnodek = sat->deep_arg.xnode + 1.5 * temp2 * sat->deep_arg.cosio * sin2u;
 	xinck = sat->deep_arg.xinc + 1.5 * temp2 *
 	     sat->deep_arg.cosio * sat->deep_arg.sinio * cos2u;
-	rdotk = rdot - sat->deep_arg.xn * temp1 * sat->sgps.x1mth2 * sin2u;
+	rdotk = rdot - sat->deep_arg.xn * temp1 * sat->sgps->x1mth2 * sin2u;
 	rfdotk = rfdot + sat->deep_arg.xn * temp1 *
-	     (sat->sgps.x1mth2 * cos2u + 1.5 * sat->sgps.x3thm1);
+	     (sat->sgps->x1mth2 * cos2u + 1.5 * sat->sgps->x3thm1);
 
 	/* Orientation vectors */
 	sinuk = sin (uk);
@@ -521,6 +521,113 @@ SDP4 (sat_t *sat, double tsince)
 
 /*------------------------------------------------------------------*/
 
+/* Propagate_Series */
+/* This function propagates one satellite over an array of num  */
+/* tsince values (minutes since epoch). The near-earth/deep-    */
+/* space selection is made once for the whole series and the    */
+/* ECI position and velocity for each step are written to the   */
+/* caller provided pos and vel arrays, which must hold num      */
+/* elements each. Unlike SGP4() and SDP4() the returned vectors */
+/* are already converted to km and km/s and have their          */
+/* magnitude set. sat->pos and sat->vel hold the last step.     */
+void
+Propagate_Series (sat_t *sat, const double *tsince, int num,
+				  vector_t *pos, vector_t *vel)
+{
+	void (*propagate) (sat_t *, double);
+	int i;
+
+	if (sat->flags & DEEP_SPACE_EPHEM_FLAG)
+		propagate = SDP4;
+	else
+		propagate = SGP4;
+
+	for (i = 0; i < num; i++) {
+		propagate (sat, tsince[i]);
+		Convert_Sat_State (&sat->pos, &sat->vel);
+		Magnitude (&sat->pos);
+		Magnitude (&sat->vel);
+		pos[i] = sat->pos;
+		vel[i] = sat->vel;
+	}
+} /* Propagate_Series */
+
+/*------------------------------------------------------------------*/
+
+/* Deep_Restore */
+/* Chooses where the resonance integrator starts for time t.   */
+/* The integrator only ever steps away from epoch, so it has to */
+/* restart if t is closer to epoch than the current state or on */
+/* the other side of it. It then resumes from the nearest      */
+/* checkpoint between epoch and t, or from epoch if there is    */
+/* none. A checkpoint is also used to skip ahead when t lies    */
+/* beyond it. Since every checkpoint was reached by stepping    */
+/* from epoch the result does not depend on the path taken.     */
+static void
+Deep_Restore(sat_t *sat, double t)
+{
+	deep_state_t *st = &sat->deep_state;
+	deep_checkpoint_t *best = NULL;
+	int restart, i;
+
+	restart = (st->atime == 0) ||
+		((t >= 0) && (st->atime < 0)) ||
+		((t < 0) && (st->atime > 0)) ||
+		(fabs(t) < fabs(st->atime));
+
+	/* no checkpoint can be closer to t than the current state */
+	if (!restart &&
+	    (fabs(t - st->atime) < DEEP_CHECKPOINT_STEPS * sat->dps->stepp))
+		return;
+
+	for (i = 0; i < DEEP_CHECKPOINTS; i++) {
+		deep_checkpoint_t *c = &st->ckpt[i];
+
+		if ((c->atime == 0) || ((c->atime > 0) != (t >= 0)) ||
+		    (fabs(c->atime) > fabs(t)))
+			continue;
+
+		if (!restart && (fabs(c->atime) <= fabs(st->atime)))
+			continue;
+
+		if ((best == NULL) || (fabs(c->atime) > fabs(best->atime)))
+			best = c;
+	}
+
+	if (best != NULL) {
+		st->xli = best->xli;
+		st->xni = best->xni;
+		st->atime = best->atime;
+	}
+	else if (restart)
+		st->atime = 0;
+} /* Deep_Restore */
+
+/*------------------------------------------------------------------*/
+
+/* Deep_Checkpoint */
+/* Stores the resonance integrator state every                 */
+/* DEEP_CHECKPOINT_STEPS steps. Slots are indexed by the       */
+/* checkpoint number, so a slot is only overwritten by a       */
+/* checkpoint that is DEEP_CHECKPOINTS intervals away.         */
+static void
+Deep_Checkpoint(sat_t *sat)
+{
+	deep_state_t *st = &sat->deep_state;
+	long n = lround (fabs (st->atime) / sat->dps->stepp);
+	deep_checkpoint_t *c;
+
+	if ((n == 0) || (n % DEEP_CHECKPOINT_STEPS))
+		return;
+
+	c = &st->ckpt[(n / DEEP_CHECKPOINT_STEPS) % DEEP_CHECKPOINTS];
+	c->xli = st->xli;
+	c->xni = st->xni;
+	c->atime = st->atime;
+} /* Deep_Checkpoint */
+
+/*------------------------------------------------------------------*/
+
 /* DEEP */
 /* This function is used by SDP4 to add lunar and solar */
 /* perturbation effects to deep-space orbit objects.    */
@@ -542,46 +649,50 @@ Deep (int ientry, sat_t *sat)
 		z2,z21,z22,z23,z3,z31,z32,z33,ze,zf,zm,zn,
 		zsing,zsinh,zsini,zcosg,zcosh,zcosi,delt=0,ft=0;
 
+	/* integrator loop control; kept local so that Deep() */
+	/* only changes the state of the satellite it is given */
+	int do_loop = 0, epoch_restart = 0;
+
 	switch (ientry) {
 	case dpinit : /* Entrance for deep space initialization */
-		sat->dps.thgr = ThetaG (sat->tle.epoch, &sat->deep_arg);
+		sat->dps->thgr = ThetaG (sat->tle.epoch, &sat->deep_arg);
 		eq = sat->tle.eo;
-		sat->dps.xnq = sat->deep_arg.xnodp;
+		sat->dps->xnq = sat->deep_arg.xnodp;
 		aqnv = 1.0 / sat->deep_arg.aodp;
-		sat->dps.xqncl = sat->tle.xincl;
+		sat->dps->xqncl = sat->tle.xincl;
 		xmao = sat->tle.xmo;
 		xpidot = sat->deep_arg.omgdot + sat->deep_arg.xnodot;
 		sinq = sin (sat->tle.xnodeo);
 		cosq = cos (sat->tle.xnodeo);
-		sat->dps.omegaq = sat->tle.omegao;
-		sat->dps.preep = 0;
+		sat->dps->omegaq = sat->tle.omegao;
+		sat->dps->preep = 0;
 
 		/* Initialize lunar solar terms */
 		day = sat->deep_arg.ds50 + 18261.5;  /*Days since 1900 Jan 0.5*/
-		if (day != sat->dps.preep) {
-			sat->dps.preep = day;
+		if (day != sat->dps->preep) {
+			sat->dps->preep = day;
 			xnodce = 4.5236020 - 9.2422029E-4 * day;
 			stem = sin (xnodce);
 			ctem = cos (xnodce);
-			sat->dps.zcosil = 0.91375164 - 0.03568096 * ctem;
-			sat->dps.zsinil = sqrt (1.0 - sat->dps.zcosil * sat->dps.zcosil);
-			sat->dps.zsinhl = 0.089683511 * stem / sat->dps.zsinil;
-			sat->dps.zcoshl = sqrt (1.0 - sat->dps.zsinhl * sat->dps.zsinhl);
+			sat->dps->zcosil = 0.91375164 - 0.03568096 * ctem;
+			sat->dps->zsinil = sqrt (1.0 - sat->dps->zcosil * sat->dps->zcosil);
+			sat->dps->zsinhl = 0.089683511 * stem / sat->dps->zsinil;
+			sat->dps->zcoshl = sqrt (1.0 - sat->dps->zsinhl * sat->dps->zsinhl);
 			c = 4.7199672 + 0.22997150 * day;
 			gam = 5.8351514 + 0.0019443680 * day;
-			sat->dps.zmol = FMod2p (c - gam);
-			zx = 0.39785416 * stem / sat->dps.zsinil;
-			zy = sat->dps.zcoshl * ctem + 0.91744867 * sat->dps.zsinhl * stem;
+			sat->dps->zmol = FMod2p (c - gam);
+			zx = 0.39785416 * stem / sat->dps->zsinil;
+			zy = sat->dps->zcoshl * ctem + 0.91744867 * sat->dps->zsinhl * stem;
 			zx = AcTan (zx,zy);
 			zx = gam + zx - xnodce;
-			sat->dps.zcosgl = cos (zx);
-			sat->dps.zsingl = sin (zx);
-			sat->dps.zmos = 6.2565837 + 0.017201977 * day;
-			sat->dps.zmos = FMod2p (sat->dps.zmos);
+			sat->dps->zcosgl = cos (zx);
+			sat->dps->zsingl = sin (zx);
+			sat->dps->zmos = 6.2565837 + 0.017201977 * day;
+			sat->dps->zmos = FMod2p (sat->dps->zmos);
 		} /* End if(day != preep) */
 
 		/* Do solar terms */
-		sat->dps.savtsn = 1E20;
+		sat->deep_state.savtsn = 1E20;
 		zcosg = zcosgs;
 		zsing = zsings;
 		zcosi = zcosis;
@@ -591,7 +702,7 @@ Deep (int ientry, sat_t *sat)
 		cc = c1ss;
 		zn = zns;
 		ze = zes;
-		xnoi = 1.0 / sat->dps.xnq;
+		xnoi = 1.0 / sat->dps->xnq;
 
 		/* Loop breaks when Solar terms are done a second */
 		/* time, after Lunar terms are initialized        */
@@ -644,66 +755,66 @@ Deep (int ientry, sat_t *sat)
 			sl = -zn*s3*(z1+z3-14-6*sat->deep_arg.eosq);
 			sgh = s4*zn*(z31+z33-6);
 			sh = -zn*s2*(z21+z23);
-			if (sat->dps.xqncl < 5.2359877E-2)
+			if (sat->dps->xqncl < 5.2359877E-2)
 				sh = 0;
-			sat->dps.ee2 = 2*s1*s6;
-			sat->dps.e3 = 2*s1*s7;
-			sat->dps.xi2 = 2*s2*z12;
-			sat->dps.xi3 = 2*s2*(z13-z11);
-			sat->dps.xl2 = -2*s3*z2;
-			sat->dps.xl3 = -2*s3*(z3-z1);
-			sat->dps.xl4 = -2*s3*(-21-9*sat->deep_arg.eosq)*ze;
-			sat->dps.xgh2 = 2*s4*z32;
-			sat->dps.xgh3 = 2*s4*(z33-z31);
-			sat->dps.xgh4 = -18*s4*ze;
-			sat->dps.xh2 = -2*s2*z22;
-			sat->dps.xh3 = -2*s2*(z23-z21);
+			sat->dps->ee2 = 2*s1*s6;
+			sat->dps->e3 = 2*s1*s7;
+			sat->dps->xi2 = 2*s2*z12;
+			sat->dps->xi3 = 2*s2*(z13-z11);
+			sat->dps->xl2 = -2*s3*z2;
+			sat->dps->xl3 = -2*s3*(z3-z1);
+			sat->dps->xl4 = -2*s3*(-21-9*sat->deep_arg.eosq)*ze;
+			sat->dps->xgh2 = 2*s4*z32;
+			sat->dps->xgh3 = 2*s4*(z33-z31);
+			sat->dps->xgh4 = -18*s4*ze;
+			sat->dps->xh2 = -2*s2*z22;
+			sat->dps->xh3 = -2*s2*(z23-z21);
 
 			if (sat->flags & LUNAR_TERMS_DONE_FLAG)
 				break;
 
 			/* Do lunar terms */
-			sat->dps.sse = se;
-			sat->dps.ssi = si;
-			sat->dps.ssl = sl;
-			sat->dps.ssh = sh/sat->deep_arg.sinio;
-			sat->dps.ssg = sgh-sat->deep_arg.cosio*sat->dps.ssh;
-			sat->dps.se2 = sat->dps.ee2;
-			sat->dps.si2 = sat->dps.xi2;
-			sat->dps.sl2 = sat->dps.xl2;
-			sat->dps.sgh2 = sat->dps.xgh2;
-			sat->dps.sh2 = sat->dps.xh2;
-			sat->dps.se3 = sat->dps.e3;
-			sat->dps.si3 = sat->dps.xi3;
-			sat->dps.sl3 = sat->dps.xl3;
-			sat->dps.sgh3 = sat->dps.xgh3;
-			sat->dps.sh3 = sat->dps.xh3;
-			sat->dps.sl4 = sat->dps.xl4;
-			sat->dps.sgh4 = sat->dps.xgh4;
-			zcosg = sat->dps.zcosgl;
-			zsing = sat->dps.zsingl;
-			zcosi = sat->dps.zcosil;
-			zsini = sat->dps.zsinil;
-			zcosh = sat->dps.zcoshl*cosq+sat->dps.zsinhl*sinq;
-			zsinh = sinq*sat->dps.zcoshl-cosq*sat->dps.zsinhl;
+			sat->dps->sse = se;
+			sat->dps->ssi = si;
+			sat->dps->ssl = sl;
+			sat->dps->ssh = sh/sat->deep_arg.sinio;
+			sat->dps->ssg = sgh-sat->deep_arg.cosio*sat->dps->ssh;
+			sat->dps->se2 = sat->dps->ee2;
+			sat->dps->si2 = sat->dps->xi2;
+			sat->dps->sl2 = sat->dps->xl2;
+			sat->dps->sgh2 = sat->dps->xgh2;
+			sat->dps->sh2 = sat->dps->xh2;
+			sat->dps->se3 = sat->dps->e3;
+			sat->dps->si3 = sat->dps->xi3;
+			sat->dps->sl3 = sat->dps->xl3;
+			sat->dps->sgh3 = sat->dps->xgh3;
+			sat->dps->sh3 = sat->dps->xh3;
+			sat->dps->sl4 = sat->dps->xl4;
+			sat->dps->sgh4 = sat->dps->xgh4;
+			zcosg = sat->dps->zcosgl;
+			zsing = sat->dps->zsingl;
+			zcosi = sat->dps->zcosil;
+			zsini = sat->dps->zsinil;
+			zcosh = sat->dps->zcoshl*cosq+sat->dps->zsinhl*sinq;
+			zsinh = sinq*sat->dps->zcoshl-cosq*sat->dps->zsinhl;
 			zn = znl;
 			cc = c1l;
 			ze = zel;
 			sat->flags |= LUNAR_TERMS_DONE_FLAG;
 		} /* End of for(;;) */
 
-		sat->dps.sse = sat->dps.sse+se;
-		sat->dps.ssi = sat->dps.ssi+si;
-		sat->dps.ssl = sat->dps.ssl+sl;
-		sat->dps.ssg = sat->dps.ssg+sgh-sat->deep_arg.cosio/sat->deep_arg.sinio*sh;
-		sat->dps.ssh = sat->dps.ssh+sh/sat->deep_arg.sinio;
+		sat->dps->sse = sat->dps->sse+se;
+		sat->dps->ssi = sat->dps->ssi+si;
+		sat->dps->ssl = sat->dps->ssl+sl;
+		sat->dps->ssg = sat->dps->ssg+sgh-sat->deep_arg.cosio/sat->deep_arg.sinio*sh;
+		sat->dps->ssh = sat->dps->ssh+sh/sat->deep_arg.sinio;
 
 		/* Geopotential resonance initialization for 12 hour orbits */
 		sat->flags &= ~RESONANCE_FLAG;
 		sat->flags &= ~SYNCHRONOUS_FLAG;
 
-		if( !((sat->dps.xnq < 0.0052359877) && (sat->dps.xnq > 0.0034906585)) ) {
-			if( (sat->dps.xnq < 0.00826) || (sat->dps.xnq > 0.00924) )
+		if( !((sat->dps->xnq < 0.0052359877) && (sat->dps->xnq > 0.0034906585)) ) {
+			if( (sat->dps->xnq < 0.00826) || (sat->dps->xnq > 0.00924) )
 				return;
 			if (eq < 0.5)
 				return;
@@ -779,32 +890,32 @@ Deep (int ientry, sat_t *sat)
 			f543 = 29.53125*sat->deep_arg.sinio*(-2-8*sat->deep_arg.cosio+
 							 sat->deep_arg.theta2*(12+8*sat->deep_arg.cosio-10*
 									   sat->deep_arg.theta2));
-			xno2 = sat->dps.xnq*sat->dps.xnq;
+			xno2 = sat->dps->xnq*sat->dps->xnq;
 			ainv2 = aqnv*aqnv;
 			temp1 = 3*xno2*ainv2;
 			temp = temp1*root22;
-			sat->dps.d2201 = temp*f220*g201;
-			sat->dps.d2211 = temp*f221*g211;
+			sat->dps->d2201 = temp*f220*g201;
+			sat->dps->d2211 = temp*f221*g211;
 			temp1 = temp1*aqnv;
 			temp = temp1*root32;
-			sat->dps.d3210 = temp*f321*g310;
-			sat->dps.d3222 = temp*f322*g322;
+			sat->dps->d3210 = temp*f321*g310;
+			sat->dps->d3222 = temp*f322*g322;
 			temp1 = temp1*aqnv;
 			temp = 2*temp1*root44;
-			sat->dps.d4410 = temp*f441*g410;
-			sat->dps.d4422 = temp*f442*g422;
+			sat->dps->d4410 = temp*f441*g410;
+			sat->dps->d4422 = temp*f442*g422;
 			temp1 = temp1*aqnv;
 			temp = temp1*root52;
-			sat->dps.d5220 = temp*f522*g520;
-			sat->dps.d5232 = temp*f523*g532;
+			sat->dps->d5220 = temp*f522*g520;
+			sat->dps->d5232 = temp*f523*g532;
 			temp = 2*temp1*root54;
-			sat->dps.d5421 = temp*f542*g521;
-			sat->dps.d5433 = temp*f543*g533;
-			sat->dps.xlamo = xmao+sat->tle.xnodeo+sat->tle.xnodeo-sat->dps.thgr-sat->dps.thgr;
+			sat->dps->d5421 = temp*f542*g521;
+			sat->dps->d5433 = temp*f543*g533;
+			sat->dps->xlamo = xmao+sat->tle.xnodeo+sat->tle.xnodeo-sat->dps->thgr-sat->dps->thgr;
 			bfact = sat->deep_arg.xmdot+sat->deep_arg.xnodot+
 				sat->deep_arg.xnodot-thdt-thdt;
-			bfact = bfact+sat->dps.ssl+sat->dps.ssh+sat->dps.ssh;
-		} /* if( !(sat->dps.xnq < 0.0052359877) && (sat->dps.xnq > 0.0034906585) ) */
+			bfact = bfact+sat->dps->ssl+sat->dps->ssh+sat->dps->ssh;
+		} /* if( !(sat->dps->xnq < 0.0052359877) && (sat->dps->xnq > 0.0034906585) ) */
 		else {
 			sat->flags |= RESONANCE_FLAG;
 			sat->flags |= SYNCHRONOUS_FLAG;
@@ -817,36 +928,37 @@ Deep (int ientry, sat_t *sat)
 				(1+3*sat->deep_arg.cosio)-0.75*(1+sat->deep_arg.cosio);
 			f330 = 1+sat->deep_arg.cosio;
 			f330 = 1.875*f330*f330*f330;
-			sat->dps.del1 = 3*sat->dps.xnq*sat->dps.xnq*aqnv*aqnv;
-			sat->dps.del2 = 2*sat->dps.del1*f220*g200*q22;
-			sat->dps.del3 = 3*sat->dps.del1*f330*g300*q33*aqnv;
-			sat->dps.del1 = sat->dps.del1*f311*g310*q31*aqnv;
-			sat->dps.fasx2 = 0.13130908;
-			sat->dps.fasx4 = 2.8843198;
-			sat->dps.fasx6 = 0.37448087;
-			sat->dps.xlamo = xmao+sat->tle.xnodeo+sat->tle.omegao-sat->dps.thgr;
+			sat->dps->del1 = 3*sat->dps->xnq*sat->dps->xnq*aqnv*aqnv;
+			sat->dps->del2 = 2*sat->dps->del1*f220*g200*q22;
+			sat->dps->del3 = 3*sat->dps->del1*f330*g300*q33*aqnv;
+			sat->dps->del1 = sat->dps->del1*f311*g310*q31*aqnv;
+			sat->dps->fasx2 = 0.13130908;
+			sat->dps->fasx4 = 2.8843198;
+			sat->dps->fasx6 = 0.37448087;
+			sat->dps->xlamo = xmao+sat->tle.xnodeo+sat->tle.omegao-sat->dps->thgr;
 			bfact = sat->deep_arg.xmdot+xpidot-thdt;
-			bfact = bfact+sat->dps.ssl+sat->dps.ssg+sat->dps.ssh;
+			bfact = bfact+sat->dps->ssl+sat->dps->ssg+sat->dps->ssh;
 		} /* End if( !(xnq < 0.0052359877) && (xnq > 0.0034906585) ) */
 
-		sat->dps.xfact = bfact-sat->dps.xnq;
+		sat->dps->xfact = bfact-sat->dps->xnq;
 
 		/* Initialize integrator */
-		sat->dps.xli = sat->dps.xlamo;
-		sat->dps.xni = sat->dps.xnq;
-		sat->dps.atime = 0;
-		sat->dps.stepp = 720;
-		sat->dps.stepn = -720;
-		sat->dps.step2 = 259200;
+		sat->deep_state.xli = sat->dps->xlamo;
+		sat->deep_state.xni = sat->dps->xnq;
+		sat->deep_state.atime = 0;
+		memset (sat->deep_state.ckpt, 0, sizeof (sat->deep_state.ckpt));
+		sat->dps->stepp = 720;
+		sat->dps->stepn = -720;
+		sat->dps->step2 = 259200;
 		/* End case dpinit: */
 		return;
 
 	case dpsec: /* Entrance for deep space secular effects */
-		sat->deep_arg.xll = sat->deep_arg.xll+sat->dps.ssl*sat->deep_arg.t;
-		sat->deep_arg.omgadf = sat->deep_arg.omgadf+sat->dps.ssg*sat->deep_arg.t;
-		sat->deep_arg.xnode = sat->deep_arg.xnode+sat->dps.ssh*sat->deep_arg.t;
-		sat->deep_arg.em = sat->tle.eo+sat->dps.sse*sat->deep_arg.t;
-		sat->deep_arg.xinc = sat->tle.xincl+sat->dps.ssi*sat->deep_arg.t;
+		sat->deep_arg.xll = sat->deep_arg.xll+sat->dps->ssl*sat->deep_arg.t;
+		sat->deep_arg.omgadf = sat->deep_arg.omgadf+sat->dps->ssg*sat->deep_arg.t;
+		sat->deep_arg.xnode = sat->deep_arg.xnode+sat->dps->ssh*sat->deep_arg.t;
+		sat->deep_arg.em = sat->tle.eo+sat->dps->sse*sat->deep_arg.t;
+		sat->deep_arg.xinc = sat->tle.xincl+sat->dps->ssi*sat->deep_arg.t;
 		if (sat->deep_arg.xinc < 0) {
 			sat->deep_arg.xinc = -sat->deep_arg.xinc;
 			sat->deep_arg.xnode = sat->deep_arg.xnode + pi;
@@ -854,97 +966,100 @@ Deep (int ientry, sat_t *sat)
 		}
 		if( ~sat->flags & RESONANCE_FLAG ) return;
 
+		Deep_Restore (sat, sat->deep_arg.t);
+
 		do {
-			if( (sat->dps.atime == 0) ||
-			    ((sat->deep_arg.t >= 0) && (sat->dps.atime < 0)) || 
-			    ((sat->deep_arg.t < 0) && (sat->dps.atime >= 0)) ) {
+			if( (sat->deep_state.atime == 0) ||
+			    ((sat->deep_arg.t >= 0) && (sat->deep_state.atime < 0)) || 
+			    ((sat->deep_arg.t < 0) && (sat->deep_state.atime >= 0)) ) {
 				/* Epoch restart */
 				if( sat->deep_arg.t >= 0 )
-					delt = sat->dps.stepp;
+					delt = sat->dps->stepp;
 				else
-					delt = sat->dps.stepn;
+					delt = sat->dps->stepn;
 
-				sat->dps.atime = 0;
-				sat->dps.xni = sat->dps.xnq;
-				sat->dps.xli = sat->dps.xlamo;
+				sat->deep_state.atime = 0;
+				sat->deep_state.xni = sat->dps->xnq;
+				sat->deep_state.xli = sat->dps->xlamo;
 			}
 			else {	  
-				if( fabs(sat->deep_arg.t) >= fabs(sat->dps.atime) ) {
+				if( fabs(sat->deep_arg.t) >= fabs(sat->deep_state.atime) ) {
 					if ( sat->deep_arg.t > 0 )
-						delt = sat->dps.stepp;
+						delt = sat->dps->stepp;
 					else
-						delt = sat->dps.stepn;
+						delt = sat->dps->stepn;
 				}
 			}
 
 			do {
-				if ( fabs(sat->deep_arg.t-sat->dps.atime) >= sat->dps.stepp ) {
-					sat->flags |= DO_LOOP_FLAG;
-					sat->flags &= ~EPOCH_RESTART_FLAG;
+				if ( fabs(sat->deep_arg.t-sat->deep_state.atime) >= sat->dps->stepp ) {
+					do_loop = 1;
+					epoch_restart = 0;
 				}
 				else {
-					ft = sat->deep_arg.t-sat->dps.atime;
-					sat->flags &= ~DO_LOOP_FLAG;
+					ft = sat->deep_arg.t-sat->deep_state.atime;
+					do_loop = 0;
 				}
 
-				if( fabs(sat->deep_arg.t) < fabs(sat->dps.atime) ) {
+				if( fabs(sat->deep_arg.t) < fabs(sat->deep_state.atime) ) {
 					if (sat->deep_arg.t >= 0)
-						delt = sat->dps.stepn;
+						delt = sat->dps->stepn;
 					else
-						delt = sat->dps.stepp;
-					sat->flags |= (DO_LOOP_FLAG | EPOCH_RESTART_FLAG);
+						delt = sat->dps->stepp;
+					do_loop = 1;
+					epoch_restart = 1;
 				}
 
 				/* Dot terms calculated */
 				if (sat->flags & SYNCHRONOUS_FLAG) {
-					xndot = sat->dps.del1*sin(sat->dps.xli-sat->dps.fasx2)+sat->dps.del2*sin(2*(sat->dps.xli-sat->dps.fasx4))
-						+sat->dps.del3*sin(3*(sat->dps.xli-sat->dps.fasx6));
-					xnddt = sat->dps.del1*cos(sat->dps.xli-sat->dps.fasx2)+2*sat->dps.del2*cos(2*(sat->dps.xli-sat->dps.fasx4))
-						+3*sat->dps.del3*cos(3*(sat->dps.xli-sat->dps.fasx6));
+					xndot = sat->dps->del1*sin(sat->deep_state.xli-sat->dps->fasx2)+sat->dps->del2*sin(2*(sat->deep_state.xli-sat->dps->fasx4))
+						+sat->dps->del3*sin(3*(sat->deep_state.xli-sat->dps->fasx6));
+					xnddt = sat->dps->del1*cos(sat->deep_state.xli-sat->dps->fasx2)+2*sat->dps->del2*cos(2*(sat->deep_state.xli-sat->dps->fasx4))
+						+3*sat->dps->del3*cos(3*(sat->deep_state.xli-sat->dps->fasx6));
 				}
 				else {
-					xomi = sat->dps.omegaq+sat->deep_arg.omgdot*sat->dps.atime;
+					xomi = sat->dps->omegaq+sat->deep_arg.omgdot*sat->deep_state.atime;
 					x2omi = xomi+xomi;
-					x2li = sat->dps.xli+sat->dps.xli;
-					xndot = sat->dps.d2201*sin(x2omi+sat->dps.xli-g22)
-						+sat->dps.d2211*sin(sat->dps.xli-g22)
-						+sat->dps.d3210*sin(xomi+sat->dps.xli-g32)
-						+sat->dps.d3222*sin(-xomi+sat->dps.xli-g32)
-						+sat->dps.d4410*sin(x2omi+x2li-g44)
-						+sat->dps.d4422*sin(x2li-g44)
-						+sat->dps.d5220*sin(xomi+sat->dps.xli-g52)
-						+sat->dps.d5232*sin(-xomi+sat->dps.xli-g52)
-						+sat->dps.d5421*sin(xomi+x2li-g54)
-						+sat->dps.d5433*sin(-xomi+x2li-g54);
-					xnddt = sat->dps.d2201*cos(x2omi+sat->dps.xli-g22)
-						+sat->dps.d2211*cos(sat->dps.xli-g22)
-						+sat->dps.d3210*cos(xomi+sat->dps.xli-g32)
-						+sat->dps.d3222*cos(-xomi+sat->dps.xli-g32)
-						+sat->dps.d5220*cos(xomi+sat->dps.xli-g52)
-						+sat->dps.d5232*cos(-xomi+sat->dps.xli-g52)
-						+2*(sat->dps.d4410*cos(x2omi+x2li-g44)
-						    +sat->dps.d4422*cos(x2li-g44)
-						    +sat->dps.d5421*cos(xomi+x2li-g54)
-						    +sat->dps.d5433*cos(-xomi+x2li-g54));
+					x2li = sat->deep_state.xli+sat->deep_state.xli;
+					xndot = sat->dps->d2201*sin(x2omi+sat->deep_state.xli-g22)
+						+sat->dps->d2211*sin(sat->deep_state.xli-g22)
+						+sat->dps->d3210*sin(xomi+sat->deep_state.xli-g32)
+						+sat->dps->d3222*sin(-xomi+sat->deep_state.xli-g32)
+						+sat->dps->d4410*sin(x2omi+x2li-g44)
+						+sat->dps->d4422*sin(x2li-g44)
+						+sat->dps->d5220*sin(xomi+sat->deep_state.xli-g52)
+						+sat->dps->d5232*sin(-xomi+sat->deep_state.xli-g52)
+						+sat->dps->d5421*sin(xomi+x2li-g54)
+						+sat->dps->d5433*sin(-xomi+x2li-g54);
+					xnddt = sat->dps->d2201*cos(x2omi+sat->deep_state.xli-g22)
+						+sat->dps->d2211*cos(sat->deep_state.xli-g22)
+						+sat->dps->d3210*cos(xomi+sat->deep_state.xli-g32)
+						+sat->dps->d3222*cos(-xomi+sat->deep_state.xli-g32)
+						+sat->dps->d5220*cos(xomi+sat->deep_state.xli-g52)
+						+sat->dps->d5232*cos(-xomi+sat->deep_state.xli-g52)
+						+2*(sat->dps->d4410*cos(x2omi+x2li-g44)
+						    +sat->dps->d4422*cos(x2li-g44)
+						    +sat->dps->d5421*cos(xomi+x2li-g54)
+						    +sat->dps->d5433*cos(-xomi+x2li-g54));
 				} /* End of if (isFlagSet(SYNCHRONOUS_FLAG)) */
 
-				xldot = sat->dps.xni+sat->dps.xfact;
+				xldot = sat->deep_state.xni+sat->dps->xfact;
 				xnddt = xnddt*xldot;
 
-				if(sat->flags & DO_LOOP_FLAG) {
-					sat->dps.xli = sat->dps.xli+xldot*delt+xndot*sat->dps.step2;
-					sat->dps.xni = sat->dps.xni+xndot*delt+xnddt*sat->dps.step2;
-					sat->dps.atime = sat->dps.atime+delt;
+				if (do_loop) {
+					sat->deep_state.xli = sat->deep_state.xli+xldot*delt+xndot*sat->dps->step2;
+					sat->deep_state.xni = sat->deep_state.xni+xndot*delt+xnddt*sat->dps->step2;
+					sat->deep_state.atime = sat->deep_state.atime+delt;
+					Deep_Checkpoint (sat);
 				}
 			}
-			while ( (sat->flags & DO_LOOP_FLAG) &&
-				(~sat->flags & EPOCH_RESTART_FLAG));
+			while (do_loop && !epoch_restart);
 		}
-		while ((sat->flags & DO_LOOP_FLAG) && (sat->flags & EPOCH_RESTART_FLAG));
+		while (do_loop && epoch_restart);
 
-		sat->deep_arg.xn = sat->dps.xni+xndot*ft+xnddt*ft*ft*0.5;
-		xl = sat->dps.xli+xldot*ft+xndot*ft*ft*0.5;
-		temp = -sat->deep_arg.xnode+sat->dps.thgr+sat->deep_arg.t*thdt;
+		sat->deep_arg.xn = sat->deep_state.xni+xndot*ft+xnddt*ft*ft*0.5;
+		xl = sat->deep_state.xli+xldot*ft+xndot*ft*ft*0.5;
+		temp = -sat->deep_arg.xnode+sat->dps->thgr+sat->deep_arg.t*thdt;
 
 		if (~sat->flags & SYNCHRONOUS_FLAG)
 			sat->deep_arg.xll = xl+temp+temp;
@@ -957,45 +1072,45 @@ Deep (int ientry, sat_t *sat)
 	case dpper: /* Entrance for lunar-solar periodics */
 		sinis = sin(sat->deep_arg.xinc);
 		cosis = cos(sat->deep_arg.xinc);
-		if (fabs(sat->dps.savtsn-sat->deep_arg.t) >= 30) {
-			sat->dps.savtsn = sat->deep_arg.t;
-			zm = sat->dps.zmos+zns*sat->deep_arg.t;
+		if (fabs(sat->deep_state.savtsn-sat->deep_arg.t) >= 30) {
+			sat->deep_state.savtsn = sat->deep_arg.t;
+			zm = sat->dps->zmos+zns*sat->deep_arg.t;
 			zf = zm+2*zes*sin(zm);
 			sinzf = sin(zf);
 			f2 = 0.5*sinzf*sinzf-0.25;
 			f3 = -0.5*sinzf*cos(zf);
-			ses = sat->dps.se2*f2+sat->dps.se3*f3;
-			sis = sat->dps.si2*f2+sat->dps.si3*f3;
-			sls = sat->dps.sl2*f2+sat->dps.sl3*f3+sat->dps.sl4*sinzf;
-			sat->dps.sghs = sat->dps.sgh2*f2+sat->dps.sgh3*f3+sat->dps.sgh4*sinzf;
-			sat->dps.shs = sat->dps.sh2*f2+sat->dps.sh3*f3;
-			zm = sat->dps.zmol+znl*sat->deep_arg.t;
+			ses = sat->dps->se2*f2+sat->dps->se3*f3;
+			sis = sat->dps->si2*f2+sat->dps->si3*f3;
+			sls = sat->dps->sl2*f2+sat->dps->sl3*f3+sat->dps->sl4*sinzf;
+			sat->deep_state.sghs = sat->dps->sgh2*f2+sat->dps->sgh3*f3+sat->dps->sgh4*sinzf;
+			sat->deep_state.shs = sat->dps->sh2*f2+sat->dps->sh3*f3;
+			zm = sat->dps->zmol+znl*sat->deep_arg.t;
 			zf = zm+2*zel*sin(zm);
 			sinzf = sin(zf);
 			f2 = 0.5*sinzf*sinzf-0.25;
 			f3 = -0.5*sinzf*cos(zf);
-			sel = sat->dps.ee2*f2+sat->dps.e3*f3;
-			sil = sat->dps.xi2*f2+sat->dps.xi3*f3;
-			sll = sat->dps.xl2*f2+sat->dps.xl3*f3+sat->dps.xl4*sinzf;
-			sat->dps.sghl = sat->dps.xgh2*f2+sat->dps.xgh3*f3+sat->dps.xgh4*sinzf;
-			sat->dps.sh1 = sat->dps.xh2*f2+sat->dps.xh3*f3;
-			sat->dps.pe = ses+sel;
-			sat->dps.pinc = sis+sil;
-			sat->dps.pl = sls+sll;
+			sel = sat->dps->ee2*f2+sat->dps->e3*f3;
+			sil = sat->dps->xi2*f2+sat->dps->xi3*f3;
+			sll = sat->dps->xl2*f2+sat->dps->xl3*f3+sat->dps->xl4*sinzf;
+			sat->deep_state.sghl = sat->dps->xgh2*f2+sat->dps->xgh3*f3+sat->dps->xgh4*sinzf;
+			sat->deep_state.sh1 = sat->dps->xh2*f2+sat->dps->xh3*f3;
+			sat->deep_state.pe = ses+sel;
+			sat->deep_state.pinc = sis+sil;
+			sat->deep_state.pl = sls+sll;
 		}
 
-		pgh = sat->dps.sghs+sat->dps.sghl;
-		ph = sat->dps.shs+sat->dps.sh1;
-		sat->deep_arg.xinc = sat->deep_arg.xinc+sat->dps.pinc;
-		sat->deep_arg.em = sat->deep_arg.em+sat->dps.pe;
+		pgh = sat->deep_state.sghs+sat->deep_state.sghl;
+		ph = sat->deep_state.shs+sat->deep_state.sh1;
+		sat->deep_arg.xinc = sat->deep_arg.xinc+sat->deep_state.pinc;
+		sat->deep_arg.em = sat->deep_arg.em+sat->deep_state.pe;
 
-		if (sat->dps.xqncl >= 0.2) {
+		if (sat->dps->xqncl >= 0.2) {
 			/* Apply periodics directly */
 			ph = ph/sat->deep_arg.sinio;
 			pgh = pgh-sat->deep_arg.cosio*ph;
 			sat->deep_arg.omgadf = sat->deep_arg.omgadf+pgh;
 			sat->deep_arg.xnode = sat->deep_arg.xnode+ph;
-			sat->deep_arg.xll = sat->deep_arg.xll+sat->dps.pl;
+			sat->deep_arg.xll = sat->deep_arg.xll+sat->deep_state.pl;
 		}
 		else {
 			/* Apply periodics with Lyddane modification */
@@ -1003,13 +1118,13 @@ Deep (int ientry, sat_t *sat)
 			cosok = cos(sat->deep_arg.xnode);
 			alfdp = sinis*sinok;
 			betdp = sinis*cosok;
-			dalf = ph*cosok+sat->dps.pinc*cosis*sinok;
-			dbet = -ph*sinok+sat->dps.pinc*cosis*cosok;
+			dalf = ph*cosok+sat->deep_state.pinc*cosis*sinok;
+			dbet = -ph*sinok+sat->deep_state.pinc*cosis*cosok;
 			alfdp = alfdp+dalf;
 			betdp = betdp+dbet;
 			sat->deep_arg.xnode = FMod2p(sat->deep_arg.xnode);
 			xls = sat->deep_arg.xll+sat->deep_arg.omgadf+cosis*sat->deep_arg.xnode;
-			dls = sat->dps.pl+pgh-sat->dps.pinc*sat->deep_arg.xnode*sinis;
+			dls = sat->deep_state.pl+pgh-sat->deep_state.pinc*sat->deep_arg.xnode*sinis;
 			xls = xls+dls;
 			xnoh = sat->deep_arg.xnode;
 			sat->deep_arg.xnode = AcTan(alfdp,betdp);
@@ -1023,7 +1138,7 @@ Deep (int ientry, sat_t *sat)
 					sat->deep_arg.xnode -=twopi;
 			}
 
-			sat->deep_arg.xll = sat->deep_arg.xll+sat->dps.pl;
+			sat->deep_arg.xll = sat->deep_arg.xll+sat->deep_state.pl;
 			sat->deep_arg.omgadf = xls-sat->deep_arg.xll-cos(sat->deep_arg.xinc)*
 				sat->deep_arg.xnode;
 		} /* End case dpper: */
@@ -1034,34 +1149,3 @@ Deep (int ientry, sat_t *sat)
 } /* End of Deep() */
 
 /*------------------------------------------------------------------*/
-
-/* Functions for testing and setting/clearing flags */
-
-/* An int variable holding the single-bit flags */
-static int Flags = 0;
-
-int
-isFlagSet(int flag)
-{
-  return (Flags & flag);
-}
-
-int
-isFlagClear(int flag)
-{
-  return (~Flags & flag);
-}
-
-void
-SetFlag(int flag)
-{
-  Flags |= flag;
-}
-
-void
-ClearFlag(int flag)
-{
-  Flags &= ~flag;
-}
-
-/*------------------------------------------------------------------*/
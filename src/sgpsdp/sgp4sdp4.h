@@ -116,6 +116,25 @@ typedef struct {
 	double dec;  /*!< Declination [dec] */
 } obs_astro_t;
 
+/** \brief Observer frame at a given time.
+ *  \ingroup sgpsdpif
+ *
+ * Everything about the observer that Calculate_Obs() and
+ * Calculate_LatLonAlt() derive from the time and the observer location
+ * alone. Computing it once with Calculate_Obs_Frame() allows many
+ * satellites to be processed for the same time and location without
+ * repeating the sidereal time and observer position calculations.
+ */
+typedef struct {
+	double     jul_utc;    /*!< Time of the frame [Julian Date] */
+	double     gmst;       /*!< Greenwich mean sidereal time [rad] */
+	geodetic_t geodetic;   /*!< Observer; theta is the local sidereal time */
+	vector_t   obs_pos;    /*!< ECI position of the observer [km] */
+	vector_t   obs_vel;    /*!< ECI velocity of the observer [km/s] */
+	double     sin_lat, cos_lat;
+	double     sin_theta, cos_theta;
+} obs_frame_t;
+
 
 /* Common arguments between deep-space functions */
 typedef struct {
@@ -139,19 +158,45 @@ typedef struct {
 
 /* static data for DEEP */
 typedef struct {
-	double thgr,xnq,xqncl,omegaq,zmol,zmos,savtsn,ee2,e3,xi2;
+	double thgr,xnq,xqncl,omegaq,zmol,zmos,ee2,e3,xi2;
 	double xl2,xl3,xl4,xgh2,xgh3,xgh4,xh2,xh3,sse,ssi,ssg,xi3;
 	double se2,si2,sl2,sgh2,sh2,se3,si3,sl3,sgh3,sh3,sl4,sgh4;
 	double ssl,ssh,d3210,d3222,d4410,d4422,d5220,d5232,d5421;
 	double d5433,del1,del2,del3,fasx2,fasx4,fasx6,xlamo,xfact;
-	double xni,atime,stepp,stepn,step2,preep,pl,sghs,xli;
-	double d2201,d2211,sghl,sh1,pinc,pe,shs,zsingl,zcosgl;
+	double stepp,stepn,step2,preep;
+	double d2201,d2211,zsingl,zcosgl;
 	double zsinhl,zcoshl,zsinil,zcosil;
 } deep_static_t;
 
+/* number of resonance integrator checkpoints kept per satellite */
+/* and the number of integrator steps between two checkpoints     */
+#define DEEP_CHECKPOINTS       16
+#define DEEP_CHECKPOINT_STEPS  10
+
+/* resonance integrator state; atime == 0 marks an unused checkpoint */
+typedef struct {
+	double xli,xni,atime;
+} deep_checkpoint_t;
+
+/* data for DEEP that changes during propagation */
+typedef struct {
+	double xli,xni,atime;          /* resonance integrator */
+	double savtsn,sghs,shs,sghl;   /* lunar-solar periodics */
+	double sh1,pe,pinc,pl;
+	deep_checkpoint_t ckpt[DEEP_CHECKPOINTS];
+} deep_state_t;
+
 /** \brief Satellite data structure
  *  \ingroup sgpsdpif
  *
+ * The propagation constants in sgps and dps are allocated by
+ * select_ephemeris(), filled in by the first call to SGP4() or SDP4()
+ * and read-only afterwards. A plain structure copy of a sat_t therefore
+ * shares them with the original, while everything that changes during
+ * propagation is copied. This makes it cheap to create working copies
+ * for predictions; such copies must not outlive the original and must
+ * not be passed to free_ephemeris(). clone_ephemeris() makes an
+ * independent copy instead, e.g. for use in another thread.
  */
 typedef struct {
         char           *name;
@@ -159,17 +204,13 @@ typedef struct {
         char           *website;
 	tle_t           tle;     /*!< Keplerian elements */
 	int             flags;   /*!< Flags for algo ctrl */
-	sgpsdp_static_t sgps;
-	deep_static_t   dps;
+	sgpsdp_static_t *sgps;   /*!< Shared SGP4/SDP4 constants */
+	deep_static_t   *dps;    /*!< Shared DEEP constants, NULL if near-earth */
+	deep_state_t    deep_state;
 	deep_arg_t      deep_arg;
 	vector_t        pos;       /*!< Raw position and range */
 	vector_t        vel;       /*!< Raw velocity */
 
-	/*** FIXME: REMOVE */
-	obs_set_t       bearing;   /*!< Az, El, range and vel */
-	obs_astro_t     astro;     /*!< Ra and Decl */
-	/*** END */
-
 	/* time keeping fields */
 	double          jul_epoch;
 	double          jul_utc;
@@ -200,6 +241,46 @@ typedef struct {
 #define SAT(sat)  ((sat_t *) sat)
 
 
+/** \brief Number of satellites propagated together by SGP4_Multi(). */
+#define SGP4_MULTI_LANES 8
+
+/** \brief Structure-of-arrays block of near-earth satellites.
+ *  \ingroup sgpsdpif
+ *
+ * Holds a lane-wise copy of the tle_t and sgpsdp_static_t fields needed
+ * by the SGP4 propagation step, so that SGP4_Multi() can propagate
+ * SGP4_MULTI_LANES satellites in tight loops over contiguous arrays
+ * without touching the rest of sat_t. Fill it with SGP4_Multi_Init()
+ * and SGP4_Multi_Add().
+ */
+typedef struct {
+	int     num;                       /*!< Number of lanes in use */
+	sat_t  *sat[SGP4_MULTI_LANES];     /*!< Satellite of each lane */
+	int     simple[SGP4_MULTI_LANES];  /*!< SIMPLE_FLAG of each lane */
+
+	/* tle_t */
+	double  xmo[SGP4_MULTI_LANES], omegao[SGP4_MULTI_LANES];
+	double  xnodeo[SGP4_MULTI_LANES], eo[SGP4_MULTI_LANES];
+	double  xincl[SGP4_MULTI_LANES], bstar[SGP4_MULTI_LANES];
+
+	/* sgpsdp_static_t */
+	double  aodp[SGP4_MULTI_LANES], aycof[SGP4_MULTI_LANES];
+	double  c1[SGP4_MULTI_LANES], c4[SGP4_MULTI_LANES];
+	double  c5[SGP4_MULTI_LANES], cosio[SGP4_MULTI_LANES];
+	double  d2[SGP4_MULTI_LANES], d3[SGP4_MULTI_LANES];
+	double  d4[SGP4_MULTI_LANES], delmo[SGP4_MULTI_LANES];
+	double  omgcof[SGP4_MULTI_LANES], eta[SGP4_MULTI_LANES];
+	double  omgdot[SGP4_MULTI_LANES], sinio[SGP4_MULTI_LANES];
+	double  xnodp[SGP4_MULTI_LANES], sinmo[SGP4_MULTI_LANES];
+	double  t2cof[SGP4_MULTI_LANES], t3cof[SGP4_MULTI_LANES];
+	double  t4cof[SGP4_MULTI_LANES], t5cof[SGP4_MULTI_LANES];
+	double  x1mth2[SGP4_MULTI_LANES], x3thm1[SGP4_MULTI_LANES];
+	double  x7thm1[SGP4_MULTI_LANES], xmcof[SGP4_MULTI_LANES];
+	double  xmdot[SGP4_MULTI_LANES], xnodcf[SGP4_MULTI_LANES];
+	double  xnodot[SGP4_MULTI_LANES], xlcof[SGP4_MULTI_LANES];
+} sgp4_multi_t;
+
+
 /** Table of constant values **/
 #define de2ra    1.74532925E-2   /* Degrees to Radians */
 #define pi       3.1415926535898 /* Pi */
@@ -265,7 +346,9 @@ FIXME: Change to enu */
 #define CR  0x0A
 #define LF  0x0D
 
-/* Flow control flag definitions */
+/* Flow control flag definitions. These are kept per satellite in   */
+/* sat_t.flags; the library has no global state, so different      */
+/* satellites may be propagated concurrently from separate threads. */
 #define ALL_FLAGS              -1
 #define SGP_INITIALIZED_FLAG   0x000001
 #define SGP4_INITIALIZED_FLAG  0x000002
@@ -290,11 +373,14 @@ FIXME: Change to enu */
 /* sgp4sdp4.c */
 void    SGP4 (sat_t *sat, double tsince);
 void    SDP4 (sat_t *sat, double tsince);
+void    Propagate_Series (sat_t *sat, const double *tsince, int num,
+                          vector_t *pos, vector_t *vel);
 void    Deep (int ientry, sat_t *sat);
-int     isFlagSet(int flag);
-int     isFlagClear(int flag);
-void    SetFlag(int flag);
-void    ClearFlag(int flag);
+
+/* sgp4_multi.c */
+void    SGP4_Multi_Init (sgp4_multi_t *m);
+int     SGP4_Multi_Add (sgp4_multi_t *m, sat_t *sat);
+void    SGP4_Multi (sgp4_multi_t *m, const double *tsince);
 
 /* sgp_in.c */
 int     Checksum_Good(char *tle_set);
@@ -302,6 +388,8 @@ int     Good_Elements(char *tle_set);
 void    Convert_Satellite_Data(char *tle_set, tle_t *tle);
 int     Get_Next_Tle_Set( char lines[3][80], tle_t *tle );
 void    select_ephemeris(sat_t *sat);
+void    free_ephemeris(sat_t *sat);
+void    clone_ephemeris(sat_t *copy, const sat_t *sat);
 
 /* sgp_math.c */
 int     Sign(double arg);
@@ -336,6 +424,15 @@ void    Calculate_Obs(double _time, vector_t *pos, vector_t *vel,
                       geodetic_t *geodetic, obs_set_t *obs_set);
 void    Calculate_RADec_and_Obs(double _time, vector_t *pos, vector_t *vel,
 				geodetic_t *geodetic, obs_astro_t *obs_set);
+void    Calculate_Obs_Frame(double _time, geodetic_t *geodetic,
+                            obs_frame_t *frame);
+void    Calculate_Frame_Obs(const obs_frame_t *frame, vector_t *pos,
+                            vector_t *vel, obs_set_t *obs_set);
+void    Calculate_Frame_LatLonAlt(const obs_frame_t *frame, vector_t *pos,
+                                  geodetic_t *geodetic);
+void    Calculate_Frame_Topo(const obs_frame_t *frame, vector_t *pos,
+                             vector_t *vel, obs_set_t *obs_set,
+                             geodetic_t *geodetic);
 
 /* sgp_time.c */
 double  Julian_Date_of_Epoch(double epoch);
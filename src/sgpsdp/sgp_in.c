@@ -389,8 +389,57 @@ select_ephemeris (sat_t *sat)
 	else
 		sat->flags &= ~DEEP_SPACE_EPHEM_FLAG;
 
+	/* Storage for the propagation constants; these */
+	/* are filled in by the first SGP4/SDP4 call.   */
+	sat->sgps = calloc (1, sizeof (sgpsdp_static_t));
+	if (sat->flags & DEEP_SPACE_EPHEM_FLAG)
+		sat->dps = calloc (1, sizeof (deep_static_t));
+	else
+		sat->dps = NULL;
+
+	if ((sat->sgps == NULL) || ((sat->flags & DEEP_SPACE_EPHEM_FLAG) && (sat->dps == NULL)))
+		abort ();
+
 	return;
 } /* End of select_ephemeris() */
 
 /*------------------------------------------------------------------*/
 
+/* Frees the propagation constants allocated by select_ephemeris(). */
+void
+free_ephemeris (sat_t *sat)
+{
+	free (sat->sgps);
+	free (sat->dps);
+	sat->sgps = NULL;
+	sat->dps = NULL;
+	sat->flags &= ~(SGP4_INITIALIZED_FLAG | SDP4_INITIALIZED_FLAG);
+} /* End of free_ephemeris() */
+
+/*------------------------------------------------------------------*/
+
+/* Copies sat to copy, giving the copy its own propagation */
+/* constants. Unlike a plain structure copy, the result    */
+/* does not depend on sat and can be propagated in another */
+/* thread; it must be freed with free_ephemeris().         */
+void
+clone_ephemeris (sat_t *copy, const sat_t *sat)
+{
+	*copy = *sat;
+
+	copy->sgps = malloc (sizeof (sgpsdp_static_t));
+	if (copy->sgps == NULL)
+		abort ();
+	memcpy (copy->sgps, sat->sgps, sizeof (sgpsdp_static_t));
+
+	if (sat->dps != NULL)
+	{
+		copy->dps = malloc (sizeof (deep_static_t));
+		if (copy->dps == NULL)
+			abort ();
+		memcpy (copy->dps, sat->dps, sizeof (deep_static_t));
+	}
+} /* End of clone_ephemeris() */
+
+/*------------------------------------------------------------------*/
+
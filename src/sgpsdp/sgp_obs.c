@@ -12,6 +12,46 @@
 
 #include "sgp4sdp4.h"
 
+/* Procedure Calculate_Obs_Frame computes everything about the       */
+/* observer at {geodetic} and {time} that does not depend on the      */
+/* object being observed: the sidereal time, the ECI position and     */
+/* velocity of the observer and the rotation to topocentric axes.     */
+/* The velocity calculation assumes the geodetic position is          */
+/* stationary relative to the earth's surface.                        */
+void
+Calculate_Obs_Frame(double _time,
+                    geodetic_t *geodetic,
+                    obs_frame_t *frame)
+{
+/* Reference:  The 1992 Astronomical Almanac, page K11. */
+
+	double c,sq,achcp;
+
+	frame->jul_utc = _time;
+	frame->gmst = ThetaG_JD(_time);
+	frame->geodetic = *geodetic;
+	frame->geodetic.theta = FMod2p(frame->gmst + geodetic->lon);/*LMST*/
+
+	c = 1/sqrt(1 + __f*(__f - 2)*Sqr(sin(geodetic->lat)));
+	sq = Sqr(1 - __f)*c;
+	achcp = (xkmper*c + geodetic->alt)*cos(geodetic->lat);
+	frame->obs_pos.x = achcp*cos(frame->geodetic.theta);/*kilometers*/
+	frame->obs_pos.y = achcp*sin(frame->geodetic.theta);
+	frame->obs_pos.z = (xkmper*sq + geodetic->alt)*sin(geodetic->lat);
+	frame->obs_vel.x = -mfactor*frame->obs_pos.y;/*kilometers/second*/
+	frame->obs_vel.y =  mfactor*frame->obs_pos.x;
+	frame->obs_vel.z =  0;
+	Magnitude(&frame->obs_pos);
+	Magnitude(&frame->obs_vel);
+
+	frame->sin_lat = sin(geodetic->lat);
+	frame->cos_lat = cos(geodetic->lat);
+	frame->sin_theta = sin(frame->geodetic.theta);
+	frame->cos_theta = cos(frame->geodetic.theta);
+} /*Procedure Calculate_Obs_Frame*/
+
+/*------------------------------------------------------------------*/
+
 /* Procedure Calculate_User_PosVel passes the user's geodetic position */
 /* and the time of interest and returns the ECI position and velocity  */
 /* of the observer. The velocity calculation assumes the geodetic      */
@@ -22,60 +62,77 @@ Calculate_User_PosVel(double _time,
                       vector_t *obs_pos,
                       vector_t *obs_vel)
 {
-/* Reference:  The 1992 Astronomical Almanac, page K11. */
+	obs_frame_t frame;
 
-	double c,sq,achcp;
-
-	geodetic->theta = FMod2p(ThetaG_JD(_time) + geodetic->lon);/*LMST*/
-	c = 1/sqrt(1 + __f*(__f - 2)*Sqr(sin(geodetic->lat)));
-	sq = Sqr(1 - __f)*c;
-	achcp = (xkmper*c + geodetic->alt)*cos(geodetic->lat);
-	obs_pos->x = achcp*cos(geodetic->theta);/*kilometers*/
-	obs_pos->y = achcp*sin(geodetic->theta);
-	obs_pos->z = (xkmper*sq + geodetic->alt)*sin(geodetic->lat);
-	obs_vel->x = -mfactor*obs_pos->y;/*kilometers/second*/
-	obs_vel->y =  mfactor*obs_pos->x;
-	obs_vel->z =  0;
-	Magnitude(obs_pos);
-	Magnitude(obs_vel);
+	Calculate_Obs_Frame(_time, geodetic, &frame);
+	geodetic->theta = frame.geodetic.theta;
+	*obs_pos = frame.obs_pos;
+	*obs_vel = frame.obs_vel;
 } /*Procedure Calculate_User_PosVel*/
 
 /*------------------------------------------------------------------*/
 
-/* Procedure Calculate_LatLonAlt will calculate the geodetic  */
-/* position of an object given its ECI position pos and time. */
-/* It is intended to be used to determine the ground track of */
-/* a satellite.  The calculations  assume the earth to be an  */
-/* oblate spheroid as defined in WGS '72.                     */
-void
-Calculate_LatLonAlt(double _time, vector_t *pos,  geodetic_t *geodetic)
+/* Calculates the geodetic position for a given ECI position and */
+/* Greenwich mean sidereal time; see Calculate_LatLonAlt.         */
+/* The latitude is obtained in closed form with Bowring's method, */
+/* which agrees with the iterative solution of the 1992           */
+/* Astronomical Almanac (page K12) to well below a metre from the */
+/* surface out to beyond the moon.                                */
+static void
+LatLonAlt(double gmst, vector_t *pos, geodetic_t *geodetic)
 {
-	/* Reference:  The 1992 Astronomical Almanac, page K12. */
+	/* Reference:  B. R. Bowring, Survey Review 23 (1976), p. 323. */
 
-	double r,e2,phi,c;
+	double r,e2,ep2,b,u,su,cu,sl,cl;
 
 	geodetic->theta = AcTan(pos->y,pos->x);/*radians*/
-	geodetic->lon = FMod2p(geodetic->theta - ThetaG_JD(_time));/*radians*/
+	geodetic->lon = FMod2p(geodetic->theta - gmst);/*radians*/
 	r = sqrt(Sqr(pos->x) + Sqr(pos->y));
 	e2 = __f*(2 - __f);
-	geodetic->lat = AcTan(pos->z,r);/*radians*/
+	ep2 = e2/Sqr(1 - __f);
+	b = xkmper*(1 - __f);
+
+	/* parametric latitude of the point projected on the ellipsoid */
+	u = atan2(pos->z, r*(1 - __f));
+	su = sin(u);
+	cu = cos(u);
 
-	do
-	{
-		phi = geodetic->lat;
-		c = 1/sqrt(1 - e2*Sqr(sin(phi)));
-		geodetic->lat = AcTan(pos->z + xkmper*c*e2*sin(phi),r);
-	}
-	while(fabs(geodetic->lat - phi) >= 1E-10);
+	geodetic->lat = atan2(pos->z + ep2*b*su*su*su,
+			      r - e2*xkmper*cu*cu*cu);/*radians*/
 
-	geodetic->alt = r/cos(geodetic->lat) - xkmper*c;/*kilometers*/
+	/* this form of the height is well conditioned at the poles too */
+	sl = sin(geodetic->lat);
+	cl = cos(geodetic->lat);
+	geodetic->alt = r*cl + pos->z*sl
+		- xkmper*sqrt(1 - e2*sl*sl);/*kilometers*/
 
-	if( geodetic->lat > pio2 ) geodetic->lat -= twopi;
-  
+} /*Procedure LatLonAlt*/
+
+/*------------------------------------------------------------------*/
+
+/* Procedure Calculate_LatLonAlt will calculate the geodetic  */
+/* position of an object given its ECI position pos and time. */
+/* It is intended to be used to determine the ground track of */
+/* a satellite.  The calculations  assume the earth to be an  */
+/* oblate spheroid as defined in WGS '72.                     */
+void
+Calculate_LatLonAlt(double _time, vector_t *pos,  geodetic_t *geodetic)
+{
+	LatLonAlt(ThetaG_JD(_time), pos, geodetic);
 } /*Procedure Calculate_LatLonAlt*/
 
 /*------------------------------------------------------------------*/
 
+/* Same as Calculate_LatLonAlt, using the time of {frame}. */
+void
+Calculate_Frame_LatLonAlt(const obs_frame_t *frame, vector_t *pos,
+                          geodetic_t *geodetic)
+{
+	LatLonAlt(frame->gmst, pos, geodetic);
+} /*Procedure Calculate_Frame_LatLonAlt*/
+
+/*------------------------------------------------------------------*/
+
 /* The procedures Calculate_Obs and Calculate_RADec calculate         */
 /* the *topocentric* coordinates of the object with ECI position,     */
 /* {pos}, and velocity, {vel}, from location {geodetic} at {time}.    */
@@ -92,46 +149,40 @@ Calculate_LatLonAlt(double _time, vector_t *pos,  geodetic_t *geodetic)
 /* based on *topocentric* position using the WGS '72 geoid and        */
 /* incorporating atmospheric refraction.                              */
 
+/* Calculate_Frame_Obs does the same as Calculate_Obs for an observer */
+/* frame prepared by Calculate_Obs_Frame.                             */
+
 void
-Calculate_Obs(double _time,
-	      vector_t *pos,
-	      vector_t *vel,
-	      geodetic_t *geodetic,
-	      obs_set_t *obs_set)
+Calculate_Frame_Obs(const obs_frame_t *frame,
+		    vector_t *pos,
+		    vector_t *vel,
+		    obs_set_t *obs_set)
 {
 	double
-		sin_lat,cos_lat,
-		sin_theta,cos_theta,
 		el,azim,
 		top_s,top_e,top_z;
 
 	vector_t
-		obs_pos,obs_vel,range,rgvel;
+		range,rgvel;
 
-	Calculate_User_PosVel(_time, geodetic, &obs_pos, &obs_vel);
+	range.x = pos->x - frame->obs_pos.x;
+	range.y = pos->y - frame->obs_pos.y;
+	range.z = pos->z - frame->obs_pos.z;
 
-	range.x = pos->x - obs_pos.x;
-	range.y = pos->y - obs_pos.y;
-	range.z = pos->z - obs_pos.z;
-
-	rgvel.x = vel->x - obs_vel.x;
-	rgvel.y = vel->y - obs_vel.y;
-	rgvel.z = vel->z - obs_vel.z;
+	rgvel.x = vel->x - frame->obs_vel.x;
+	rgvel.y = vel->y - frame->obs_vel.y;
+	rgvel.z = vel->z - frame->obs_vel.z;
 
 	Magnitude(&range);
 
-	sin_lat = sin(geodetic->lat);
-	cos_lat = cos(geodetic->lat);
-	sin_theta = sin(geodetic->theta);
-	cos_theta = cos(geodetic->theta);
-	top_s = sin_lat * cos_theta * range.x
-		+ sin_lat * sin_theta * range.y
-		- cos_lat * range.z;
-	top_e = -sin_theta * range.x
-		+ cos_theta * range.y;
-	top_z = cos_lat * cos_theta * range.x
-		+ cos_lat * sin_theta * range.y
-		+ sin_lat * range.z;
+	top_s = frame->sin_lat * frame->cos_theta * range.x
+		+ frame->sin_lat * frame->sin_theta * range.y
+		- frame->cos_lat * range.z;
+	top_e = -frame->sin_theta * range.x
+		+ frame->cos_theta * range.y;
+	top_z = frame->cos_lat * frame->cos_theta * range.x
+		+ frame->cos_lat * frame->sin_theta * range.y
+		+ frame->sin_lat * range.z;
 	azim = atan(-top_e/top_s); /*Azimuth*/
 	if( top_s > 0 ) 
 		azim = azim + pi;
@@ -150,13 +201,67 @@ Calculate_Obs(double _time,
 /* Correction is meaningless when apparent elevation is below horizon */
 //	obs_set->el = obs_set->el + Radians((1.02/tan(Radians(Degrees(el)+
 //							      10.3/(Degrees(el)+5.11))))/60);
-	if( obs_set->el >= 0 )
-		SetFlag(VISIBLE_FLAG);
-	else
-	{
+	if( obs_set->el < 0 )
 		obs_set->el = el;  /*Reset to true elevation*/
-		ClearFlag(VISIBLE_FLAG);
-	} /*else*/
+} /*Procedure Calculate_Frame_Obs*/
+
+/*------------------------------------------------------------------*/
+
+/* Procedure Calculate_Frame_Topo is the fused form of Calculate_Frame_Obs */
+/* and Calculate_Frame_LatLonAlt used for every satellite on every update: */
+/* it returns the azimuth, elevation, range and range rate of the object   */
+/* in {obs_set} and its sub-point in {geodetic} in one pass. The results   */
+/* are the same as those of the two separate calls.                        */
+void
+Calculate_Frame_Topo(const obs_frame_t *frame,
+		     vector_t *pos,
+		     vector_t *vel,
+		     obs_set_t *obs_set,
+		     geodetic_t *geodetic)
+{
+	double
+		rx,ry,rz,range,
+		top_s,top_e,top_z;
+
+	rx = pos->x - frame->obs_pos.x;
+	ry = pos->y - frame->obs_pos.y;
+	rz = pos->z - frame->obs_pos.z;
+	range = sqrt(rx*rx + ry*ry + rz*rz);
+
+	top_s = frame->sin_lat * (frame->cos_theta * rx + frame->sin_theta * ry)
+		- frame->cos_lat * rz;
+	top_e = -frame->sin_theta * rx + frame->cos_theta * ry;
+	top_z = frame->cos_lat * (frame->cos_theta * rx + frame->sin_theta * ry)
+		+ frame->sin_lat * rz;
+
+	/* azimuth measured from north through east, in [0;2pi) */
+	obs_set->az = atan2(top_e, -top_s);
+	if( obs_set->az < 0 )
+		obs_set->az += twopi;
+	obs_set->el = asin(fmax(-1.0, fmin(1.0, top_z/range)));
+	obs_set->range = range;
+	obs_set->range_rate = (rx*(vel->x - frame->obs_vel.x)
+			       + ry*(vel->y - frame->obs_vel.y)
+			       + rz*(vel->z - frame->obs_vel.z))/range;
+
+	LatLonAlt(frame->gmst, pos, geodetic);
+} /*Procedure Calculate_Frame_Topo*/
+
+/*------------------------------------------------------------------*/
+
+void
+Calculate_Obs(double _time,
+	      vector_t *pos,
+	      vector_t *vel,
+	      geodetic_t *geodetic,
+	      obs_set_t *obs_set)
+{
+	obs_frame_t frame;
+
+	Calculate_Obs_Frame(_time, geodetic, &frame);
+	geodetic->theta = frame.geodetic.theta;
+
+	Calculate_Frame_Obs(&frame, pos, vel, obs_set);
 } /*Procedure Calculate_Obs*/
 
 /*------------------------------------------------------------------*/
@@ -179,8 +284,6 @@ Calculate_RADec_and_Obs ( double _time,
 
 	Calculate_Obs(_time,pos,vel,geodetic,&obs);
 
-/*  if( isFlagSet(VISIBLE_FLAG) )
-    {*/
 	az = obs.az;
 	el = obs.el;
 	phi   = geodetic->lat;
@@ -210,7 +313,6 @@ Calculate_RADec_and_Obs ( double _time,
 	cos_alpha = Lx / cos_delta;
 	obs_set->ra = AcTan(sin_alpha,cos_alpha); /* Right Ascension (radians)*/
 	obs_set->ra = FMod2p(obs_set->ra);
-	/*}*/  /*if*/
 } /* Procedure Calculate_RADec */
 
 /*------------------------------------------------------------------*/
@@ -0,0 +1,181 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2008  Alexandru Csete.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the
+          Free Software Foundation, Inc.,
+      59 Temple Place, Suite 330,
+      Boston, MA  02111-1307
+      USA
+*/
+/* Unit test for SGP4_Multi: compare each lane with the scalar SGP4 */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sgp4sdp4.h"
+
+#define TEST_ROUNDS 5
+
+/* maximum allowed deviation from the scalar path [km] and [km/s] */
+#define POS_TOL 1.0e-6
+#define VEL_TOL 1.0e-9
+
+
+sat_t           lane[SGP4_MULTI_LANES];
+sat_t           ref[SGP4_MULTI_LANES];
+sat_t           deep;
+
+
+/* read the first TLE set from file into tle */
+static int read_tle(const char *file, tle_t * tle)
+{
+    FILE           *fp;
+    char            tle_str[3][80];
+    int             i;
+
+    fp = fopen(file, "r");
+    if (fp == NULL)
+    {
+        printf("Could not open %s\n", file);
+        return 1;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        if (fgets(tle_str[i], 80, fp) == NULL)
+        {
+            printf("Error reading %s line %d\n", file, i + 1);
+            fclose(fp);
+            return 1;
+        }
+    }
+    fclose(fp);
+
+    if (Get_Next_Tle_Set(tle_str, tle) != 1)
+    {
+        printf("Could not read TLE data from %s\n", file);
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    sgp4_multi_t    m;
+    tle_t           tle;
+    double          tsince[SGP4_MULTI_LANES];
+    double          dpos, dvel;
+    double          maxpos = 0.0, maxvel = 0.0;
+    int             i, l;
+
+    if (read_tle("test-001.tle", &tle))
+        return 1;
+
+    /* half of the lanes use the test-001 elements (perigee below 220 km,
+       i.e. the "simple" equations); the other half use a lower mean
+       motion so that the full drag terms are exercised as well */
+    SGP4_Multi_Init(&m);
+    for (l = 0; l < SGP4_MULTI_LANES; l++)
+    {
+        memset(&lane[l], 0, sizeof(sat_t));
+        lane[l].tle = tle;
+        if (l >= SGP4_MULTI_LANES / 2)
+            lane[l].tle.xno = 14.0 + 0.25 * l;
+
+        select_ephemeris(&lane[l]);
+
+        /* independent constants, so that the reference can not be
+           affected by what the kernel does to those of the lane */
+        clone_ephemeris(&ref[l], &lane[l]);
+
+        if (!SGP4_Multi_Add(&m, &lane[l]))
+        {
+            printf("Could not add lane %d\n", l);
+            return 1;
+        }
+    }
+
+    printf("SIMPLE_FLAG: %d (expected 1)   %d (expected 0)\n\n",
+           m.simple[0], m.simple[SGP4_MULTI_LANES - 1]);
+
+    printf("                      MAX POS DELTA [km]   MAX VEL DELTA [km/s]\n");
+    printf("--------------------------------------------------------------\n");
+
+    for (i = 0; i < TEST_ROUNDS; i++)
+    {
+        for (l = 0; l < SGP4_MULTI_LANES; l++)
+            tsince[l] = 360.0 * i + 45.0 * l;
+
+        SGP4_Multi(&m, tsince);
+
+        dpos = 0.0;
+        dvel = 0.0;
+        for (l = 0; l < SGP4_MULTI_LANES; l++)
+        {
+            SGP4(&ref[l], tsince[l]);
+            Convert_Sat_State(&ref[l].pos, &ref[l].vel);
+            Convert_Sat_State(&lane[l].pos, &lane[l].vel);
+
+            dpos = fmax(dpos, fabs(lane[l].pos.x - ref[l].pos.x));
+            dpos = fmax(dpos, fabs(lane[l].pos.y - ref[l].pos.y));
+            dpos = fmax(dpos, fabs(lane[l].pos.z - ref[l].pos.z));
+            dvel = fmax(dvel, fabs(lane[l].vel.x - ref[l].vel.x));
+            dvel = fmax(dvel, fabs(lane[l].vel.y - ref[l].vel.y));
+            dvel = fmax(dvel, fabs(lane[l].vel.z - ref[l].vel.z));
+        }
+
+        printf("ROUND %d  t: %6.1f    %.3e            %.3e\n",
+               i + 1, tsince[0], dpos, dvel);
+
+        maxpos = fmax(maxpos, dpos);
+        maxvel = fmax(maxvel, dvel);
+    }
+
+    /* deep-space objects must be rejected */
+    if (read_tle("test-002.tle", &deep.tle))
+        return 1;
+
+    select_ephemeris(&deep);
+    SGP4_Multi_Init(&m);
+
+    printf("\nDEEP_SPACE_EPHEM lane accepted: %d (expected 0)\n",
+           SGP4_Multi_Add(&m, &deep));
+
+    for (l = 0; l < SGP4_MULTI_LANES; l++)
+    {
+        free_ephemeris(&ref[l]);
+        free_ephemeris(&lane[l]);
+    }
+    free_ephemeris(&deep);
+
+    if (maxpos > POS_TOL || maxvel > VEL_TOL || m.num != 0)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("PASS\n");
+
+    return 0;
+}
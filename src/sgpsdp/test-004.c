@@ -0,0 +1,180 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2008  Alexandru Csete.
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the
+          Free Software Foundation, Inc.,
+      59 Temple Place, Suite 330,
+      Boston, MA  02111-1307
+      USA
+*/
+/* Unit test for the closed-form Calculate_LatLonAlt and for
+   Calculate_Frame_Topo: compare with the iterative geodetic conversion
+   and with Calculate_Frame_Obs */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sgp4sdp4.h"
+
+/* maximum allowed deviation [m] */
+#define POS_TOL 1.0
+
+/* test time and observer */
+#define TEST_JD  2458000.5
+#define TEST_LAT 55.68
+#define TEST_LON 12.57
+
+
+/* the iterative geodetic conversion formerly used by Calculate_LatLonAlt */
+static void iter_latlonalt(double _time, vector_t * pos, geodetic_t * geodetic)
+{
+    double          r, e2, phi, c;
+
+    geodetic->theta = AcTan(pos->y, pos->x);
+    geodetic->lon = FMod2p(geodetic->theta - ThetaG_JD(_time));
+    r = sqrt(Sqr(pos->x) + Sqr(pos->y));
+    e2 = __f * (2 - __f);
+    geodetic->lat = AcTan(pos->z, r);
+
+    do
+    {
+        phi = geodetic->lat;
+        c = 1 / sqrt(1 - e2 * Sqr(sin(phi)));
+        geodetic->lat = AcTan(pos->z + xkmper * c * e2 * sin(phi), r);
+    }
+    while (fabs(geodetic->lat - phi) >= 1E-10);
+
+    geodetic->alt = r / cos(geodetic->lat) - xkmper * c;
+
+    if (geodetic->lat > pio2)
+        geodetic->lat -= twopi;
+}
+
+/* distance between two geodetic positions [m], good for small differences */
+static double geo_delta(geodetic_t * a, geodetic_t * b)
+{
+    double          dlon = fabs(a->lon - b->lon);
+    double          rad = (xkmper + fmax(a->alt, 0.0)) * 1000.0;
+
+    if (dlon > pi)
+        dlon = twopi - dlon;
+
+    return sqrt(Sqr((a->lat - b->lat) * rad) +
+                Sqr(dlon * cos(a->lat) * rad) +
+                Sqr((a->alt - b->alt) * 1000.0));
+}
+
+int main(void)
+{
+    /* altitudes from the ground to beyond the moon [km] */
+    const double    alt[] = { 0.0, 0.5, 400.0, 1500.0, 20200.0, 35786.0,
+        100000.0, 400000.0
+    };
+    const int       nalt = sizeof(alt) / sizeof(alt[0]);
+    geodetic_t      obs, pt, ref, geo;
+    obs_frame_t     frame, ptframe;
+    obs_set_t       oref, otop;
+    vector_t        vel;
+    double          d, dtruth, diter, dtopo;
+    double          maxtruth = 0.0, maxiter = 0.0, maxtopo = 0.0;
+    int             i, lat, lon;
+
+    obs.lat = Radians(TEST_LAT);
+    obs.lon = Radians(TEST_LON);
+    obs.alt = 0.1;
+    Calculate_Obs_Frame(TEST_JD, &obs, &frame);
+
+    printf("   ALT [km]   MAX DELTA TRUE [m]   MAX DELTA ITER [m]   MAX DELTA TOPO [m]\n");
+    printf("--------------------------------------------------------------------------\n");
+
+    for (i = 0; i < nalt; i++)
+    {
+        dtruth = 0.0;
+        diter = 0.0;
+        dtopo = 0.0;
+
+        for (lat = -90; lat <= 90; lat += 5)
+        {
+            for (lon = -180; lon < 180; lon += 15)
+            {
+                /* ECI position of a known geodetic point */
+                pt.lat = Radians(lat);
+                pt.lon = Radians(lon);
+                pt.alt = alt[i];
+                Calculate_Obs_Frame(TEST_JD, &pt, &ptframe);
+
+                Calculate_LatLonAlt(TEST_JD, &ptframe.obs_pos, &geo);
+                iter_latlonalt(TEST_JD, &ptframe.obs_pos, &ref);
+
+                /* the longitude is undefined at the poles */
+                if (abs(lat) == 90)
+                    geo.lon = ref.lon = pt.lon = FMod2p(pt.lon);
+
+                d = geo_delta(&geo, &pt);
+                dtruth = fmax(dtruth, d);
+
+                /* the altitude of the iterative solution, r/cos(lat),
+                   is tens of metres off at the poles themselves */
+                if (abs(lat) != 90)
+                {
+                    d = geo_delta(&geo, &ref);
+                    diter = fmax(diter, d);
+                }
+
+                /* fused topocentric routine against the separate calls */
+                vel.x = 1.0 + 0.01 * lat;
+                vel.y = -2.0 + 0.01 * lon;
+                vel.z = 3.0;
+                Calculate_Frame_Obs(&frame, &ptframe.obs_pos, &vel, &oref);
+                Calculate_Frame_LatLonAlt(&frame, &ptframe.obs_pos, &ref);
+                Calculate_Frame_Topo(&frame, &ptframe.obs_pos, &vel, &otop,
+                                     &geo);
+
+                d = fabs(otop.range - oref.range) * 1000.0;
+                d = fmax(d, fabs(otop.el - oref.el) * oref.range * 1000.0);
+                d = fmax(d, fabs(otop.az - oref.az) * cos(oref.el) *
+                         oref.range * 1000.0);
+                d = fmax(d, fabs(otop.range_rate - oref.range_rate) * 1000.0);
+                d = fmax(d, geo_delta(&geo, &ref));
+                dtopo = fmax(dtopo, d);
+            }
+        }
+
+        printf("%11.1f   %.3e            %.3e            %.3e\n",
+               alt[i], dtruth, diter, dtopo);
+
+        maxtruth = fmax(maxtruth, dtruth);
+        maxiter = fmax(maxiter, diter);
+        maxtopo = fmax(maxtopo, dtopo);
+    }
+
+    if (maxtruth > POS_TOL || maxiter > POS_TOL || maxtopo > POS_TOL)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+
+    printf("PASS\n");
+
+    return 0;
+}
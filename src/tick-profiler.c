@@ -0,0 +1,293 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+/*
+ * Rolling timing statistics for the phases of a periodic task.
+ *
+ * The task calls tick_prof_begin() when it starts, tick_prof_lap() after
+ * each phase and tick_prof_end() when it is done. Each phase keeps the
+ * last TICK_PROF_WINDOW durations, from which the minimum, average, 99th
+ * percentile and maximum are calculated on request.
+ */
+#ifdef HAVE_CONFIG_H
+#include <build-config.h>
+#endif
+#include <glib.h>
+#include <glib/gi18n.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sat-log.h"
+#include "tick-profiler.h"
+
+
+/** \brief The samples of one phase. */
+typedef struct {
+    gchar          *name;       /*!< Name of the phase, NULL if unused */
+    gdouble         samples[TICK_PROF_WINDOW];  /*!< Durations [msec] */
+    guint           next;       /*!< Where the next sample goes */
+    guint           count;      /*!< Number of samples in the window */
+} tick_phase_t;
+
+struct _tick_prof {
+    GPtrArray      *phases;     /*!< tick_phase_t by phase number */
+    tick_phase_t    total;      /*!< Durations of the complete ticks */
+    gint64          start;      /*!< Monotonic time at tick_prof_begin */
+    gint64          stamp;      /*!< Monotonic time at the last lap */
+    gulong          ticks;      /*!< Number of ticks since the reset */
+};
+
+/** \brief Statistics of one phase [msec]. */
+typedef struct {
+    gdouble         min;
+    gdouble         avg;
+    gdouble         p99;
+    gdouble         max;
+} tick_stats_t;
+
+
+static void free_phase(gpointer data)
+{
+    tick_phase_t   *phase = data;
+
+    if (phase == NULL)
+        return;
+
+    g_free(phase->name);
+    g_free(phase);
+}
+
+/** \brief Get a phase, creating it if necessary. */
+static tick_phase_t *get_phase(tick_prof_t * prof, guint phase)
+{
+    if (phase >= prof->phases->len)
+        g_ptr_array_set_size(prof->phases, phase + 1);
+
+    if (g_ptr_array_index(prof->phases, phase) == NULL)
+        g_ptr_array_index(prof->phases, phase) = g_new0(tick_phase_t, 1);
+
+    return g_ptr_array_index(prof->phases, phase);
+}
+
+static void add_sample(tick_phase_t * phase, gdouble msec)
+{
+    phase->samples[phase->next] = msec;
+    phase->next = (phase->next + 1) % TICK_PROF_WINDOW;
+    if (phase->count < TICK_PROF_WINDOW)
+        phase->count++;
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+    gdouble         x = *(const gdouble *)a;
+    gdouble         y = *(const gdouble *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Calculate the statistics of a phase.
+ * \return FALSE if the phase has no samples.
+ */
+static gboolean get_stats(const tick_phase_t * phase, tick_stats_t * stats)
+{
+    gdouble         sorted[TICK_PROF_WINDOW];
+    gdouble         sum = 0.0;
+    guint           i;
+
+    if (phase->count == 0)
+        return FALSE;
+
+    memcpy(sorted, phase->samples, phase->count * sizeof(gdouble));
+    qsort(sorted, phase->count, sizeof(gdouble), compare_samples);
+
+    for (i = 0; i < phase->count; i++)
+        sum += sorted[i];
+
+    stats->min = sorted[0];
+    stats->avg = sum / phase->count;
+    stats->p99 = sorted[(phase->count * 99 - 1) / 100];
+    stats->max = sorted[phase->count - 1];
+
+    return TRUE;
+}
+
+static void clear_phase(tick_phase_t * phase)
+{
+    phase->next = 0;
+    phase->count = 0;
+}
+
+tick_prof_t    *tick_prof_new(void)
+{
+    tick_prof_t    *prof = g_new0(tick_prof_t, 1);
+
+    prof->phases = g_ptr_array_new_with_free_func(free_phase);
+    prof->total.name = g_strdup(_("Total"));
+
+    return prof;
+}
+
+void tick_prof_free(tick_prof_t * prof)
+{
+    if (prof == NULL)
+        return;
+
+    g_ptr_array_free(prof->phases, TRUE);
+    g_free(prof->total.name);
+    g_free(prof);
+}
+
+/** \brief Drop all samples; the names of the phases are kept. */
+void tick_prof_reset(tick_prof_t * prof)
+{
+    guint           i;
+
+    for (i = 0; i < prof->phases->len; i++)
+        if (g_ptr_array_index(prof->phases, i) != NULL)
+            clear_phase(g_ptr_array_index(prof->phases, i));
+
+    clear_phase(&prof->total);
+    prof->ticks = 0;
+}
+
+/**
+ * \brief Set the name of a phase.
+ * \param prof The profiler.
+ * \param phase The phase number. Phases are reported in this order.
+ * \param name The name of the phase.
+ *
+ * Only named phases are included in the report.
+ */
+void tick_prof_set_name(tick_prof_t * prof, guint phase, const gchar * name)
+{
+    tick_phase_t   *p = get_phase(prof, phase);
+
+    g_free(p->name);
+    p->name = g_strdup(name);
+}
+
+/** \brief Start timing a tick. */
+void tick_prof_begin(tick_prof_t * prof)
+{
+    prof->start = g_get_monotonic_time();
+    prof->stamp = prof->start;
+}
+
+/**
+ * \brief Record the time since the previous lap as the duration of a phase.
+ * \param prof The profiler.
+ * \param phase The phase that has just finished.
+ */
+void tick_prof_lap(tick_prof_t * prof, guint phase)
+{
+    gint64          now = g_get_monotonic_time();
+
+    add_sample(get_phase(prof, phase), (now - prof->stamp) / 1000.0);
+    prof->stamp = now;
+}
+
+/** \brief Record the duration of the complete tick. */
+void tick_prof_end(tick_prof_t * prof)
+{
+    prof->stamp = g_get_monotonic_time();
+    add_sample(&prof->total, (prof->stamp - prof->start) / 1000.0);
+    prof->ticks++;
+}
+
+/** \brief The duration of the last complete tick [msec]. */
+gdouble tick_prof_last(tick_prof_t * prof)
+{
+    if (prof->total.count == 0)
+        return 0.0;
+
+    return prof->total.samples[(prof->total.next + TICK_PROF_WINDOW - 1) %
+                               TICK_PROF_WINDOW];
+}
+
+static void append_line(GString * str, const tick_phase_t * phase)
+{
+    tick_stats_t    stats;
+
+    if (phase->name == NULL || !get_stats(phase, &stats))
+        return;
+
+    g_string_append_printf(str, "%-24s %8.2f %8.2f %8.2f %8.2f\n",
+                           phase->name, stats.min, stats.avg, stats.p99,
+                           stats.max);
+}
+
+/**
+ * \brief Format the statistics of all phases as a table.
+ * \return A newly allocated string which must be freed with g_free.
+ *
+ * The table is meant to be shown in a monospace font.
+ */
+gchar          *tick_prof_report(tick_prof_t * prof)
+{
+    GString        *str = g_string_new(NULL);
+    guint           i;
+
+    g_string_append_printf(str, _("Last %u of %lu cycles [msec]\n\n"),
+                           prof->total.count, prof->ticks);
+    g_string_append_printf(str, "%-24s %8s %8s %8s %8s\n", _("Phase"),
+                           _("Min"), _("Avg"), _("P99"), _("Max"));
+
+    for (i = 0; i < prof->phases->len; i++)
+        if (g_ptr_array_index(prof->phases, i) != NULL)
+            append_line(str, g_ptr_array_index(prof->phases, i));
+
+    append_line(str, &prof->total);
+
+    return g_string_free(str, FALSE);
+}
+
+/**
+ * \brief Write the statistics of all phases to the log.
+ * \param prof The profiler.
+ * \param name Prefix of the log lines, e.g. the module name.
+ */
+void tick_prof_log(tick_prof_t * prof, const gchar * name)
+{
+    tick_phase_t   *phase;
+    tick_stats_t    stats;
+    guint           i;
+
+    for (i = 0; i <= prof->phases->len; i++)
+    {
+        phase = (i < prof->phases->len) ?
+            g_ptr_array_index(prof->phases, i) : &prof->total;
+
+        if (phase == NULL || phase->name == NULL || !get_stats(phase, &stats))
+            continue;
+
+        sat_log_log(SAT_LOG_LEVEL_INFO,
+                    _("%s: %s: min %.2f avg %.2f p99 %.2f max %.2f msec"),
+                    name, phase->name, stats.min, stats.avg, stats.p99,
+                    stats.max);
+    }
+}
@@ -0,0 +1,51 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+    Gpredict: Real-time satellite tracking and orbit prediction program
+
+    Copyright (C)  2001-2017  Alexandru Csete, OZ9AEC.
+
+    Authors: Alexandru Csete <oz9aec@gmail.com>
+
+    Comments, questions and bugreports should be submitted via
+    http://sourceforge.net/projects/gpredict/
+    More details can be found at the project home page:
+
+            http://gpredict.oz9aec.net/
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, visit http://www.fsf.org/
+*/
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H 1
+
+#include <glib.h>
+
+/** \brief Number of samples kept per phase. */
+#define TICK_PROF_WINDOW 256
+
+/** \brief Timing of the phases of a periodic task; opaque. */
+typedef struct _tick_prof tick_prof_t;
+
+tick_prof_t    *tick_prof_new(void);
+void            tick_prof_free(tick_prof_t * prof);
+void            tick_prof_reset(tick_prof_t * prof);
+void            tick_prof_set_name(tick_prof_t * prof, guint phase,
+                                   const gchar * name);
+void            tick_prof_begin(tick_prof_t * prof);
+void            tick_prof_lap(tick_prof_t * prof, guint phase);
+void            tick_prof_end(tick_prof_t * prof);
+gdouble         tick_prof_last(tick_prof_t * prof);
+gchar          *tick_prof_report(tick_prof_t * prof);
+void            tick_prof_log(tick_prof_t * prof, const gchar * name);
+
+#endif